@@ -0,0 +1,77 @@
+#include "../engine/src/DSDXTDecoder.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using DSEngine::DSDXTDecoder;
+
+namespace {
+    using Clock = std::chrono::high_resolution_clock;
+
+    struct BenchSize {
+        uint32_t width;
+        uint32_t height;
+    };
+
+    // Decodes the image repeatedly for at least minSeconds and returns the decoded MB/s
+    double MeasureDecode(bool dxt5, const std::vector<uint8_t>& blocks, uint32_t width, uint32_t height,
+                         std::vector<uint8_t>& output, DSDXTDecoder::Path path) {
+        const double minSeconds = 0.25;
+        uint32_t iterations = 0;
+        double elapsed = 0.0;
+        const Clock::time_point start = Clock::now();
+
+        do {
+            if (dxt5) {
+                DSDXTDecoder::DecodeDXT5(blocks.data(), width, height, output.data(), path);
+            } else {
+                DSDXTDecoder::DecodeDXT1(blocks.data(), width, height, output.data(), path);
+            }
+            iterations++;
+            elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+        } while (elapsed < minSeconds);
+
+        const double bytes = static_cast<double>(output.size()) * iterations;
+        return bytes / (1024.0 * 1024.0) / elapsed;
+    }
+}
+
+int main() {
+    const BenchSize sizes[] = { {256, 256}, {1024, 1024}, {4096, 4096}, {1000, 600} };
+    const DSDXTDecoder::Path paths[] = { DSDXTDecoder::Path::Scalar, DSDXTDecoder::Path::SSE2, DSDXTDecoder::Path::AVX2 };
+
+    std::printf("Best path on this CPU: %s\n", DSDXTDecoder::GetPathName(DSDXTDecoder::GetBestPath()));
+    std::printf("%-6s %-11s %-7s %12s\n", "format", "size", "path", "MB/s");
+
+    std::mt19937 random(1234);
+    for (bool dxt5 : { false, true }) {
+        for (const BenchSize& size : sizes) {
+            const uint32_t blockCount = ((size.width + 3) / 4) * ((size.height + 3) / 4);
+            const uint32_t pixelSize = dxt5 ? 4 : 3;
+
+            // Random bytes are valid DXT data and exercise every palette mode
+            std::vector<uint8_t> blocks(blockCount * (dxt5 ? 16 : 8));
+            for (uint8_t& b : blocks) b = static_cast<uint8_t>(random());
+
+            std::vector<uint8_t> reference(static_cast<size_t>(size.width) * size.height * pixelSize);
+            std::vector<uint8_t> output(reference.size());
+
+            for (DSDXTDecoder::Path path : paths) {
+                std::vector<uint8_t>& target = (path == DSDXTDecoder::Path::Scalar) ? reference : output;
+                const double mbPerSecond = MeasureDecode(dxt5, blocks, size.width, size.height, target, path);
+
+                const bool matches = (path == DSDXTDecoder::Path::Scalar) ||
+                                     std::memcmp(reference.data(), output.data(), output.size()) == 0;
+
+                char sizeText[32];
+                std::snprintf(sizeText, sizeof(sizeText), "%ux%u", size.width, size.height);
+                std::printf("%-6s %-11s %-7s %12.1f%s\n", dxt5 ? "DXT5" : "DXT1", sizeText,
+                            DSDXTDecoder::GetPathName(path), mbPerSecond, matches ? "" : "  MISMATCH");
+            }
+        }
+    }
+
+    return 0;
+}
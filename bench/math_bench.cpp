@@ -0,0 +1,530 @@
+#include "../engine/src/Matrix4x4.h"
+#include "../engine/src/DSCpu.h"
+#include "../engine/src/DSFrustum.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using DSEngine::Matrix4x4;
+using DSEngine::Vector3;
+using DSEngine::Vector4;
+using DSEngine::Quaternion;
+using DSEngine::DSCpu;
+using DSEngine::DSFrustum;
+
+namespace {
+    using Clock = std::chrono::high_resolution_clock;
+
+    // Enough data to stay in L1/L2, the operations are measured, not the memory
+    const size_t ELEMENT_COUNT = 1024;
+    // Objects culled per frame
+    const uint32_t CULL_COUNT = 100000;
+
+    // =====================
+    // Scalar baselines
+    // =====================
+
+    // The loops Matrix4x4 used before its SSE paths, results must match them bit for bit
+    Matrix4x4 MultiplyScalar(const Matrix4x4& a, const Matrix4x4& b) {
+        Matrix4x4 result;
+        for (int i = 0; i < 4; ++i) {
+            for (int j = 0; j < 4; ++j) {
+                result.m[i][j] =
+                    a.m[0][j] * b.m[i][0] +
+                    a.m[1][j] * b.m[i][1] +
+                    a.m[2][j] * b.m[i][2] +
+                    a.m[3][j] * b.m[i][3];
+            }
+        }
+        return result;
+    }
+
+    Vector4 TransformScalar(const Matrix4x4& a, const Vector4& vec) {
+        return Vector4(
+            a.columns[0].x * vec.x + a.columns[1].x * vec.y + a.columns[2].x * vec.z + a.columns[3].x * vec.w,
+            a.columns[0].y * vec.x + a.columns[1].y * vec.y + a.columns[2].y * vec.z + a.columns[3].y * vec.w,
+            a.columns[0].z * vec.x + a.columns[1].z * vec.y + a.columns[2].z * vec.z + a.columns[3].z * vec.w,
+            a.columns[0].w * vec.x + a.columns[1].w * vec.y + a.columns[2].w * vec.z + a.columns[3].w * vec.w
+        );
+    }
+
+    Matrix4x4 TransposeScalar(const Matrix4x4& a) {
+        Matrix4x4 result;
+        for (int i = 0; i < 4; ++i) {
+            for (int j = 0; j < 4; ++j) {
+                result.m[i][j] = a.m[j][i];
+            }
+        }
+        return result;
+    }
+
+    // Cofactor expansion, the generic inverse callers used to write themselves
+    Matrix4x4 InverseScalar(const Matrix4x4& a) {
+        const float* m = a.data;
+        float inv[16];
+        inv[0] = m[5] * m[10] * m[15] - m[5] * m[11] * m[14] - m[9] * m[6] * m[15] + m[9] * m[7] * m[14] + m[13] * m[6] * m[11] - m[13] * m[7] * m[10];
+        inv[4] = -m[4] * m[10] * m[15] + m[4] * m[11] * m[14] + m[8] * m[6] * m[15] - m[8] * m[7] * m[14] - m[12] * m[6] * m[11] + m[12] * m[7] * m[10];
+        inv[8] = m[4] * m[9] * m[15] - m[4] * m[11] * m[13] - m[8] * m[5] * m[15] + m[8] * m[7] * m[13] + m[12] * m[5] * m[11] - m[12] * m[7] * m[9];
+        inv[12] = -m[4] * m[9] * m[14] + m[4] * m[10] * m[13] + m[8] * m[5] * m[14] - m[8] * m[6] * m[13] - m[12] * m[5] * m[10] + m[12] * m[6] * m[9];
+        inv[1] = -m[1] * m[10] * m[15] + m[1] * m[11] * m[14] + m[9] * m[2] * m[15] - m[9] * m[3] * m[14] - m[13] * m[2] * m[11] + m[13] * m[3] * m[10];
+        inv[5] = m[0] * m[10] * m[15] - m[0] * m[11] * m[14] - m[8] * m[2] * m[15] + m[8] * m[3] * m[14] + m[12] * m[2] * m[11] - m[12] * m[3] * m[10];
+        inv[9] = -m[0] * m[9] * m[15] + m[0] * m[11] * m[13] + m[8] * m[1] * m[15] - m[8] * m[3] * m[13] - m[12] * m[1] * m[11] + m[12] * m[3] * m[9];
+        inv[13] = m[0] * m[9] * m[14] - m[0] * m[10] * m[13] - m[8] * m[1] * m[14] + m[8] * m[2] * m[13] + m[12] * m[1] * m[10] - m[12] * m[2] * m[9];
+        inv[2] = m[1] * m[6] * m[15] - m[1] * m[7] * m[14] - m[5] * m[2] * m[15] + m[5] * m[3] * m[14] + m[13] * m[2] * m[7] - m[13] * m[3] * m[6];
+        inv[6] = -m[0] * m[6] * m[15] + m[0] * m[7] * m[14] + m[4] * m[2] * m[15] - m[4] * m[3] * m[14] - m[12] * m[2] * m[7] + m[12] * m[3] * m[6];
+        inv[10] = m[0] * m[5] * m[15] - m[0] * m[7] * m[13] - m[4] * m[1] * m[15] + m[4] * m[3] * m[13] + m[12] * m[1] * m[7] - m[12] * m[3] * m[5];
+        inv[14] = -m[0] * m[5] * m[14] + m[0] * m[6] * m[13] + m[4] * m[1] * m[14] - m[4] * m[2] * m[13] - m[12] * m[1] * m[6] + m[12] * m[2] * m[5];
+        inv[3] = -m[1] * m[6] * m[11] + m[1] * m[7] * m[10] + m[5] * m[2] * m[11] - m[5] * m[3] * m[10] - m[9] * m[2] * m[7] + m[9] * m[3] * m[6];
+        inv[7] = m[0] * m[6] * m[11] - m[0] * m[7] * m[10] - m[4] * m[2] * m[11] + m[4] * m[3] * m[10] + m[8] * m[2] * m[7] - m[8] * m[3] * m[6];
+        inv[11] = -m[0] * m[5] * m[11] + m[0] * m[7] * m[9] + m[4] * m[1] * m[11] - m[4] * m[3] * m[9] - m[8] * m[1] * m[7] + m[8] * m[3] * m[5];
+        inv[15] = m[0] * m[5] * m[10] - m[0] * m[6] * m[9] - m[4] * m[1] * m[10] + m[4] * m[2] * m[9] + m[8] * m[1] * m[6] - m[8] * m[2] * m[5];
+
+        const float det = m[0] * inv[0] + m[1] * inv[4] + m[2] * inv[8] + m[3] * inv[12];
+        Matrix4x4 result;
+        for (int i = 0; i < 16; i++) {
+            result.data[i] = inv[i] / det;
+        }
+        return result;
+    }
+
+    float DeterminantScalar(const Matrix4x4& a) {
+        const float* m = a.data;
+        const float c0 = m[5] * (m[10] * m[15] - m[11] * m[14]) - m[9] * (m[6] * m[15] - m[7] * m[14]) + m[13] * (m[6] * m[11] - m[7] * m[10]);
+        const float c1 = m[1] * (m[10] * m[15] - m[11] * m[14]) - m[9] * (m[2] * m[15] - m[3] * m[14]) + m[13] * (m[2] * m[11] - m[3] * m[10]);
+        const float c2 = m[1] * (m[6] * m[15] - m[7] * m[14]) - m[5] * (m[2] * m[15] - m[3] * m[14]) + m[13] * (m[2] * m[7] - m[3] * m[6]);
+        const float c3 = m[1] * (m[6] * m[11] - m[7] * m[10]) - m[5] * (m[2] * m[11] - m[3] * m[10]) + m[9] * (m[2] * m[7] - m[3] * m[6]);
+        return m[0] * c0 - m[4] * c1 + m[8] * c2 - m[12] * c3;
+    }
+
+    // Quaternion code before SSE
+    Quaternion QuaternionMultiplyScalar(const Quaternion& a, const Quaternion& q) {
+        return Quaternion(
+            a.w * q.x + a.x * q.w + a.y * q.z - a.z * q.y,
+            a.w * q.y - a.x * q.z + a.y * q.w + a.z * q.x,
+            a.w * q.z + a.x * q.y - a.y * q.x + a.z * q.w,
+            a.w * q.w - a.x * q.x - a.y * q.y - a.z * q.z
+        );
+    }
+
+    Vector3 QuaternionRotateScalar(const Quaternion& q, const Vector3& v) {
+        const Vector3 u(q.x, q.y, q.z);
+        return u * 2.0f * Vector3::Dot(u, v) + v * (q.w * q.w - Vector3::Dot(u, u)) + Vector3::Cross(u, v) * 2.0f * q.w;
+    }
+
+    // The usual slerp with acos and sin, linear when the quaternions are too close
+    Quaternion SlerpScalar(const Quaternion& a, Quaternion b, float t) {
+        float cosine = a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w;
+        if (cosine < 0.0f) {
+            cosine = -cosine;
+            b = Quaternion(-b.x, -b.y, -b.z, -b.w);
+        }
+        float weightA = 1.0f - t, weightB = t;
+        if (cosine < 0.9995f) {
+            const float angle = std::acos(cosine);
+            const float sine = std::sin(angle);
+            weightA = std::sin((1.0f - t) * angle) / sine;
+            weightB = std::sin(t * angle) / sine;
+        }
+        return Quaternion(a.x * weightA + b.x * weightB, a.y * weightA + b.y * weightB,
+                          a.z * weightA + b.z * weightB, a.w * weightA + b.w * weightB);
+    }
+
+    // Mathf approximations over arrays, 4 and 8 values at a time
+    enum class MathOperation {
+        InvSqrt,
+        Sin,
+        Atan2,
+        Exp,
+        Log
+    };
+
+    void ApplySSE(MathOperation operation, const float* x, const float* y, float* output, size_t count) {
+        for (size_t i = 0; i + 4 <= count; i += 4) {
+            const __m128 vx = _mm_loadu_ps(x + i);
+            __m128 result;
+            switch (operation) {
+                case MathOperation::InvSqrt: result = Mathf::InvSqrt(vx); break;
+                case MathOperation::Sin: result = Mathf::Sin(vx); break;
+                case MathOperation::Atan2: result = Mathf::Atan2(_mm_loadu_ps(y + i), vx); break;
+                case MathOperation::Exp: result = Mathf::Exp(vx); break;
+                default: result = Mathf::Log(vx); break;
+            }
+            _mm_storeu_ps(output + i, result);
+        }
+    }
+
+    DS_TARGET("avx2") void ApplyAVX2(MathOperation operation, const float* x, const float* y, float* output, size_t count) {
+        for (size_t i = 0; i + 8 <= count; i += 8) {
+            const __m256 vx = _mm256_loadu_ps(x + i);
+            __m256 result;
+            switch (operation) {
+                case MathOperation::InvSqrt: result = Mathf::InvSqrt(vx); break;
+                case MathOperation::Sin: result = Mathf::Sin(vx); break;
+                case MathOperation::Atan2: result = Mathf::Atan2(_mm256_loadu_ps(y + i), vx); break;
+                case MathOperation::Exp: result = Mathf::Exp(vx); break;
+                default: result = Mathf::Log(vx); break;
+            }
+            _mm256_storeu_ps(output + i, result);
+        }
+    }
+
+    // =====================
+    // Measurement
+    // =====================
+
+    // Runs the operation over every element repeatedly for at least minSeconds, returns millions of elements per second
+    template <typename Operation>
+    double Measure(Operation&& operation) {
+        const double minSeconds = 0.25;
+        uint32_t iterations = 0;
+        double elapsed = 0.0;
+        const Clock::time_point start = Clock::now();
+
+        do {
+            for (size_t i = 0; i < ELEMENT_COUNT; i++) {
+                operation(i);
+            }
+            iterations++;
+            elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+        } while (elapsed < minSeconds);
+
+        return static_cast<double>(ELEMENT_COUNT) * iterations / elapsed / 1e6;
+    }
+
+    // Same for operations that process elementCount elements in one call
+    template <typename Operation>
+    double MeasureBatch(size_t elementCount, Operation&& operation) {
+        const double minSeconds = 0.25;
+        uint32_t iterations = 0;
+        double elapsed = 0.0;
+        const Clock::time_point start = Clock::now();
+
+        do {
+            operation();
+            iterations++;
+            elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+        } while (elapsed < minSeconds);
+
+        return static_cast<double>(elementCount) * iterations / elapsed / 1e6;
+    }
+
+    void Report(const char* operation, const char* path, double millionsPerSecond, double baseline, bool matches) {
+        std::printf("%-22s %-8s %10.1f %8.2fx%s\n", operation, path, millionsPerSecond,
+                    baseline > 0.0 ? millionsPerSecond / baseline : 1.0, matches ? "" : "  MISMATCH");
+    }
+
+    template <typename T>
+    bool SameBits(const std::vector<T>& a, const std::vector<T>& b) {
+        return std::memcmp(a.data(), b.data(), a.size() * sizeof(T)) == 0;
+    }
+
+    // Culling only fills the start of the index arrays
+    bool SameIndices(const std::vector<uint32_t>& a, uint32_t countA, const std::vector<uint32_t>& b, uint32_t countB) {
+        return countA == countB && std::equal(a.begin(), a.begin() + countA, b.begin());
+    }
+
+    // Different operation orders round differently, compare with a tolerance relative to the values
+    bool Close(const float* a, const float* b, size_t count, float tolerance) {
+        for (size_t i = 0; i < count; i++) {
+            if (std::fabs(a[i] - b[i]) > tolerance * std::max(1.0f, std::fabs(b[i]))) return false;
+        }
+        return true;
+    }
+}
+
+int main() {
+    std::mt19937 random(1234);
+    std::uniform_real_distribution<float> values(-4.0f, 4.0f);
+
+    std::vector<Matrix4x4> matrices(ELEMENT_COUNT), others(ELEMENT_COUNT), transforms(ELEMENT_COUNT);
+    std::vector<Vector4> vectors(ELEMENT_COUNT);
+    for (size_t i = 0; i < ELEMENT_COUNT; i++) {
+        for (float& value : matrices[i].data) value = values(random);
+        for (float& value : others[i].data) value = values(random);
+        vectors[i] = Vector4(values(random), values(random), values(random), values(random));
+
+        // Object transforms, the usual input of the affine inverse
+        const Quaternion rotation = Quaternion(values(random), values(random), values(random), values(random)).Normalized();
+        const Vector3 scale(0.5f + std::fabs(values(random)), 0.5f + std::fabs(values(random)), 0.5f + std::fabs(values(random)));
+        transforms[i] = Matrix4x4::TRS(Vector3(values(random), values(random), values(random)) * 10.0f, rotation, scale);
+    }
+
+    std::printf("AVX: %s\n", DSCpu::HasAVX() ? "yes" : "no");
+    std::printf("%-22s %-8s %10s %9s\n", "operation", "path", "M/s", "speedup");
+
+    {
+        std::vector<Matrix4x4> reference(ELEMENT_COUNT), output(ELEMENT_COUNT);
+        const double scalar = Measure([&](size_t i) { reference[i] = MultiplyScalar(matrices[i], others[i]); });
+        const double simd = Measure([&](size_t i) { output[i] = matrices[i] * others[i]; });
+        Report("matrix * matrix", "scalar", scalar, scalar, true);
+        Report("matrix * matrix", DSCpu::HasAVX() ? "avx" : "sse", simd, scalar, SameBits(reference, output));
+    }
+
+    {
+        std::vector<Vector4> reference(ELEMENT_COUNT), output(ELEMENT_COUNT);
+        const double scalar = Measure([&](size_t i) { reference[i] = TransformScalar(matrices[i], vectors[i]); });
+        const double simd = Measure([&](size_t i) { output[i] = matrices[i] * vectors[i]; });
+        Report("matrix * vector4", "scalar", scalar, scalar, true);
+        Report("matrix * vector4", "sse", simd, scalar, SameBits(reference, output));
+    }
+
+    {
+        std::vector<Matrix4x4> reference(ELEMENT_COUNT), output(ELEMENT_COUNT);
+        const double scalar = Measure([&](size_t i) { reference[i] = TransposeScalar(matrices[i]); });
+        const double simd = Measure([&](size_t i) { output[i] = matrices[i].Transposed(); });
+        Report("transpose", "scalar", scalar, scalar, true);
+        Report("transpose", "sse", simd, scalar, SameBits(reference, output));
+    }
+
+    {
+        std::vector<float> reference(ELEMENT_COUNT), output(ELEMENT_COUNT);
+        const double scalar = Measure([&](size_t i) { reference[i] = DeterminantScalar(matrices[i]); });
+        const double simd = Measure([&](size_t i) { output[i] = matrices[i].Determinant(); });
+        Report("determinant", "scalar", scalar, scalar, true);
+        Report("determinant", "sse", simd, scalar, Close(output.data(), reference.data(), ELEMENT_COUNT, 1e-4f));
+    }
+
+    {
+        std::vector<Matrix4x4> reference(ELEMENT_COUNT), output(ELEMENT_COUNT), affine(ELEMENT_COUNT);
+        const double scalar = Measure([&](size_t i) { reference[i] = InverseScalar(transforms[i]); });
+        const double simd = Measure([&](size_t i) { output[i] = transforms[i].Inversed(); });
+        const double simdAffine = Measure([&](size_t i) { affine[i] = transforms[i].InversedAffine(); });
+        const size_t floatCount = ELEMENT_COUNT * 16;
+        Report("inverse (TRS input)", "scalar", scalar, scalar, true);
+        Report("inverse (TRS input)", "sse", simd, scalar, Close(output[0].data, reference[0].data, floatCount, 1e-3f));
+        Report("inverse affine", "sse", simdAffine, scalar, Close(affine[0].data, reference[0].data, floatCount, 1e-3f));
+    }
+
+    {
+        // Decompose rebuilt with TRS, every other transform mirrored on one axis (decomposed as a negative x scale)
+        std::vector<Matrix4x4> inputs(transforms);
+        for (size_t i = 1; i < ELEMENT_COUNT; i += 2) {
+            inputs[i] = inputs[i] * Matrix4x4::Scale(Vector3(1.0f, -1.0f, 1.0f));
+        }
+        std::vector<Vector3> translations(ELEMENT_COUNT), scales(ELEMENT_COUNT);
+        std::vector<Quaternion> rotations(ELEMENT_COUNT);
+        std::vector<Matrix4x4> rebuilt(ELEMENT_COUNT);
+        bool decomposed = true;
+        const double simd = Measure([&](size_t i) {
+            decomposed &= inputs[i].Decompose(translations[i], rotations[i], scales[i]);
+        });
+        bool mirrored = true;
+        for (size_t i = 0; i < ELEMENT_COUNT; i++) {
+            rebuilt[i] = Matrix4x4::TRS(translations[i], rotations[i], scales[i]);
+            mirrored &= (scales[i].x < 0.0f) == (i % 2 == 1);
+        }
+
+        // No TRS form for projections and zero scales
+        Vector3 translation, scale;
+        Quaternion rotation;
+        const bool rejects = !Matrix4x4::Perspective(60.0f, 1.5f, 0.1f, 100.0f).Decompose(translation, rotation, scale) &&
+                             !Matrix4x4::TRS(Vector3(1.0f, 2.0f, 3.0f), Quaternion::identity, Vector3(1.0f, 0.0f, 1.0f))
+                                  .Decompose(translation, rotation, scale);
+
+        Report("decompose", "sse", simd, simd, decomposed && mirrored && rejects &&
+               Close(rebuilt[0].data, inputs[0].data, ELEMENT_COUNT * 16, 1e-4f));
+    }
+
+    {
+        // One matrix over many points: the per-point operator against the batches, affine and projective
+        std::vector<Vector3> points(ELEMENT_COUNT), reference(ELEMENT_COUNT), output(ELEMENT_COUNT);
+        std::vector<float> x(ELEMENT_COUNT), y(ELEMENT_COUNT), z(ELEMENT_COUNT);
+        std::vector<float> outX(ELEMENT_COUNT), outY(ELEMENT_COUNT), outZ(ELEMENT_COUNT);
+        for (size_t i = 0; i < ELEMENT_COUNT; i++) {
+            points[i] = Vector3(values(random), values(random), values(random));
+            x[i] = points[i].x;
+            y[i] = points[i].y;
+            z[i] = points[i].z;
+        }
+        const char* batchPath = DSCpu::HasAVX() ? "avx" : "sse";
+        const Matrix4x4 projection = Matrix4x4::Perspective(60.0f, 1.5f, 0.1f, 100.0f) * transforms[0];
+        const Matrix4x4* cases[2] = { &transforms[0], &projection };
+        const char* names[2][3] = {
+            { "points (affine)", "points aos (affine)", "points soa (affine)" },
+            { "points (projective)", "points aos (proj)", "points soa (proj)" }
+        };
+
+        for (int c = 0; c < 2; c++) {
+            const Matrix4x4& matrix = *cases[c];
+            const double single = Measure([&](size_t i) { reference[i] = matrix * points[i]; });
+            const double aos = MeasureBatch(ELEMENT_COUNT, [&] { matrix.TransformPoints(points.data(), output.data(), ELEMENT_COUNT); });
+            const double soa = MeasureBatch(ELEMENT_COUNT, [&] {
+                matrix.TransformPoints(x.data(), y.data(), z.data(), outX.data(), outY.data(), outZ.data(), ELEMENT_COUNT);
+            });
+            bool soaMatches = true;
+            for (size_t i = 0; i < ELEMENT_COUNT; i++) {
+                soaMatches = soaMatches && std::memcmp(&outX[i], &reference[i].x, sizeof(float)) == 0 &&
+                             std::memcmp(&outY[i], &reference[i].y, sizeof(float)) == 0 &&
+                             std::memcmp(&outZ[i], &reference[i].z, sizeof(float)) == 0;
+            }
+            Report(names[c][0], "sse", single, single, true);
+            Report(names[c][1], batchPath, aos, single, SameBits(reference, output));
+            Report(names[c][2], batchPath, soa, single, soaMatches);
+        }
+    }
+
+    {
+        std::vector<Quaternion> rotations(ELEMENT_COUNT), others(ELEMENT_COUNT), reference(ELEMENT_COUNT), output(ELEMENT_COUNT);
+        std::vector<Vector3> points(ELEMENT_COUNT), rotated(ELEMENT_COUNT), rotatedReference(ELEMENT_COUNT);
+        for (size_t i = 0; i < ELEMENT_COUNT; i++) {
+            rotations[i] = Quaternion(values(random), values(random), values(random), values(random)).Normalized();
+            others[i] = Quaternion(values(random), values(random), values(random), values(random)).Normalized();
+            points[i] = Vector3(values(random), values(random), values(random));
+        }
+
+        const double scalarMultiply = Measure([&](size_t i) { reference[i] = QuaternionMultiplyScalar(rotations[i], others[i]); });
+        const double simdMultiply = Measure([&](size_t i) { output[i] = rotations[i] * others[i]; });
+        Report("quaternion * quat", "scalar", scalarMultiply, scalarMultiply, true);
+        Report("quaternion * quat", "sse", simdMultiply, scalarMultiply,
+               Close(output[0].data, reference[0].data, ELEMENT_COUNT * 4, 1e-5f));
+
+        const double scalarRotate = Measure([&](size_t i) { rotatedReference[i] = QuaternionRotateScalar(rotations[i], points[i]); });
+        const double simdRotate = Measure([&](size_t i) { rotated[i] = rotations[i] * points[i]; });
+        Report("quaternion * vector3", "scalar", scalarRotate, scalarRotate, true);
+        Report("quaternion * vector3", "sse", simdRotate, scalarRotate,
+               Close(&rotated[0].x, &rotatedReference[0].x, ELEMENT_COUNT * 3, 1e-5f));
+
+        // Blending two poses
+        const char* batchPath = DSCpu::HasAVX() ? "avx" : "sse";
+        const double scalarSlerp = Measure([&](size_t i) { reference[i] = SlerpScalar(rotations[i], others[i], 0.3f); });
+        const double batchSlerp = MeasureBatch(ELEMENT_COUNT, [&] {
+            Quaternion::Slerp(rotations.data(), others.data(), 0.3f, output.data(), ELEMENT_COUNT);
+        });
+        Report("slerp", "scalar", scalarSlerp, scalarSlerp, true);
+        Report("slerp", batchPath, batchSlerp, scalarSlerp, Close(output[0].data, reference[0].data, ELEMENT_COUNT * 4, 1e-5f));
+        const double batchNlerp = MeasureBatch(ELEMENT_COUNT, [&] {
+            Quaternion::Nlerp(rotations.data(), others.data(), 0.3f, output.data(), ELEMENT_COUNT);
+        });
+        Report("nlerp", batchPath, batchNlerp, scalarSlerp, true);
+
+        std::vector<Matrix4x4> matrixReference(ELEMENT_COUNT), matrices(ELEMENT_COUNT);
+        const double singleMatrix = Measure([&](size_t i) { matrixReference[i] = Matrix4x4::Rotate(rotations[i]); });
+        const double batchMatrix = MeasureBatch(ELEMENT_COUNT, [&] {
+            Matrix4x4::Rotate(rotations.data(), matrices.data(), ELEMENT_COUNT);
+        });
+        Report("quaternion to matrix", "scalar", singleMatrix, singleMatrix, true);
+        Report("quaternion to matrix", "sse", batchMatrix, singleMatrix, SameBits(matrixReference, matrices));
+    }
+
+    {
+        // A scene 200 units across seen from its center, about a seventh of it visible
+        std::uniform_real_distribution<float> positions(-100.0f, 100.0f), sizes(0.5f, 4.0f);
+        std::vector<float> x(CULL_COUNT), y(CULL_COUNT), z(CULL_COUNT), radius(CULL_COUNT);
+        std::vector<float> extentX(CULL_COUNT), extentY(CULL_COUNT), extentZ(CULL_COUNT);
+        for (uint32_t i = 0; i < CULL_COUNT; i++) {
+            x[i] = positions(random);
+            y[i] = positions(random);
+            z[i] = positions(random);
+            radius[i] = sizes(random);
+            extentX[i] = sizes(random);
+            extentY[i] = sizes(random);
+            extentZ[i] = sizes(random);
+        }
+        const DSFrustum frustum(Matrix4x4::Perspective(75.0f, 16.0f / 9.0f, 0.1f, 500.0f) *
+                                Matrix4x4::Rotate(Quaternion(0.1f, 0.3f, 0.0f, 0.95f).Normalized()));
+        const char* cullPath = DSCpu::HasAVX() ? "avx" : "sse";
+
+        std::vector<uint32_t> reference(CULL_COUNT), visible(CULL_COUNT), visibleThreaded(CULL_COUNT);
+        uint32_t referenceCount = 0, visibleCount = 0, threadedCount = 0;
+        const double scalar = MeasureBatch(CULL_COUNT, [&] {
+            referenceCount = 0;
+            for (uint32_t i = 0; i < CULL_COUNT; i++) {
+                if (frustum.TestSphere(Vector3(x[i], y[i], z[i]), radius[i])) reference[referenceCount++] = i;
+            }
+        });
+        const double simd = MeasureBatch(CULL_COUNT, [&] {
+            visibleCount = frustum.CullSpheres(x.data(), y.data(), z.data(), radius.data(), CULL_COUNT, visible.data());
+        });
+        const double threaded = MeasureBatch(CULL_COUNT, [&] {
+            threadedCount = frustum.CullSpheres(x.data(), y.data(), z.data(), radius.data(), CULL_COUNT,
+                                                visibleThreaded.data(), 0);
+        });
+        Report("cull spheres", "scalar", scalar, scalar, true);
+        Report("cull spheres", cullPath, simd, scalar, SameIndices(reference, referenceCount, visible, visibleCount));
+        Report("cull spheres", "threads", threaded, scalar, SameIndices(reference, referenceCount, visibleThreaded, threadedCount));
+
+        const double scalarBoxes = MeasureBatch(CULL_COUNT, [&] {
+            referenceCount = 0;
+            for (uint32_t i = 0; i < CULL_COUNT; i++) {
+                if (frustum.TestAABB(Vector3(x[i], y[i], z[i]), Vector3(extentX[i], extentY[i], extentZ[i]))) {
+                    reference[referenceCount++] = i;
+                }
+            }
+        });
+        const double simdBoxes = MeasureBatch(CULL_COUNT, [&] {
+            visibleCount = frustum.CullAABBs(x.data(), y.data(), z.data(), extentX.data(), extentY.data(), extentZ.data(),
+                                             CULL_COUNT, visible.data());
+        });
+        const double threadedBoxes = MeasureBatch(CULL_COUNT, [&] {
+            threadedCount = frustum.CullAABBs(x.data(), y.data(), z.data(), extentX.data(), extentY.data(),
+                                              extentZ.data(), CULL_COUNT, visibleThreaded.data(), 0);
+        });
+        Report("cull aabbs", "scalar", scalarBoxes, scalarBoxes, true);
+        Report("cull aabbs", cullPath, simdBoxes, scalarBoxes, SameIndices(reference, referenceCount, visible, visibleCount));
+        Report("cull aabbs", "threads", threadedBoxes, scalarBoxes, SameIndices(reference, referenceCount, visibleThreaded, threadedCount));
+        std::printf("visible: %u of %u\n", referenceCount, CULL_COUNT);
+    }
+
+    {
+        // Mathf against libm, inputs in the ranges the functions are used with
+        struct MathCase {
+            MathOperation operation;
+            const char* name;
+            float low, high;
+            float tolerance;
+        };
+        const MathCase cases[] = {
+            { MathOperation::InvSqrt, "invsqrt", 0.001f, 1000.0f, 1e-6f },
+            { MathOperation::Sin, "sin", -Mathf::Internal::SIN_COS_RANGE, Mathf::Internal::SIN_COS_RANGE, 1e-6f },
+            { MathOperation::Atan2, "atan2", -10.0f, 10.0f, 1e-6f },
+            { MathOperation::Exp, "exp", -20.0f, 20.0f, 1e-6f },
+            { MathOperation::Log, "log", 0.001f, 1000.0f, 1e-6f }
+        };
+
+        std::vector<float> x(ELEMENT_COUNT), y(ELEMENT_COUNT), reference(ELEMENT_COUNT), output(ELEMENT_COUNT);
+        for (const MathCase& math : cases) {
+            std::uniform_real_distribution<float> inputs(math.low, math.high);
+            for (size_t i = 0; i < ELEMENT_COUNT; i++) {
+                x[i] = inputs(random);
+                y[i] = inputs(random);
+            }
+
+            const double libm = Measure([&](size_t i) {
+                switch (math.operation) {
+                    case MathOperation::InvSqrt: reference[i] = 1.0f / std::sqrt(x[i]); break;
+                    case MathOperation::Sin: reference[i] = std::sin(x[i]); break;
+                    case MathOperation::Atan2: reference[i] = std::atan2(y[i], x[i]); break;
+                    case MathOperation::Exp: reference[i] = std::exp(x[i]); break;
+                    case MathOperation::Log: reference[i] = std::log(x[i]); break;
+                }
+            });
+            // Only InvSqrt has a scalar approximation, the other scalar functions are libm
+            double scalar = 0.0;
+            bool scalarMatches = true;
+            if (math.operation == MathOperation::InvSqrt) {
+                scalar = Measure([&](size_t i) { output[i] = Mathf::InvSqrt(x[i]); });
+                scalarMatches = Close(output.data(), reference.data(), ELEMENT_COUNT, math.tolerance);
+            }
+            const double sse = MeasureBatch(ELEMENT_COUNT, [&] {
+                ApplySSE(math.operation, x.data(), y.data(), output.data(), ELEMENT_COUNT);
+            });
+            const bool sseMatches = Close(output.data(), reference.data(), ELEMENT_COUNT, math.tolerance);
+
+            Report(math.name, "libm", libm, libm, true);
+            if (math.operation == MathOperation::InvSqrt) Report(math.name, "scalar", scalar, libm, scalarMatches);
+            Report(math.name, "sse", sse, libm, sseMatches);
+            if (DSCpu::HasAVX2()) {
+                const double avx2 = MeasureBatch(ELEMENT_COUNT, [&] {
+                    ApplyAVX2(math.operation, x.data(), y.data(), output.data(), ELEMENT_COUNT);
+                });
+                Report(math.name, "avx2", avx2, libm, Close(output.data(), reference.data(), ELEMENT_COUNT, math.tolerance));
+            }
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,98 @@
+#include "../engine/src/DSPixelConverter.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using DSEngine::DSPixelConverter;
+
+namespace {
+    using Clock = std::chrono::high_resolution_clock;
+
+    enum class Conversion {
+        RGB8ToRGBA8,
+        RGBA8ToRGB8,
+        GrayToRGB8,
+        GrayAlphaToRGB8,
+        GrayAlphaToRGBA8,
+        SwapRedBlue
+    };
+
+    struct ConversionInfo {
+        Conversion conversion;
+        const char* name;
+        uint32_t srcPixelSize;
+        uint32_t destPixelSize;
+    };
+
+    void Convert(Conversion conversion, const uint8_t* src, uint8_t* dest, size_t pixelCount, DSPixelConverter::Path path) {
+        switch (conversion) {
+            case Conversion::RGB8ToRGBA8: DSPixelConverter::RGB8ToRGBA8(src, dest, pixelCount, 255, path); break;
+            case Conversion::RGBA8ToRGB8: DSPixelConverter::RGBA8ToRGB8(src, dest, pixelCount, path); break;
+            case Conversion::GrayToRGB8: DSPixelConverter::GrayToRGB8(src, dest, pixelCount, path); break;
+            case Conversion::GrayAlphaToRGB8: DSPixelConverter::GrayAlphaToRGB8(src, dest, pixelCount, path); break;
+            case Conversion::GrayAlphaToRGBA8: DSPixelConverter::GrayAlphaToRGBA8(src, dest, pixelCount, path); break;
+            case Conversion::SwapRedBlue: DSPixelConverter::SwapRedBlue(src, dest, pixelCount, path); break;
+        }
+    }
+
+    // Converts the image repeatedly for at least minSeconds and returns the written MB/s
+    double MeasureConvert(Conversion conversion, const std::vector<uint8_t>& source, std::vector<uint8_t>& output,
+                          size_t pixelCount, DSPixelConverter::Path path) {
+        const double minSeconds = 0.25;
+        uint32_t iterations = 0;
+        double elapsed = 0.0;
+        const Clock::time_point start = Clock::now();
+
+        do {
+            Convert(conversion, source.data(), output.data(), pixelCount, path);
+            iterations++;
+            elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+        } while (elapsed < minSeconds);
+
+        const double bytes = static_cast<double>(output.size()) * iterations;
+        return bytes / (1024.0 * 1024.0) / elapsed;
+    }
+}
+
+int main() {
+    const ConversionInfo conversions[] = {
+        { Conversion::RGB8ToRGBA8, "RGB8->RGBA8", 3, 4 },
+        { Conversion::RGBA8ToRGB8, "RGBA8->RGB8", 4, 3 },
+        { Conversion::GrayToRGB8, "Gray->RGB8", 1, 3 },
+        { Conversion::GrayAlphaToRGB8, "GA->RGB8", 2, 3 },
+        { Conversion::GrayAlphaToRGBA8, "GA->RGBA8", 2, 4 },
+        { Conversion::SwapRedBlue, "BGRA<->RGBA", 4, 4 }
+    };
+    // Small UI sprite, atlas page and a 4K screenshot (odd width to exercise the scalar tails)
+    const size_t pixelCounts[] = { 64 * 64, 2048 * 2048, 3841 * 2160 };
+    const DSPixelConverter::Path paths[] = { DSPixelConverter::Path::Scalar, DSPixelConverter::Path::SSSE3, DSPixelConverter::Path::AVX2 };
+
+    std::printf("Best path on this CPU: %s\n", DSPixelConverter::GetPathName(DSPixelConverter::GetBestPath()));
+    std::printf("%-12s %-10s %-7s %12s\n", "conversion", "pixels", "path", "MB/s");
+
+    std::mt19937 random(1234);
+    for (const ConversionInfo& info : conversions) {
+        for (size_t pixelCount : pixelCounts) {
+            std::vector<uint8_t> source(pixelCount * info.srcPixelSize);
+            for (uint8_t& b : source) b = static_cast<uint8_t>(random());
+
+            std::vector<uint8_t> reference(pixelCount * info.destPixelSize);
+            std::vector<uint8_t> output(reference.size());
+
+            for (DSPixelConverter::Path path : paths) {
+                std::vector<uint8_t>& target = (path == DSPixelConverter::Path::Scalar) ? reference : output;
+                const double mbPerSecond = MeasureConvert(info.conversion, source, target, pixelCount, path);
+
+                const bool matches = (path == DSPixelConverter::Path::Scalar) ||
+                                     std::memcmp(reference.data(), output.data(), output.size()) == 0;
+
+                std::printf("%-12s %-10zu %-7s %12.1f%s\n", info.name, pixelCount,
+                            DSPixelConverter::GetPathName(path), mbPerSecond, matches ? "" : "  MISMATCH");
+            }
+        }
+    }
+
+    return 0;
+}
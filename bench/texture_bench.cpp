@@ -0,0 +1,514 @@
+#include "../engine/src/DSTexture.h"
+#include "../engine/src/DSPixelConverter.h"
+#include "../engine/src/DSFloatConverter.h"
+#include "../engine/src/DSTextureSampler.h"
+#include "../engine/src/DSBufferPool.h"
+#include "../engine/src/DSDXTEncoder.h"
+#include "../engine/src/DSThreadPool.h"
+#include "../engine/src/DSCpu.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <string>
+#include <vector>
+#ifdef _MSC_VER
+#include <malloc.h>
+#endif
+
+using DSEngine::DSTexture;
+using DSEngine::DSPixelConverter;
+using DSEngine::DSFloatConverter;
+using DSEngine::DSBufferPool;
+using DSEngine::DSDXTEncoder;
+
+// =====================
+// Allocation counting
+// =====================
+
+// Every heap allocation of the process goes through these, the benchmark reads the counters around each operation
+namespace {
+    std::atomic<uint64_t> g_allocationCount{0};
+    std::atomic<uint64_t> g_allocatedBytes{0};
+
+    void* CountedAlloc(size_t size, size_t alignment) {
+        g_allocationCount.fetch_add(1, std::memory_order_relaxed);
+        g_allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+        if (size == 0) size = 1;
+
+        void* ptr = nullptr;
+        if (alignment <= alignof(std::max_align_t)) {
+            ptr = std::malloc(size);
+        } else {
+#ifdef _MSC_VER
+            ptr = _aligned_malloc(size, alignment);
+#else
+            if (posix_memalign(&ptr, alignment, size) != 0) ptr = nullptr;
+#endif
+        }
+        if (!ptr) throw std::bad_alloc();
+        return ptr;
+    }
+
+    void CountedFree(void* ptr, size_t alignment) {
+#ifdef _MSC_VER
+        if (alignment > alignof(std::max_align_t)) {
+            _aligned_free(ptr);
+            return;
+        }
+#else
+        (void)alignment;
+#endif
+        std::free(ptr);
+    }
+}
+
+void* operator new(size_t size) { return CountedAlloc(size, 0); }
+void* operator new[](size_t size) { return CountedAlloc(size, 0); }
+void* operator new(size_t size, std::align_val_t align) { return CountedAlloc(size, static_cast<size_t>(align)); }
+void* operator new[](size_t size, std::align_val_t align) { return CountedAlloc(size, static_cast<size_t>(align)); }
+void operator delete(void* ptr) noexcept { CountedFree(ptr, 0); }
+void operator delete[](void* ptr) noexcept { CountedFree(ptr, 0); }
+void operator delete(void* ptr, size_t) noexcept { CountedFree(ptr, 0); }
+void operator delete[](void* ptr, size_t) noexcept { CountedFree(ptr, 0); }
+void operator delete(void* ptr, std::align_val_t align) noexcept { CountedFree(ptr, static_cast<size_t>(align)); }
+void operator delete[](void* ptr, std::align_val_t align) noexcept { CountedFree(ptr, static_cast<size_t>(align)); }
+void operator delete(void* ptr, size_t, std::align_val_t align) noexcept { CountedFree(ptr, static_cast<size_t>(align)); }
+void operator delete[](void* ptr, size_t, std::align_val_t align) noexcept { CountedFree(ptr, static_cast<size_t>(align)); }
+
+namespace {
+    using Clock = std::chrono::high_resolution_clock;
+
+    // =====================
+    // Synthetic images
+    // =====================
+
+    enum class Content {
+        Noise,     // Worst case for DXT and LZ
+        Gradient,  // Smooth, the usual case for photos and skies
+        Flat,      // Single colour, best case
+        Alpha      // Gradient colour under noisy alpha with fully transparent holes
+    };
+
+    const char* GetContentName(Content content) {
+        switch (content) {
+            case Content::Noise: return "noise";
+            case Content::Gradient: return "gradient";
+            case Content::Flat: return "flat";
+            case Content::Alpha: return "alpha";
+        }
+        return "unknown";
+    }
+
+    // Small xorshift generator, the images are identical on every platform and run
+    struct Random {
+        uint32_t state;
+
+        explicit Random(uint32_t seed) : state(seed ? seed : 1) {}
+
+        uint32_t Next() {
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            return state;
+        }
+    };
+
+    std::vector<uint8_t> MakeImage(Content content, uint32_t width, uint32_t height) {
+        std::vector<uint8_t> pixels(static_cast<size_t>(width) * height * 4);
+        Random random(width * 31 + height * 17 + static_cast<uint32_t>(content));
+
+        for (uint32_t y = 0; y < height; ++y) {
+            for (uint32_t x = 0; x < width; ++x) {
+                uint8_t* p = &pixels[(static_cast<size_t>(y) * width + x) * 4];
+                const uint8_t gx = static_cast<uint8_t>(x * 255 / (width > 1 ? width - 1 : 1));
+                const uint8_t gy = static_cast<uint8_t>(y * 255 / (height > 1 ? height - 1 : 1));
+
+                switch (content) {
+                    case Content::Noise: {
+                        const uint32_t r = random.Next();
+                        p[0] = static_cast<uint8_t>(r);
+                        p[1] = static_cast<uint8_t>(r >> 8);
+                        p[2] = static_cast<uint8_t>(r >> 16);
+                        p[3] = static_cast<uint8_t>(r >> 24);
+                        break;
+                    }
+                    case Content::Gradient:
+                        p[0] = gx;
+                        p[1] = gy;
+                        p[2] = static_cast<uint8_t>((gx + gy) / 2);
+                        p[3] = 255;
+                        break;
+                    case Content::Flat:
+                        p[0] = 90;
+                        p[1] = 140;
+                        p[2] = 200;
+                        p[3] = 255;
+                        break;
+                    case Content::Alpha: {
+                        const bool hole = ((x / 16) + (y / 16)) % 3 == 0;
+                        p[0] = gx;
+                        p[1] = static_cast<uint8_t>(255 - gy);
+                        p[2] = 128;
+                        p[3] = hole ? 0 : static_cast<uint8_t>(random.Next() >> 24);
+                        break;
+                    }
+                }
+            }
+        }
+        return pixels;
+    }
+
+    // =====================
+    // Measurement
+    // =====================
+
+    struct Result {
+        std::string operation;
+        std::string content;
+        uint32_t width = 0;
+        uint32_t height = 0;
+        uint32_t iterations = 0;
+        double seconds = 0.0;           // Time spent in the operation only, setup excluded
+        double megapixelsPerSecond = 0.0;
+        double mbPerSecond = 0.0;       // Of the RGBA8 base image
+        double allocationsPerOp = 0.0;
+        double allocatedBytesPerOp = 0.0;
+        double poolAllocationsPerOp = 0.0;
+        double poolReusesPerOp = 0.0;
+        double dxtBlocksPerOp = 0.0;
+        double dxtSolidRate = 0.0;      // Share of the encoded DXT blocks taking the solid colour path
+        double dxtCacheHitRate = 0.0;   // Share of the encoded DXT blocks copied from the repeat cache
+    };
+
+    struct Options {
+        double minSeconds = 0.2;
+        uint32_t maxIterations = 1000;
+        uint32_t maxSize = 4096;
+        std::string jsonPath = "texture_bench.json";
+        std::string tempDir = ".";
+    };
+
+    // Runs setup then op until minSeconds of op time accumulated, only op is timed and counted
+    Result Measure(const Options& options, const char* operation, Content content, uint32_t width, uint32_t height,
+                   const std::function<void()>& setup, const std::function<bool()>& op) {
+        Result result;
+        result.operation = operation;
+        result.content = GetContentName(content);
+        result.width = width;
+        result.height = height;
+
+        // One untimed run so first-use costs (pool growth, stb_dxt tables) don't skew short runs
+        setup();
+        if (!op()) {
+            std::fprintf(stderr, "%s failed on %s %ux%u\n", operation, result.content.c_str(), width, height);
+            return result;
+        }
+
+        uint64_t allocations = 0;
+        uint64_t allocatedBytes = 0;
+        uint64_t poolAllocations = 0;
+        uint64_t poolReuses = 0;
+        DSDXTEncoder::Stats encoded;
+        do {
+            setup();
+
+            const DSBufferPool::Stats poolBefore = DSBufferPool::Global().GetStats();
+            const DSDXTEncoder::Stats encoderBefore = DSDXTEncoder::GetStats();
+            const uint64_t allocationsBefore = g_allocationCount.load();
+            const uint64_t bytesBefore = g_allocatedBytes.load();
+            const Clock::time_point start = Clock::now();
+
+            op();
+
+            result.seconds += std::chrono::duration<double>(Clock::now() - start).count();
+            allocations += g_allocationCount.load() - allocationsBefore;
+            allocatedBytes += g_allocatedBytes.load() - bytesBefore;
+            const DSBufferPool::Stats poolAfter = DSBufferPool::Global().GetStats();
+            poolAllocations += poolAfter.allocations - poolBefore.allocations;
+            poolReuses += poolAfter.reuses - poolBefore.reuses;
+            const DSDXTEncoder::Stats encoderAfter = DSDXTEncoder::GetStats();
+            encoded.blocks += encoderAfter.blocks - encoderBefore.blocks;
+            encoded.solidBlocks += encoderAfter.solidBlocks - encoderBefore.solidBlocks;
+            encoded.cacheHits += encoderAfter.cacheHits - encoderBefore.cacheHits;
+            result.iterations++;
+        } while (result.seconds < options.minSeconds && result.iterations < options.maxIterations);
+
+        const double pixels = static_cast<double>(width) * height * result.iterations;
+        const double iterations = result.iterations;
+        result.megapixelsPerSecond = pixels / 1e6 / result.seconds;
+        result.mbPerSecond = pixels * 4.0 / (1024.0 * 1024.0) / result.seconds;
+        result.allocationsPerOp = allocations / iterations;
+        result.allocatedBytesPerOp = allocatedBytes / iterations;
+        result.poolAllocationsPerOp = poolAllocations / iterations;
+        result.poolReusesPerOp = poolReuses / iterations;
+        result.dxtBlocksPerOp = encoded.blocks / iterations;
+        if (encoded.blocks > 0) {
+            result.dxtSolidRate = static_cast<double>(encoded.solidBlocks) / encoded.blocks;
+            result.dxtCacheHitRate = static_cast<double>(encoded.cacheHits) / encoded.blocks;
+        }
+        return result;
+    }
+
+    void PrintResult(const Result& result) {
+        char sizeText[32];
+        std::snprintf(sizeText, sizeof(sizeText), "%ux%u", result.width, result.height);
+        std::printf("%-24s %-9s %-10s %10.2f %10.1f %10.1f %8.1f\n", result.operation.c_str(), result.content.c_str(),
+                    sizeText, result.megapixelsPerSecond, result.mbPerSecond, result.allocationsPerOp,
+                    result.poolAllocationsPerOp);
+    }
+
+    bool WriteJson(const Options& options, const std::vector<Result>& results) {
+        FILE* file = std::fopen(options.jsonPath.c_str(), "w");
+        if (!file) {
+            return false;
+        }
+
+        std::fprintf(file, "{\n");
+        std::fprintf(file, "  \"benchmark\": \"texture_bench\",\n");
+        std::fprintf(file, "  \"formatVersion\": 1,\n");
+        std::fprintf(file, "  \"minSeconds\": %.3f,\n", options.minSeconds);
+        std::fprintf(file, "  \"threads\": %u,\n", DSEngine::DSThreadPool::Global().GetThreadCount());
+        std::fprintf(file, "  \"cpu\": { \"ssse3\": %s, \"avx2\": %s, \"f16c\": %s },\n",
+                     DSEngine::DSCpu::HasSSSE3() ? "true" : "false", DSEngine::DSCpu::HasAVX2() ? "true" : "false",
+                     DSEngine::DSCpu::HasF16C() ? "true" : "false");
+        std::fprintf(file, "  \"results\": [\n");
+        for (size_t i = 0; i < results.size(); ++i) {
+            const Result& r = results[i];
+            std::fprintf(file,
+                         "    { \"operation\": \"%s\", \"content\": \"%s\", \"width\": %u, \"height\": %u, "
+                         "\"iterations\": %u, \"seconds\": %.6f, \"megapixelsPerSecond\": %.3f, \"mbPerSecond\": %.3f, "
+                         "\"allocationsPerOp\": %.2f, \"allocatedBytesPerOp\": %.0f, "
+                         "\"poolAllocationsPerOp\": %.2f, \"poolReusesPerOp\": %.2f, "
+                         "\"dxtBlocksPerOp\": %.0f, \"dxtSolidRate\": %.4f, \"dxtCacheHitRate\": %.4f }%s\n",
+                         r.operation.c_str(), r.content.c_str(), r.width, r.height, r.iterations, r.seconds,
+                         r.megapixelsPerSecond, r.mbPerSecond, r.allocationsPerOp, r.allocatedBytesPerOp,
+                         r.poolAllocationsPerOp, r.poolReusesPerOp, r.dxtBlocksPerOp, r.dxtSolidRate,
+                         r.dxtCacheHitRate, i + 1 < results.size() ? "," : "");
+        }
+        std::fprintf(file, "  ]\n}\n");
+        std::fclose(file);
+        return true;
+    }
+
+    bool ParseOptions(int argc, char** argv, Options& options) {
+        for (int i = 1; i < argc; ++i) {
+            const std::string arg = argv[i];
+            const bool hasValue = i + 1 < argc;
+            if (arg == "--min-time" && hasValue) {
+                options.minSeconds = std::atof(argv[++i]);
+            } else if (arg == "--max-iterations" && hasValue) {
+                options.maxIterations = static_cast<uint32_t>(std::atoi(argv[++i]));
+            } else if (arg == "--max-size" && hasValue) {
+                options.maxSize = static_cast<uint32_t>(std::atoi(argv[++i]));
+            } else if (arg == "--json" && hasValue) {
+                options.jsonPath = argv[++i];
+            } else if (arg == "--temp-dir" && hasValue) {
+                options.tempDir = argv[++i];
+            } else {
+                return false;
+            }
+        }
+        return options.maxIterations > 0;
+    }
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!ParseOptions(argc, argv, options)) {
+        std::fprintf(stderr, "usage: texture_bench [--min-time seconds] [--max-iterations n] [--max-size pixels]\n"
+                             "                     [--json path] [--temp-dir dir]\n");
+        return 1;
+    }
+
+    struct BenchSize {
+        uint32_t width;
+        uint32_t height;
+    };
+    const BenchSize sizes[] = { {256, 256}, {1024, 1024}, {2048, 2048}, {1000, 600} };
+    const Content contents[] = { Content::Noise, Content::Gradient, Content::Flat, Content::Alpha };
+    const std::string rawPath = options.tempDir + "/texture_bench_raw.dst";
+    const std::string lzPath = options.tempDir + "/texture_bench_lz.dst";
+
+    struct CompressCase {
+        const char* name;
+        DSTexture::Format format;
+        DSTexture::CompressionQuality quality;
+        uint32_t maxThreads;
+    };
+    const CompressCase compressCases[] = {
+        { "compress_dxt1_fast", DSTexture::Format::DXT1, DSTexture::CompressionQuality::FAST, 1 },
+        { "compress_dxt1_normal", DSTexture::Format::DXT1, DSTexture::CompressionQuality::NORMAL, 1 },
+        { "compress_dxt5_fast", DSTexture::Format::DXT5, DSTexture::CompressionQuality::FAST, 1 },
+        { "compress_dxt5_normal", DSTexture::Format::DXT5, DSTexture::CompressionQuality::NORMAL, 1 },
+        { "compress_dxt5_normal_mt", DSTexture::Format::DXT5, DSTexture::CompressionQuality::NORMAL, 0 },
+        { "compress_bc4_fast", DSTexture::Format::BC4, DSTexture::CompressionQuality::FAST, 1 },
+        { "compress_bc4_normal", DSTexture::Format::BC4, DSTexture::CompressionQuality::NORMAL, 1 },
+        { "compress_bc5_normal", DSTexture::Format::BC5, DSTexture::CompressionQuality::NORMAL, 1 },
+    };
+
+    struct DecompressCase {
+        const char* name;
+        DSTexture::Format format;
+    };
+    const DecompressCase decompressCases[] = {
+        { "decompress_dxt1", DSTexture::Format::DXT1 },
+        { "decompress_dxt5", DSTexture::Format::DXT5 },
+        { "decompress_bc4", DSTexture::Format::BC4 },
+        { "decompress_bc5", DSTexture::Format::BC5 },
+    };
+
+    std::printf("%-24s %-9s %-10s %10s %10s %10s %8s\n", "operation", "content", "size", "MPix/s", "MB/s",
+                "allocs/op", "pool/op");
+
+    std::vector<Result> results;
+    auto run = [&](const char* operation, Content content, const BenchSize& size,
+                   const std::function<void()>& setup, const std::function<bool()>& op) {
+        results.push_back(Measure(options, operation, content, size.width, size.height, setup, op));
+        PrintResult(results.back());
+    };
+
+    for (const BenchSize& size : sizes) {
+        if (size.width > options.maxSize || size.height > options.maxSize) continue;
+
+        for (Content content : contents) {
+            const std::vector<uint8_t> rgba = MakeImage(content, size.width, size.height);
+            const size_t pixelCount = static_cast<size_t>(size.width) * size.height;
+            std::vector<uint8_t> rgb(pixelCount * 3);
+            DSPixelConverter::RGBA8ToRGB8(rgba.data(), rgb.data(), pixelCount);
+
+            std::unique_ptr<DSTexture> texture;
+            auto createRGBA8 = [&]() {
+                texture = DSTexture::CreateFromMemory(rgba.data(), size.width, size.height, DSTexture::Format::RGBA8);
+            };
+
+            // Compression of the base level
+            for (const CompressCase& c : compressCases) {
+                run(c.name, content, size, createRGBA8,
+                    [&]() { return texture->Compress(c.format, c.quality, c.maxThreads); });
+            }
+
+            // Decompression of the base level
+            for (const DecompressCase& c : decompressCases) {
+                auto createCompressed = [&]() {
+                    createRGBA8();
+                    texture->Compress(c.format, DSTexture::CompressionQuality::FAST);
+                };
+                run(c.name, content, size, createCompressed, [&]() { return texture->Decompress(); });
+            }
+
+            // CPU reads of a DXT5 texture without decompressing it, one sample per texel in scan order
+            std::vector<float> sampleU(pixelCount), sampleV(pixelCount), samples(pixelCount * 4);
+            for (size_t i = 0; i < pixelCount; ++i) {
+                sampleU[i] = (i % size.width + 0.5f) / size.width;
+                sampleV[i] = (i / size.width + 0.5f) / size.height;
+            }
+            auto createDXT5 = [&]() {
+                createRGBA8();
+                texture->Compress(DSTexture::Format::DXT5, DSTexture::CompressionQuality::FAST);
+            };
+            run("sample_point_dxt5", content, size, createDXT5, [&]() {
+                DSEngine::DSTextureSampler sampler(*texture);
+                sampler.SamplePoint(sampleU.data(), sampleV.data(), pixelCount, samples.data());
+                return true;
+            });
+            run("sample_bilinear_dxt5", content, size, createDXT5, [&]() {
+                DSEngine::DSTextureSampler sampler(*texture);
+                sampler.SampleBilinear(sampleU.data(), sampleV.data(), pixelCount, samples.data());
+                return true;
+            });
+
+            // Mip chain generation
+            DSEngine::DSMipGenerator::Settings boxSettings;
+            DSEngine::DSMipGenerator::Settings kaiserSettings;
+            kaiserSettings.filter = DSEngine::DSMipGenerator::Filter::Kaiser;
+            kaiserSettings.sRGB = true;
+            run("mips_box", content, size, createRGBA8, [&]() { return texture->GenerateMipmaps(boxSettings); });
+            run("mips_kaiser_srgb", content, size, createRGBA8, [&]() { return texture->GenerateMipmaps(kaiserSettings); });
+
+            // Format conversions, the kernels DSTexture uses for RGB8 <-> RGBA8
+            std::vector<uint8_t> converted(pixelCount * 4);
+            run("convert_rgb8_to_rgba8", content, size, []() {}, [&]() {
+                DSPixelConverter::RGB8ToRGBA8(rgb.data(), converted.data(), pixelCount);
+                return true;
+            });
+            run("convert_rgba8_to_rgb8", content, size, []() {}, [&]() {
+                DSPixelConverter::RGBA8ToRGB8(rgba.data(), converted.data(), pixelCount);
+                return true;
+            });
+
+            // HDR: the same image scaled to [0, 16], float kernels per path and mips on the float formats
+            std::vector<float> hdr(pixelCount * 4);
+            for (size_t i = 0; i < hdr.size(); ++i) {
+                hdr[i] = rgba[i] * (16.0f / 255.0f);
+            }
+            std::vector<uint16_t> half(pixelCount * 4);
+            std::vector<uint32_t> packed(pixelCount);
+            DSFloatConverter::FloatToHalf(hdr.data(), half.data(), hdr.size());
+            DSFloatConverter::RGBA32FToR11G11B10F(hdr.data(), packed.data(), pixelCount);
+
+            struct FloatCase {
+                const char* name;
+                bool half;  // FloatToHalf, RGBA32FToR11G11B10F otherwise
+                DSFloatConverter::Path path;
+            };
+            const FloatCase floatCases[] = {
+                { "convert_f16_scalar", true, DSFloatConverter::Path::Scalar },
+                { "convert_f16_f16c", true, DSFloatConverter::Path::F16C },
+                { "convert_r11g11b10_scalar", false, DSFloatConverter::Path::Scalar },
+                { "convert_r11g11b10_sse2", false, DSFloatConverter::Path::SSE2 },
+            };
+            for (const FloatCase& c : floatCases) {
+                run(c.name, content, size, []() {}, [&]() {
+                    if (c.half) {
+                        DSFloatConverter::FloatToHalf(hdr.data(), half.data(), hdr.size(), c.path);
+                    } else {
+                        DSFloatConverter::RGBA32FToR11G11B10F(hdr.data(), packed.data(), pixelCount, c.path);
+                    }
+                    return true;
+                });
+            }
+
+            auto createRGBA16F = [&]() {
+                texture = DSTexture::CreateFromMemory(reinterpret_cast<const uint8_t*>(half.data()), size.width,
+                                                      size.height, DSTexture::Format::RGBA16F);
+            };
+            auto createR11G11B10F = [&]() {
+                texture = DSTexture::CreateFromMemory(reinterpret_cast<const uint8_t*>(packed.data()), size.width,
+                                                      size.height, DSTexture::Format::R11G11B10F);
+            };
+            run("mips_box_rgba16f", content, size, createRGBA16F, [&]() { return texture->GenerateMipmaps(boxSettings); });
+            run("mips_box_r11g11b10f", content, size, createR11G11B10F,
+                [&]() { return texture->GenerateMipmaps(boxSettings); });
+
+            // Save and load of a shipping texture: DXT5 with mips, raw and LZ payloads
+            createRGBA8();
+            texture->GenerateMipmaps();
+            texture->Compress(DSTexture::Format::DXT5, DSTexture::CompressionQuality::FAST, 0);
+            const std::unique_ptr<DSTexture> shipping = std::move(texture);
+
+            run("save_raw", content, size, []() {},
+                [&]() { return shipping->SaveToFile(rawPath, DSTexture::FileCompression::NONE); });
+            run("save_lz", content, size, []() {},
+                [&]() { return shipping->SaveToFile(lzPath, DSTexture::FileCompression::LZ); });
+
+            auto createEmpty = [&]() { texture = std::make_unique<DSTexture>(); };
+            run("load_raw", content, size, createEmpty, [&]() { return texture->LoadFromFile(rawPath); });
+            run("load_lz", content, size, createEmpty, [&]() { return texture->LoadFromFile(lzPath); });
+            texture.reset();
+        }
+    }
+
+    std::remove(rawPath.c_str());
+    std::remove(lzPath.c_str());
+
+    if (!WriteJson(options, results)) {
+        std::fprintf(stderr, "Failed to write %s\n", options.jsonPath.c_str());
+        return 1;
+    }
+    std::printf("Results written to %s\n", options.jsonPath.c_str());
+    return 0;
+}
@@ -0,0 +1,143 @@
+#include "DSBufferPool.h"
+#include <iterator>
+#include <new>
+#include <utility>
+
+namespace DSEngine {
+    namespace {
+        // Pooled buffers can serve requests up to this much smaller than their capacity
+        const size_t MAX_SLACK_DIVISOR = 2;
+        const size_t GRANULARITY = 4096;
+
+        uint8_t* AllocateAligned(size_t capacity) {
+            return static_cast<uint8_t*>(::operator new(capacity, std::align_val_t(DSBufferPool::ALIGNMENT)));
+        }
+
+        void FreeAligned(uint8_t* buffer) {
+            ::operator delete(buffer, std::align_val_t(DSBufferPool::ALIGNMENT));
+        }
+    }
+
+    // =====================
+    // Buffer
+    // =====================
+
+    DSBufferPool::Buffer::Buffer(size_t size) {
+        Resize(size);
+    }
+
+    DSBufferPool::Buffer::~Buffer() {
+        Reset();
+    }
+
+    DSBufferPool::Buffer::Buffer(Buffer&& other) noexcept
+        : m_data(other.m_data), m_size(other.m_size), m_capacity(other.m_capacity) {
+        other.m_data = nullptr;
+        other.m_size = 0;
+        other.m_capacity = 0;
+    }
+
+    DSBufferPool::Buffer& DSBufferPool::Buffer::operator=(Buffer&& other) noexcept {
+        if (this != &other) {
+            Reset();
+            std::swap(m_data, other.m_data);
+            std::swap(m_size, other.m_size);
+            std::swap(m_capacity, other.m_capacity);
+        }
+        return *this;
+    }
+
+    void DSBufferPool::Buffer::Resize(size_t size) {
+        if (size > m_capacity) {
+            Reset();
+            m_data = DSBufferPool::Global().Acquire(size, m_capacity);
+        }
+        m_size = size;
+    }
+
+    void DSBufferPool::Buffer::Reset() {
+        if (m_data) {
+            DSBufferPool::Global().Release(m_data, m_capacity);
+        }
+        m_data = nullptr;
+        m_size = 0;
+        m_capacity = 0;
+    }
+
+    // =====================
+    // Pool
+    // =====================
+
+    DSBufferPool& DSBufferPool::Global() {
+        // Never destroyed, static objects may still release buffers at exit
+        static DSBufferPool* pool = new DSBufferPool();
+        return *pool;
+    }
+
+    DSBufferPool::~DSBufferPool() {
+        Trim();
+    }
+
+    uint8_t* DSBufferPool::Acquire(size_t size, size_t& capacity) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            // Smallest pooled buffer that fits without wasting too much
+            auto it = m_free.lower_bound(size);
+            if (it != m_free.end() && it->first <= size + size / MAX_SLACK_DIVISOR + GRANULARITY) {
+                capacity = it->first;
+                uint8_t* buffer = it->second;
+                m_free.erase(it);
+                m_stats.pooledBytes -= capacity;
+                m_stats.reuses++;
+                return buffer;
+            }
+            m_stats.allocations++;
+        }
+
+        capacity = (size + GRANULARITY - 1) / GRANULARITY * GRANULARITY;
+        if (capacity == 0) capacity = GRANULARITY;
+        return AllocateAligned(capacity);
+    }
+
+    void DSBufferPool::Release(uint8_t* buffer, size_t capacity) {
+        if (!buffer) return;
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_stats.pooledBytes + capacity <= m_maxPooledBytes) {
+                m_free.emplace(capacity, buffer);
+                m_stats.pooledBytes += capacity;
+                return;
+            }
+        }
+        FreeAligned(buffer);
+    }
+
+    void DSBufferPool::SetMaxPooledBytes(size_t bytes) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_maxPooledBytes = bytes;
+
+        // Free the largest buffers first until under the new limit
+        while (m_stats.pooledBytes > m_maxPooledBytes) {
+            auto it = std::prev(m_free.end());
+            m_stats.pooledBytes -= it->first;
+            FreeAligned(it->second);
+            m_free.erase(it);
+        }
+    }
+
+    void DSBufferPool::Trim() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (auto& entry : m_free) {
+            FreeAligned(entry.second);
+        }
+        m_free.clear();
+        m_stats.pooledBytes = 0;
+    }
+
+    DSBufferPool::Stats DSBufferPool::GetStats() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_stats;
+    }
+}
@@ -0,0 +1,81 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <map>
+#include <mutex>
+
+namespace DSEngine {
+    /**
+     * Thread safe pool of aligned byte buffers, used for texture storage and conversion scratch
+     * memory so repeated loads and conversions don't go back to the allocator every time.
+     * Released buffers are kept up to a byte limit, beyond it they are freed.
+     */
+    class DSBufferPool {
+    public:
+        static const size_t ALIGNMENT = 64;
+
+        /**
+         * Move-only handle to a pooled buffer, the memory goes back to the pool when it is destroyed.
+         */
+        class Buffer {
+        public:
+            Buffer() = default;
+            explicit Buffer(size_t size);
+            ~Buffer();
+
+            Buffer(Buffer&& other) noexcept;
+            Buffer& operator=(Buffer&& other) noexcept;
+            Buffer(const Buffer&) = delete;
+            Buffer& operator=(const Buffer&) = delete;
+
+            // Contents are undefined after a resize that needs more capacity
+            void Resize(size_t size);
+            void Reset();
+
+            uint8_t* Data() const { return m_data; }
+            size_t Size() const { return m_size; }
+            size_t Capacity() const { return m_capacity; }
+
+        private:
+            uint8_t* m_data = nullptr;
+            size_t m_size = 0;
+            size_t m_capacity = 0;
+        };
+
+        struct Stats {
+            uint64_t allocations = 0;  // Buffers taken from the system allocator
+            uint64_t reuses = 0;       // Buffers served from the pool
+            size_t pooledBytes = 0;    // Bytes currently held by the pool
+        };
+
+        /**
+         * Returns the engine wide pool.
+         */
+        static DSBufferPool& Global();
+
+        ~DSBufferPool();
+
+        /**
+         * Returns a buffer of at least size bytes, aligned to ALIGNMENT.
+         *
+         * @param size Requested size, may be 0.
+         * @param capacity Receives the real size of the buffer, pass it back to Release.
+         */
+        uint8_t* Acquire(size_t size, size_t& capacity);
+        void Release(uint8_t* buffer, size_t capacity);
+
+        void SetMaxPooledBytes(size_t bytes);
+        size_t GetMaxPooledBytes() const { return m_maxPooledBytes; }
+
+        // Frees every pooled buffer
+        void Trim();
+
+        Stats GetStats();
+
+    private:
+        std::mutex m_mutex;
+        std::multimap<size_t, uint8_t*> m_free;  // Capacity -> buffer
+        size_t m_maxPooledBytes = 64 * 1024 * 1024;
+        Stats m_stats;
+    };
+}
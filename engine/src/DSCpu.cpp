@@ -0,0 +1,68 @@
+#include "DSCpu.h"
+#include <cstdint>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+
+namespace DSEngine {
+    namespace {
+        void CpuId(uint32_t leaf, uint32_t subLeaf, uint32_t regs[4]) {
+#if defined(_MSC_VER)
+            int info[4];
+            __cpuidex(info, static_cast<int>(leaf), static_cast<int>(subLeaf));
+            for (int i = 0; i < 4; i++) regs[i] = static_cast<uint32_t>(info[i]);
+#else
+            __cpuid_count(leaf, subLeaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+        }
+
+        uint64_t ReadXCR0() {
+#if defined(_MSC_VER)
+            return _xgetbv(0);
+#else
+            uint32_t eax, edx;
+            __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+            return (static_cast<uint64_t>(edx) << 32) | eax;
+#endif
+        }
+    }
+
+    const DSCpu::Features& DSCpu::GetFeatures() {
+        static const Features features = []() {
+            Features result;
+            uint32_t regs[4];
+
+            CpuId(0, 0, regs);
+            const uint32_t maxLeaf = regs[0];
+
+            CpuId(1, 0, regs);
+            const uint32_t ecx = regs[2];
+            result.ssse3 = (ecx & (1u << 9)) != 0;
+            result.sse41 = (ecx & (1u << 19)) != 0;
+
+            // AVX state must also be enabled by the OS (OSXSAVE + XMM/YMM in XCR0)
+            const bool osxsave = (ecx & (1u << 27)) != 0;
+            const bool osAvx = osxsave && (ReadXCR0() & 0x6) == 0x6;
+            result.avx = osAvx && (ecx & (1u << 28)) != 0;
+            result.fma = result.avx && (ecx & (1u << 12)) != 0;
+            result.f16c = result.avx && (ecx & (1u << 29)) != 0;
+
+            if (maxLeaf >= 7) {
+                CpuId(7, 0, regs);
+                result.avx2 = result.avx && (regs[1] & (1u << 5)) != 0;
+            }
+            return result;
+        }();
+        return features;
+    }
+
+    bool DSCpu::HasSSSE3() { return GetFeatures().ssse3; }
+    bool DSCpu::HasSSE41() { return GetFeatures().sse41; }
+    bool DSCpu::HasAVX() { return GetFeatures().avx; }
+    bool DSCpu::HasAVX2() { return GetFeatures().avx2; }
+    bool DSCpu::HasFMA() { return GetFeatures().fma; }
+    bool DSCpu::HasF16C() { return GetFeatures().f16c; }
+}
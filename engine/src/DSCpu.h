@@ -0,0 +1,37 @@
+#pragma once
+
+// Compiles a single function for an instruction set the rest of the engine does not assume.
+// Callers must check the matching DSCpu::Has* before calling such a function.
+#if defined(_MSC_VER) && !defined(__clang__)
+#define DS_TARGET(x)
+#else
+#define DS_TARGET(x) __attribute__((target(x)))
+#endif
+
+namespace DSEngine {
+    /**
+     * Runtime detection of the instruction sets available on the running CPU.
+     * Results are computed once and cached.
+     */
+    class DSCpu {
+    public:
+        static bool HasSSSE3();
+        static bool HasSSE41();
+        static bool HasAVX();
+        static bool HasAVX2();
+        static bool HasFMA();
+        static bool HasF16C();
+
+    private:
+        struct Features {
+            bool ssse3 = false;
+            bool sse41 = false;
+            bool avx = false;
+            bool avx2 = false;
+            bool fma = false;
+            bool f16c = false;
+        };
+
+        static const Features& GetFeatures();
+    };
+}
@@ -0,0 +1,469 @@
+#include "DSDXTDecoder.h"
+#include "DSCpu.h"
+#include <immintrin.h>
+#include <algorithm>
+#include <cstring>
+
+namespace DSEngine {
+    namespace {
+        // Texels are handled as packed RGBA (R in the low byte), matching the memory layout of RGBA8.
+        inline uint32_t PackRGBA(uint32_t r, uint32_t g, uint32_t b, uint32_t a) {
+            return r | (g << 8) | (b << 16) | (a << 24);
+        }
+
+        inline void Unpack565(uint16_t color, uint32_t& r, uint32_t& g, uint32_t& b) {
+            r = (color >> 11) & 0x1F;
+            g = (color >> 5) & 0x3F;
+            b = color & 0x1F;
+
+            // Scale up to 8 bits
+            r = (r << 3) | (r >> 2);
+            g = (g << 2) | (g >> 4);
+            b = (b << 3) | (b >> 2);
+        }
+
+        // DXT5 color blocks always use the four color mode, only DXT1 has the three color + transparent mode
+        void BuildColorPalette(const uint8_t* block, bool allowThreeColor, uint32_t palette[4]) {
+            uint16_t color0 = block[0] | (block[1] << 8);
+            uint16_t color1 = block[2] | (block[3] << 8);
+
+            uint32_t r0, g0, b0, r1, g1, b1;
+            Unpack565(color0, r0, g0, b0);
+            Unpack565(color1, r1, g1, b1);
+
+            palette[0] = PackRGBA(r0, g0, b0, 255);
+            palette[1] = PackRGBA(r1, g1, b1, 255);
+
+            if (color0 > color1 || !allowThreeColor) {
+                palette[2] = PackRGBA((2 * r0 + r1) / 3, (2 * g0 + g1) / 3, (2 * b0 + b1) / 3, 255);
+                palette[3] = PackRGBA((r0 + 2 * r1) / 3, (g0 + 2 * g1) / 3, (b0 + 2 * b1) / 3, 255);
+            } else {
+                palette[2] = PackRGBA((r0 + r1) / 2, (g0 + g1) / 2, (b0 + b1) / 2, 255);
+                palette[3] = 0; // Transparent black
+            }
+        }
+
+        void BuildAlphaPalette(const uint8_t* block, uint32_t alphaValues[8]) {
+            uint32_t alpha0 = block[0];
+            uint32_t alpha1 = block[1];
+
+            alphaValues[0] = alpha0;
+            alphaValues[1] = alpha1;
+
+            if (alpha0 > alpha1) {
+                alphaValues[2] = (6 * alpha0 + 1 * alpha1) / 7;
+                alphaValues[3] = (5 * alpha0 + 2 * alpha1) / 7;
+                alphaValues[4] = (4 * alpha0 + 3 * alpha1) / 7;
+                alphaValues[5] = (3 * alpha0 + 4 * alpha1) / 7;
+                alphaValues[6] = (2 * alpha0 + 5 * alpha1) / 7;
+                alphaValues[7] = (1 * alpha0 + 6 * alpha1) / 7;
+            } else {
+                alphaValues[2] = (4 * alpha0 + 1 * alpha1) / 5;
+                alphaValues[3] = (3 * alpha0 + 2 * alpha1) / 5;
+                alphaValues[4] = (2 * alpha0 + 3 * alpha1) / 5;
+                alphaValues[5] = (1 * alpha0 + 4 * alpha1) / 5;
+                alphaValues[6] = 0x00;
+                alphaValues[7] = 0xFF;
+            }
+        }
+
+        // 16 3-bit indices, texel i uses bits [3i, 3i+3)
+        inline uint64_t ReadAlphaIndices(const uint8_t* block) {
+            uint64_t bits = 0;
+            for (int i = 5; i >= 0; i--) {
+                bits = (bits << 8) | block[2 + i];
+            }
+            return bits;
+        }
+
+        inline uint32_t ReadColorIndices(const uint8_t* colorBlock) {
+            return colorBlock[4] | (colorBlock[5] << 8) | (colorBlock[6] << 16) | (static_cast<uint32_t>(colorBlock[7]) << 24);
+        }
+
+        void DecodeBlockScalar(const uint8_t* block, bool dxt5, uint32_t texels[16]) {
+            const uint8_t* colorBlock = dxt5 ? block + 8 : block;
+
+            uint32_t palette[4];
+            BuildColorPalette(colorBlock, !dxt5, palette);
+            uint32_t indices = ReadColorIndices(colorBlock);
+
+            for (int i = 0; i < 16; i++) {
+                texels[i] = palette[(indices >> (2 * i)) & 0x03];
+            }
+
+            if (dxt5) {
+                uint32_t alphaValues[8];
+                BuildAlphaPalette(block, alphaValues);
+                uint64_t alphaIndices = ReadAlphaIndices(block);
+
+                for (int i = 0; i < 16; i++) {
+                    uint32_t alpha = alphaValues[(alphaIndices >> (3 * i)) & 0x07];
+                    texels[i] = (texels[i] & 0x00FFFFFF) | (alpha << 24);
+                }
+            }
+        }
+
+        void WriteBlock(const uint32_t texels[16], uint8_t* dest, size_t destStride,
+                        uint32_t pixelSize, uint32_t cols, uint32_t rows) {
+            for (uint32_t y = 0; y < rows; y++) {
+                uint8_t* pixel = dest + y * destStride;
+                for (uint32_t x = 0; x < cols; x++) {
+                    uint32_t texel = texels[y * 4 + x];
+                    pixel[0] = texel & 0xFF;         // R
+                    pixel[1] = (texel >> 8) & 0xFF;  // G
+                    pixel[2] = (texel >> 16) & 0xFF; // B
+                    if (pixelSize == 4) {
+                        pixel[3] = texel >> 24;      // A
+                    }
+                    pixel += pixelSize;
+                }
+            }
+        }
+
+        // Decodes blocks [firstBlock, blocksWide) of a row, clipping against the image edges
+        void DecodeRowScalar(const uint8_t* blocks, uint32_t firstBlock, uint32_t width, uint32_t rows,
+                             uint8_t* dest, size_t destStride, bool dxt5) {
+            const uint32_t blocksWide = (width + 3) / 4;
+            const uint32_t blockSize = dxt5 ? 16 : 8;
+            const uint32_t pixelSize = dxt5 ? 4 : 3;
+
+            for (uint32_t bx = firstBlock; bx < blocksWide; bx++) {
+                uint32_t texels[16];
+                DecodeBlockScalar(blocks + bx * blockSize, dxt5, texels);
+
+                uint32_t cols = std::min(4u, width - bx * 4);
+                WriteBlock(texels, dest + bx * 4 * pixelSize, destStride, pixelSize, cols, rows);
+            }
+        }
+
+        // BC4 (channels 1) or BC5 (channels 2), each channel is a DXT5 alpha block
+        void DecodeChannelRowScalar(const uint8_t* blocks, uint32_t width, uint32_t rows,
+                                    uint8_t* dest, size_t destStride, uint32_t channels) {
+            const uint32_t blocksWide = (width + 3) / 4;
+
+            for (uint32_t bx = 0; bx < blocksWide; bx++) {
+                const uint32_t cols = std::min(4u, width - bx * 4);
+                for (uint32_t c = 0; c < channels; c++) {
+                    const uint8_t* block = blocks + (bx * channels + c) * 8;
+                    uint32_t values[8];
+                    BuildAlphaPalette(block, values);
+                    const uint64_t indices = ReadAlphaIndices(block);
+
+                    for (uint32_t y = 0; y < rows; y++) {
+                        uint8_t* pixel = dest + y * destStride + bx * 4 * channels + c;
+                        for (uint32_t x = 0; x < cols; x++) {
+                            pixel[x * channels] = static_cast<uint8_t>(values[(indices >> (3 * (y * 4 + x))) & 0x07]);
+                        }
+                    }
+                }
+            }
+        }
+
+        // =====================
+        // SSE2
+        // =====================
+
+        // Picks palette[index] for 4 texels of a pixel row. rowBits holds the 4 2-bit indices of the row.
+        inline __m128i SelectTexelsSSE2(const __m128i palette[4], uint32_t rowBits) {
+            const __m128i fieldMask = _mm_setr_epi32(0x03, 0x0C, 0x30, 0xC0);
+            const __m128i fields = _mm_and_si128(_mm_set1_epi32(static_cast<int>(rowBits)), fieldMask);
+
+            __m128i result = _mm_setzero_si128();
+            for (int k = 0; k < 4; k++) {
+                const __m128i key = _mm_setr_epi32(k, k << 2, k << 4, k << 6);
+                const __m128i match = _mm_cmpeq_epi32(fields, key);
+                result = _mm_or_si128(result, _mm_and_si128(match, palette[k]));
+            }
+            return result;
+        }
+
+        // Packs 4 RGBA texels into 12 bytes of RGB
+        inline void StoreRGB4SSE2(uint8_t* dest, __m128i texels) {
+            // Per 64 bit lane: RGB of the low texel in bytes 0-2, RGB of the high texel in bytes 3-5
+            const __m128i lowMask = _mm_set1_epi64x(0x0000000000FFFFFFll);
+            const __m128i highMask = _mm_set1_epi64x(0x0000FFFFFF000000ll);
+            __m128i packed = _mm_or_si128(_mm_and_si128(texels, lowMask),
+                                          _mm_and_si128(_mm_srli_epi64(texels, 8), highMask));
+
+            alignas(16) uint8_t bytes[16];
+            _mm_store_si128(reinterpret_cast<__m128i*>(bytes), packed);
+            std::memcpy(dest, bytes, 6);
+            std::memcpy(dest + 6, bytes + 8, 6);
+        }
+
+        void DecodeDXT1RowSSE2(const uint8_t* blocks, uint32_t width, uint32_t rows, uint8_t* dest, size_t destStride) {
+            const uint32_t fullBlocks = (rows == 4) ? width / 4 : 0;
+
+            for (uint32_t bx = 0; bx < fullBlocks; bx++) {
+                const uint8_t* block = blocks + bx * 8;
+
+                uint32_t colors[4];
+                BuildColorPalette(block, true, colors);
+                const __m128i palette[4] = {
+                    _mm_set1_epi32(static_cast<int>(colors[0])), _mm_set1_epi32(static_cast<int>(colors[1])),
+                    _mm_set1_epi32(static_cast<int>(colors[2])), _mm_set1_epi32(static_cast<int>(colors[3]))
+                };
+
+                uint8_t* output = dest + bx * 12;
+                for (int y = 0; y < 4; y++) {
+                    StoreRGB4SSE2(output + y * destStride, SelectTexelsSSE2(palette, block[4 + y]));
+                }
+            }
+
+            DecodeRowScalar(blocks, fullBlocks, width, rows, dest, destStride, false);
+        }
+
+        void DecodeDXT5RowSSE2(const uint8_t* blocks, uint32_t width, uint32_t rows, uint8_t* dest, size_t destStride) {
+            const uint32_t fullBlocks = (rows == 4) ? width / 4 : 0;
+
+            for (uint32_t bx = 0; bx < fullBlocks; bx++) {
+                const uint8_t* block = blocks + bx * 16;
+
+                uint32_t colors[4];
+                BuildColorPalette(block + 8, false, colors);
+                const __m128i palette[4] = {
+                    _mm_set1_epi32(static_cast<int>(colors[0] & 0x00FFFFFF)), _mm_set1_epi32(static_cast<int>(colors[1] & 0x00FFFFFF)),
+                    _mm_set1_epi32(static_cast<int>(colors[2] & 0x00FFFFFF)), _mm_set1_epi32(static_cast<int>(colors[3] & 0x00FFFFFF))
+                };
+
+                uint32_t alphaValues[8];
+                BuildAlphaPalette(block, alphaValues);
+                uint64_t alphaIndices = ReadAlphaIndices(block);
+
+                uint8_t* output = dest + bx * 16;
+                for (int y = 0; y < 4; y++) {
+                    const uint32_t rowAlpha = static_cast<uint32_t>(alphaIndices >> (12 * y));
+                    const __m128i alpha = _mm_setr_epi32(
+                        static_cast<int>(alphaValues[rowAlpha & 0x07] << 24),
+                        static_cast<int>(alphaValues[(rowAlpha >> 3) & 0x07] << 24),
+                        static_cast<int>(alphaValues[(rowAlpha >> 6) & 0x07] << 24),
+                        static_cast<int>(alphaValues[(rowAlpha >> 9) & 0x07] << 24));
+
+                    const __m128i texels = _mm_or_si128(SelectTexelsSSE2(palette, block[12 + y]), alpha);
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(output + y * destStride), texels);
+                }
+            }
+
+            DecodeRowScalar(blocks, fullBlocks, width, rows, dest, destStride, true);
+        }
+
+        // =====================
+        // AVX2, two blocks per step: block A in lanes 0-3, block B in lanes 4-7
+        // =====================
+
+        DS_TARGET("avx2")
+        inline __m256i LoadPalettePairAVX2(const uint32_t a[4], const uint32_t b[4]) {
+            const __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a));
+            const __m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b));
+            return _mm256_inserti128_si256(_mm256_castsi128_si256(low), high, 1);
+        }
+
+        // Color index of every texel of pixel row y for both blocks, already offset into the palette pair
+        DS_TARGET("avx2")
+        inline __m256i ColorIndicesAVX2(__m256i indexWords, int y) {
+            const __m256i shifts = _mm256_add_epi32(_mm256_setr_epi32(0, 2, 4, 6, 0, 2, 4, 6), _mm256_set1_epi32(8 * y));
+            const __m256i indices = _mm256_and_si256(_mm256_srlv_epi32(indexWords, shifts), _mm256_set1_epi32(0x03));
+            return _mm256_add_epi32(indices, _mm256_setr_epi32(0, 0, 0, 0, 4, 4, 4, 4));
+        }
+
+        DS_TARGET("avx2")
+        void DecodeDXT1RowAVX2(const uint8_t* blocks, uint32_t width, uint32_t rows, uint8_t* dest, size_t destStride) {
+            const uint32_t fullBlocks = (rows == 4) ? width / 4 : 0;
+            const __m256i packRGB = _mm256_setr_epi8(
+                0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1,
+                0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+
+            uint32_t bx = 0;
+            for (; bx + 2 <= fullBlocks; bx += 2) {
+                const uint8_t* blockA = blocks + bx * 8;
+                const uint8_t* blockB = blockA + 8;
+
+                uint32_t colorsA[4], colorsB[4];
+                BuildColorPalette(blockA, true, colorsA);
+                BuildColorPalette(blockB, true, colorsB);
+                const __m256i palette = LoadPalettePairAVX2(colorsA, colorsB);
+
+                const uint32_t indicesA = ReadColorIndices(blockA);
+                const uint32_t indicesB = ReadColorIndices(blockB);
+                const __m256i words = _mm256_inserti128_si256(
+                    _mm256_castsi128_si256(_mm_set1_epi32(static_cast<int>(indicesA))),
+                    _mm_set1_epi32(static_cast<int>(indicesB)), 1);
+
+                uint8_t* output = dest + bx * 12;
+                for (int y = 0; y < 4; y++) {
+                    const __m256i texels = _mm256_permutevar8x32_epi32(palette, ColorIndicesAVX2(words, y));
+                    const __m256i packed = _mm256_shuffle_epi8(texels, packRGB);
+
+                    // 12 bytes of block A followed by 12 bytes of block B
+                    alignas(32) uint8_t bytes[32];
+                    _mm256_store_si256(reinterpret_cast<__m256i*>(bytes), packed);
+                    uint8_t* row = output + y * destStride;
+                    std::memcpy(row, bytes, 12);
+                    std::memcpy(row + 12, bytes + 16, 12);
+                }
+            }
+
+            if (bx < fullBlocks) {
+                // Odd block left, let the SSE2 kernel finish the row
+                DecodeDXT1RowSSE2(blocks + bx * 8, width - bx * 4, rows, dest + bx * 12, destStride);
+                return;
+            }
+            DecodeRowScalar(blocks, fullBlocks, width, rows, dest, destStride, false);
+        }
+
+        DS_TARGET("avx2")
+        void DecodeDXT5RowAVX2(const uint8_t* blocks, uint32_t width, uint32_t rows, uint8_t* dest, size_t destStride) {
+            const uint32_t fullBlocks = (rows == 4) ? width / 4 : 0;
+            const __m256i alphaShifts = _mm256_setr_epi32(0, 3, 6, 9, 0, 3, 6, 9);
+
+            uint32_t bx = 0;
+            for (; bx + 2 <= fullBlocks; bx += 2) {
+                const uint8_t* blockA = blocks + bx * 16;
+                const uint8_t* blockB = blockA + 16;
+
+                uint32_t colorsA[4], colorsB[4];
+                BuildColorPalette(blockA + 8, false, colorsA);
+                BuildColorPalette(blockB + 8, false, colorsB);
+                const __m256i palette = _mm256_and_si256(LoadPalettePairAVX2(colorsA, colorsB), _mm256_set1_epi32(0x00FFFFFF));
+
+                const uint32_t indicesA = ReadColorIndices(blockA + 8);
+                const uint32_t indicesB = ReadColorIndices(blockB + 8);
+                const __m256i words = _mm256_inserti128_si256(
+                    _mm256_castsi128_si256(_mm_set1_epi32(static_cast<int>(indicesA))),
+                    _mm_set1_epi32(static_cast<int>(indicesB)), 1);
+
+                uint32_t alphaA[8], alphaB[8];
+                BuildAlphaPalette(blockA, alphaA);
+                BuildAlphaPalette(blockB, alphaB);
+                const __m256i alphaPaletteA = _mm256_slli_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(alphaA)), 24);
+                const __m256i alphaPaletteB = _mm256_slli_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(alphaB)), 24);
+                const uint64_t alphaIndicesA = ReadAlphaIndices(blockA);
+                const uint64_t alphaIndicesB = ReadAlphaIndices(blockB);
+
+                uint8_t* output = dest + bx * 16;
+                for (int y = 0; y < 4; y++) {
+                    const __m256i texels = _mm256_permutevar8x32_epi32(palette, ColorIndicesAVX2(words, y));
+
+                    // 12 index bits per pixel row
+                    const __m256i alphaWords = _mm256_inserti128_si256(
+                        _mm256_castsi128_si256(_mm_set1_epi32(static_cast<int>((alphaIndicesA >> (12 * y)) & 0xFFF))),
+                        _mm_set1_epi32(static_cast<int>((alphaIndicesB >> (12 * y)) & 0xFFF)), 1);
+                    const __m256i alphaIdx = _mm256_and_si256(_mm256_srlv_epi32(alphaWords, alphaShifts), _mm256_set1_epi32(0x07));
+                    const __m256i alpha = _mm256_blend_epi32(
+                        _mm256_permutevar8x32_epi32(alphaPaletteA, alphaIdx),
+                        _mm256_permutevar8x32_epi32(alphaPaletteB, alphaIdx), 0xF0);
+
+                    _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + y * destStride), _mm256_or_si256(texels, alpha));
+                }
+            }
+
+            if (bx < fullBlocks) {
+                DecodeDXT5RowSSE2(blocks + bx * 16, width - bx * 4, rows, dest + bx * 16, destStride);
+                return;
+            }
+            DecodeRowScalar(blocks, fullBlocks, width, rows, dest, destStride, true);
+        }
+
+        DSDXTDecoder::Path ResolvePath(DSDXTDecoder::Path path) {
+            if (path == DSDXTDecoder::Path::Auto) {
+                return DSDXTDecoder::GetBestPath();
+            }
+            if (path == DSDXTDecoder::Path::AVX2 && !DSCpu::HasAVX2()) {
+                return DSDXTDecoder::Path::SSE2;
+            }
+            return path;
+        }
+    }
+
+    void DSDXTDecoder::DecodeDXT1Row(const uint8_t* blocks, uint32_t width, uint32_t rows,
+                                     uint8_t* dest, size_t destStride, Path path) {
+        switch (ResolvePath(path)) {
+            case Path::AVX2: DecodeDXT1RowAVX2(blocks, width, rows, dest, destStride); break;
+            case Path::SSE2: DecodeDXT1RowSSE2(blocks, width, rows, dest, destStride); break;
+            default: DecodeRowScalar(blocks, 0, width, rows, dest, destStride, false); break;
+        }
+    }
+
+    void DSDXTDecoder::DecodeDXT5Row(const uint8_t* blocks, uint32_t width, uint32_t rows,
+                                     uint8_t* dest, size_t destStride, Path path) {
+        switch (ResolvePath(path)) {
+            case Path::AVX2: DecodeDXT5RowAVX2(blocks, width, rows, dest, destStride); break;
+            case Path::SSE2: DecodeDXT5RowSSE2(blocks, width, rows, dest, destStride); break;
+            default: DecodeRowScalar(blocks, 0, width, rows, dest, destStride, true); break;
+        }
+    }
+
+    void DSDXTDecoder::DecodeBC4Row(const uint8_t* blocks, uint32_t width, uint32_t rows,
+                                    uint8_t* dest, size_t destStride, Path) {
+        DecodeChannelRowScalar(blocks, width, rows, dest, destStride, 1);
+    }
+
+    void DSDXTDecoder::DecodeBC5Row(const uint8_t* blocks, uint32_t width, uint32_t rows,
+                                    uint8_t* dest, size_t destStride, Path) {
+        DecodeChannelRowScalar(blocks, width, rows, dest, destStride, 2);
+    }
+
+    void DSDXTDecoder::DecodeDXT1(const uint8_t* blocks, uint32_t width, uint32_t height, uint8_t* dest, Path path) {
+        const uint32_t blocksWide = (width + 3) / 4;
+        const uint32_t blocksHigh = (height + 3) / 4;
+        const size_t destStride = static_cast<size_t>(width) * 3;
+        path = ResolvePath(path);
+
+        for (uint32_t by = 0; by < blocksHigh; by++) {
+            uint32_t rows = std::min(4u, height - by * 4);
+            DecodeDXT1Row(blocks + static_cast<size_t>(by) * blocksWide * 8, width, rows,
+                          dest + static_cast<size_t>(by) * 4 * destStride, destStride, path);
+        }
+    }
+
+    void DSDXTDecoder::DecodeDXT5(const uint8_t* blocks, uint32_t width, uint32_t height, uint8_t* dest, Path path) {
+        const uint32_t blocksWide = (width + 3) / 4;
+        const uint32_t blocksHigh = (height + 3) / 4;
+        const size_t destStride = static_cast<size_t>(width) * 4;
+        path = ResolvePath(path);
+
+        for (uint32_t by = 0; by < blocksHigh; by++) {
+            uint32_t rows = std::min(4u, height - by * 4);
+            DecodeDXT5Row(blocks + static_cast<size_t>(by) * blocksWide * 16, width, rows,
+                          dest + static_cast<size_t>(by) * 4 * destStride, destStride, path);
+        }
+    }
+
+    void DSDXTDecoder::DecodeBC4(const uint8_t* blocks, uint32_t width, uint32_t height, uint8_t* dest, Path path) {
+        const uint32_t blocksWide = (width + 3) / 4;
+        const uint32_t blocksHigh = (height + 3) / 4;
+        const size_t destStride = width;
+
+        for (uint32_t by = 0; by < blocksHigh; by++) {
+            uint32_t rows = std::min(4u, height - by * 4);
+            DecodeBC4Row(blocks + static_cast<size_t>(by) * blocksWide * 8, width, rows,
+                         dest + static_cast<size_t>(by) * 4 * destStride, destStride, path);
+        }
+    }
+
+    void DSDXTDecoder::DecodeBC5(const uint8_t* blocks, uint32_t width, uint32_t height, uint8_t* dest, Path path) {
+        const uint32_t blocksWide = (width + 3) / 4;
+        const uint32_t blocksHigh = (height + 3) / 4;
+        const size_t destStride = static_cast<size_t>(width) * 2;
+
+        for (uint32_t by = 0; by < blocksHigh; by++) {
+            uint32_t rows = std::min(4u, height - by * 4);
+            DecodeBC5Row(blocks + static_cast<size_t>(by) * blocksWide * 16, width, rows,
+                         dest + static_cast<size_t>(by) * 4 * destStride, destStride, path);
+        }
+    }
+
+    DSDXTDecoder::Path DSDXTDecoder::GetBestPath() {
+        return DSCpu::HasAVX2() ? Path::AVX2 : Path::SSE2;
+    }
+
+    const char* DSDXTDecoder::GetPathName(Path path) {
+        switch (path) {
+            case Path::Auto: return "Auto";
+            case Path::Scalar: return "Scalar";
+            case Path::SSE2: return "SSE2";
+            case Path::AVX2: return "AVX2";
+            default: return "Unknown";
+        }
+    }
+}
@@ -0,0 +1,82 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+
+namespace DSEngine {
+    /**
+     * DXT1 (BC1), DXT5 (BC3), BC4 and BC5 decoders. Blocks are decoded a whole block row at a time
+     * straight into the destination image; partial blocks on the right and bottom edges are clipped.
+     * DXT1 decodes to RGB8, DXT5 to RGBA8, BC4 to R8 and BC5 to RG8.
+     */
+    class DSDXTDecoder {
+    public:
+        /**
+         * Implementation used to decode. Auto picks the fastest one supported by the CPU.
+         */
+        enum class Path {
+            Auto,
+            Scalar,
+            SSE2,
+            AVX2
+        };
+
+        /**
+         * Decodes one row of DXT1 blocks.
+         *
+         * @param blocks First block of the row.
+         * @param width Image width in pixels.
+         * @param rows Pixel rows to write (4, or less on the last block row).
+         * @param dest First pixel of the destination row.
+         * @param destStride Destination row pitch in bytes.
+         * @param path Implementation to use.
+         */
+        static void DecodeDXT1Row(const uint8_t* blocks, uint32_t width, uint32_t rows,
+                                  uint8_t* dest, size_t destStride, Path path = Path::Auto);
+
+        /**
+         * Decodes one row of DXT5 blocks, see DecodeDXT1Row.
+         */
+        static void DecodeDXT5Row(const uint8_t* blocks, uint32_t width, uint32_t rows,
+                                  uint8_t* dest, size_t destStride, Path path = Path::Auto);
+
+        /**
+         * Decodes a whole DXT1 image into a tightly packed RGB8 buffer.
+         */
+        static void DecodeDXT1(const uint8_t* blocks, uint32_t width, uint32_t height, uint8_t* dest, Path path = Path::Auto);
+
+        /**
+         * Decodes a whole DXT5 image into a tightly packed RGBA8 buffer.
+         */
+        static void DecodeDXT5(const uint8_t* blocks, uint32_t width, uint32_t height, uint8_t* dest, Path path = Path::Auto);
+
+        /**
+         * Decodes one row of BC4 blocks, see DecodeDXT1Row. BC4 and BC5 are pure palette lookups
+         * (the DXT5 alpha block), every path runs the same scalar code.
+         */
+        static void DecodeBC4Row(const uint8_t* blocks, uint32_t width, uint32_t rows,
+                                 uint8_t* dest, size_t destStride, Path path = Path::Auto);
+
+        /**
+         * Decodes one row of BC5 blocks (a red then a green BC4 block per 4x4 block), see DecodeBC4Row.
+         */
+        static void DecodeBC5Row(const uint8_t* blocks, uint32_t width, uint32_t rows,
+                                 uint8_t* dest, size_t destStride, Path path = Path::Auto);
+
+        /**
+         * Decodes a whole BC4 image into a tightly packed R8 buffer.
+         */
+        static void DecodeBC4(const uint8_t* blocks, uint32_t width, uint32_t height, uint8_t* dest, Path path = Path::Auto);
+
+        /**
+         * Decodes a whole BC5 image into a tightly packed RG8 buffer.
+         */
+        static void DecodeBC5(const uint8_t* blocks, uint32_t width, uint32_t height, uint8_t* dest, Path path = Path::Auto);
+
+        /**
+         * Returns the path Auto resolves to on this CPU.
+         */
+        static Path GetBestPath();
+
+        static const char* GetPathName(Path path);
+    };
+}
@@ -0,0 +1,360 @@
+#include "DSDXTEncoder.h"
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+
+// stb_dxt configuration
+#define STB_DXT_IMPLEMENTATION
+#define STB_DXT_STATIC
+#include "../third_party/stb/stb_dxt.h"
+
+namespace DSEngine {
+    namespace {
+        const uint32_t CACHE_SIZE = 256;  // Direct mapped, per EncodeRows call
+
+        std::atomic<uint64_t> s_blocks{0};
+        std::atomic<uint64_t> s_solidBlocks{0};
+        std::atomic<uint64_t> s_cacheHits{0};
+
+        // Best endpoint pair for each 8-bit value of a single colour channel: the block uses index 2
+        // everywhere, which decodes to (2 * max + min) / 3 of the expanded endpoints
+        struct SolidTables {
+            uint8_t match5[256][2];  // [value] = {max, min} 5-bit endpoints
+            uint8_t match6[256][2];  // [value] = {max, min} 6-bit endpoints
+        };
+
+        void BuildSolidTable(uint8_t table[256][2], uint32_t bits) {
+            const uint32_t count = 1u << bits;
+            for (int value = 0; value < 256; value++) {
+                int bestError = 256;
+                int bestSpread = 256;
+                for (uint32_t mx = 0; mx < count; mx++) {
+                    for (uint32_t mn = 0; mn < count; mn++) {
+                        const int maxExpanded = (bits == 5) ? ((mx << 3) | (mx >> 2)) : ((mx << 2) | (mx >> 4));
+                        const int minExpanded = (bits == 5) ? ((mn << 3) | (mn >> 2)) : ((mn << 2) | (mn >> 4));
+                        const int error = std::abs((2 * maxExpanded + minExpanded) / 3 - value);
+
+                        // Close endpoints win ties, hardware decoders round the interpolation differently
+                        const int spread = std::abs(maxExpanded - minExpanded);
+                        if (error < bestError || (error == bestError && spread < bestSpread)) {
+                            bestError = error;
+                            bestSpread = spread;
+                            table[value][0] = static_cast<uint8_t>(mx);
+                            table[value][1] = static_cast<uint8_t>(mn);
+                        }
+                    }
+                }
+            }
+        }
+
+        const SolidTables& GetSolidTables() {
+            static const SolidTables tables = []() {
+                SolidTables result;
+                BuildSolidTable(result.match5, 5);
+                BuildSolidTable(result.match6, 6);
+                return result;
+            }();
+            return tables;
+        }
+
+        void EncodeSolidColor(uint8_t r, uint8_t g, uint8_t b, uint8_t* dest) {
+            const SolidTables& tables = GetSolidTables();
+            uint16_t max16 = static_cast<uint16_t>((tables.match5[r][0] << 11) | (tables.match6[g][0] << 5) | tables.match5[b][0]);
+            uint16_t min16 = static_cast<uint16_t>((tables.match5[r][1] << 11) | (tables.match6[g][1] << 5) | tables.match5[b][1]);
+            uint32_t indices = 0xAAAAAAAAu;
+
+            // Keep color0 > color1 (four color mode on DXT1), index 3 is index 2 with the endpoints swapped
+            if (max16 < min16) {
+                std::swap(max16, min16);
+                indices ^= 0x55555555u;
+            }
+
+            dest[0] = static_cast<uint8_t>(max16);
+            dest[1] = static_cast<uint8_t>(max16 >> 8);
+            dest[2] = static_cast<uint8_t>(min16);
+            dest[3] = static_cast<uint8_t>(min16 >> 8);
+            dest[4] = static_cast<uint8_t>(indices);
+            dest[5] = static_cast<uint8_t>(indices >> 8);
+            dest[6] = static_cast<uint8_t>(indices >> 16);
+            dest[7] = static_cast<uint8_t>(indices >> 24);
+        }
+
+        bool IsSolid(const uint8_t* block, uint32_t pixelSize) {
+            for (uint32_t i = 1; i < 16; i++) {
+                if (std::memcmp(block, block + i * pixelSize, pixelSize) != 0) return false;
+            }
+            return true;
+        }
+
+        // Solid blocks are encoded from the tables, everything else by stb_dxt
+        bool EncodeClassified(const uint8_t* rgba, uint8_t* dest, bool dxt5, bool highQuality) {
+            if (!IsSolid(rgba, 4)) {
+                stb_compress_dxt_block(dest, rgba, dxt5 ? 1 : 0, highQuality ? STB_DXT_HIGHQUAL : STB_DXT_NORMAL);
+                return false;
+            }
+
+            if (dxt5) {
+                // Both alpha endpoints equal, every index 0
+                dest[0] = rgba[3];
+                dest[1] = rgba[3];
+                std::memset(dest + 2, 0, 6);
+                dest += 8;
+            }
+            EncodeSolidColor(rgba[0], rgba[1], rgba[2], dest);
+            return true;
+        }
+
+        // BC4 palette, the same arithmetic as DSDXTDecoder: 8 values when e0 > e1, else 6 values plus 0 and 255
+        void BuildChannelPalette(int e0, int e1, int palette[8]) {
+            palette[0] = e0;
+            palette[1] = e1;
+            if (e0 > e1) {
+                for (int i = 1; i < 7; i++) {
+                    palette[i + 1] = ((7 - i) * e0 + i * e1) / 7;
+                }
+            } else {
+                for (int i = 1; i < 5; i++) {
+                    palette[i + 1] = ((5 - i) * e0 + i * e1) / 5;
+                }
+                palette[6] = 0;
+                palette[7] = 255;
+            }
+        }
+
+        // Nearest palette entry of every texel, returns the squared error
+        uint32_t FitChannel(const uint8_t* values, const int palette[8], uint64_t& indices) {
+            uint32_t error = 0;
+            indices = 0;
+            for (int i = 0; i < 16; i++) {
+                int bestIndex = 0;
+                int bestError = INT_MAX;
+                for (int j = 0; j < 8; j++) {
+                    const int difference = values[i] - palette[j];
+                    if (difference * difference < bestError) {
+                        bestError = difference * difference;
+                        bestIndex = j;
+                    }
+                }
+                indices |= static_cast<uint64_t>(bestIndex) << (3 * i);
+                error += static_cast<uint32_t>(bestError);
+            }
+            return error;
+        }
+
+        // One BC4 block from 16 values, returns true for a single value block
+        bool EncodeChannel(const uint8_t* values, uint8_t* dest, bool highQuality) {
+            int low = 255, high = 0;
+            int innerLow = 255, innerHigh = 0;  // Without the 0 and 255 the 6 value mode has for free
+            for (int i = 0; i < 16; i++) {
+                low = std::min<int>(low, values[i]);
+                high = std::max<int>(high, values[i]);
+                if (values[i] != 0 && values[i] != 255) {
+                    innerLow = std::min<int>(innerLow, values[i]);
+                    innerHigh = std::max<int>(innerHigh, values[i]);
+                }
+            }
+
+            if (low == high) {
+                dest[0] = static_cast<uint8_t>(low);
+                dest[1] = static_cast<uint8_t>(low);
+                std::memset(dest + 2, 0, 6);
+                return true;
+            }
+
+            int palette[8];
+            int bestE0 = high, bestE1 = low;
+            uint64_t bestIndices;
+            BuildChannelPalette(bestE0, bestE1, palette);
+            uint32_t bestError = FitChannel(values, palette, bestIndices);
+
+            auto tryEndpoints = [&](int e0, int e1) {
+                uint64_t indices;
+                BuildChannelPalette(e0, e1, palette);
+                const uint32_t error = FitChannel(values, palette, indices);
+                if (error < bestError) {
+                    bestError = error;
+                    bestE0 = e0;
+                    bestE1 = e1;
+                    bestIndices = indices;
+                }
+            };
+
+            if (highQuality && bestError > 0) {
+                // Insetting the endpoints trades the extremes for finer steps in between
+                for (int insetHigh = 0; insetHigh <= 3; insetHigh++) {
+                    for (int insetLow = 0; insetLow <= 3; insetLow++) {
+                        if ((insetHigh || insetLow) && high - insetHigh > low + insetLow) {
+                            tryEndpoints(high - insetHigh, low + insetLow);
+                        }
+                    }
+                }
+                // e0 <= e1 selects the 6 value mode
+                if (innerLow <= innerHigh) {
+                    tryEndpoints(innerLow, innerHigh);
+                }
+            }
+
+            dest[0] = static_cast<uint8_t>(bestE0);
+            dest[1] = static_cast<uint8_t>(bestE1);
+            for (int i = 0; i < 6; i++) {
+                dest[2 + i] = static_cast<uint8_t>(bestIndices >> (8 * i));
+            }
+            return false;
+        }
+
+        // BC4 (1 channel) or BC5 (2 channels, red block then green block), returns true if every channel is solid
+        bool EncodeChannels(const uint8_t* block, uint32_t channels, uint8_t* dest, bool highQuality) {
+            bool solid = true;
+            for (uint32_t c = 0; c < channels; c++) {
+                uint8_t values[16];
+                for (int i = 0; i < 16; i++) {
+                    values[i] = block[i * channels + c];
+                }
+                solid &= EncodeChannel(values, dest + c * 8, highQuality);
+            }
+            return solid;
+        }
+
+        // DXT1 ignores alpha, forcing it opaque lets blocks differing only in alpha share a cache entry
+        void GatherBlock(const uint8_t* pixels, uint32_t width, uint32_t height, uint32_t pixelSize,
+                         uint32_t blockX, uint32_t blockY, bool forceOpaque, uint8_t* block) {
+            for (uint32_t y = 0; y < 4; y++) {
+                const uint32_t sy = std::min(blockY * 4 + y, height - 1);
+                for (uint32_t x = 0; x < 4; x++) {
+                    const uint32_t sx = std::min(blockX * 4 + x, width - 1);
+                    std::memcpy(block + (y * 4 + x) * pixelSize, pixels + (static_cast<size_t>(sy) * width + sx) * pixelSize, pixelSize);
+                    if (forceOpaque) block[(y * 4 + x) * 4 + 3] = 255;
+                }
+            }
+        }
+
+        // size is a multiple of 8
+        uint32_t HashBlock(const uint8_t* block, size_t size) {
+            uint64_t hash = 0;
+            for (size_t i = 0; i < size; i += 8) {
+                uint64_t word;
+                std::memcpy(&word, block + i, 8);
+                hash = (hash ^ word) * 0x9E3779B97F4A7C15ull;
+                hash ^= hash >> 29;
+            }
+            return static_cast<uint32_t>(hash >> 32) & (CACHE_SIZE - 1);
+        }
+
+        struct BlockCache {
+            uint8_t texels[CACHE_SIZE][64];
+            uint8_t encoded[CACHE_SIZE][16];
+            bool valid[CACHE_SIZE] = {};
+        };
+
+        // Block row loop shared by every format: solid blocks and repeats of a cached block skip the search,
+        // encode(block, output) returns true when it took its solid path
+        template <typename Encode>
+        void EncodeBlockRows(const uint8_t* pixels, uint32_t width, uint32_t height, uint32_t pixelSize, bool forceOpaque,
+                             uint32_t firstBlockRow, uint32_t blockRowCount, uint8_t* dest, size_t blockSize, Encode encode) {
+            const uint32_t blocksWide = (width + 3) / 4;
+            const size_t texelBytes = 16 * pixelSize;
+            const uint32_t lastBlockRow = firstBlockRow + blockRowCount;
+
+            BlockCache cache;
+            uint64_t blocks = 0, solidBlocks = 0, cacheHits = 0;
+
+            for (uint32_t by = firstBlockRow; by < lastBlockRow; by++) {
+                for (uint32_t bx = 0; bx < blocksWide; bx++) {
+                    uint8_t block[4*4*4];
+                    GatherBlock(pixels, width, height, pixelSize, bx, by, forceOpaque, block);
+                    uint8_t* output = dest + (static_cast<size_t>(by) * blocksWide + bx) * blockSize;
+                    blocks++;
+
+                    if (IsSolid(block, pixelSize)) {
+                        encode(block, output);
+                        solidBlocks++;
+                        continue;
+                    }
+
+                    const uint32_t slot = HashBlock(block, texelBytes);
+                    if (cache.valid[slot] && std::memcmp(cache.texels[slot], block, texelBytes) == 0) {
+                        std::memcpy(output, cache.encoded[slot], blockSize);
+                        cacheHits++;
+                        continue;
+                    }
+
+                    encode(block, output);
+                    std::memcpy(cache.texels[slot], block, texelBytes);
+                    std::memcpy(cache.encoded[slot], output, blockSize);
+                    cache.valid[slot] = true;
+                }
+            }
+
+            s_blocks.fetch_add(blocks, std::memory_order_relaxed);
+            s_solidBlocks.fetch_add(solidBlocks, std::memory_order_relaxed);
+            s_cacheHits.fetch_add(cacheHits, std::memory_order_relaxed);
+        }
+
+        // Some stb_dxt versions build their lookup tables on the first call, encode one block under the
+        // static init guard so neither the pool workers nor several textures compressed at once race on that
+        void WarmUp() {
+            static const bool warmedUp = []() {
+                uint8_t pixels[4*4*4] = {};
+                uint8_t block[16];
+                stb_compress_dxt_block(block, pixels, 1, STB_DXT_HIGHQUAL);
+                GetSolidTables();
+                return true;
+            }();
+            (void)warmedUp;
+        }
+    }
+
+    void DSDXTEncoder::EncodeBlock(const uint8_t* rgba, uint8_t* dest, bool dxt5, bool highQuality) {
+        WarmUp();
+
+        uint8_t block[4*4*4];
+        std::memcpy(block, rgba, sizeof(block));
+        if (!dxt5) {
+            for (int i = 0; i < 16; i++) block[i * 4 + 3] = 255;
+        }
+
+        const bool solid = EncodeClassified(block, dest, dxt5, highQuality);
+        s_blocks.fetch_add(1, std::memory_order_relaxed);
+        if (solid) s_solidBlocks.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void DSDXTEncoder::EncodeRows(const uint8_t* rgba, uint32_t width, uint32_t height, uint32_t firstBlockRow,
+                                  uint32_t blockRowCount, uint8_t* dest, bool dxt5, bool highQuality) {
+        WarmUp();
+
+        EncodeBlockRows(rgba, width, height, 4, !dxt5, firstBlockRow, blockRowCount, dest, dxt5 ? 16 : 8,
+                        [=](const uint8_t* block, uint8_t* output) {
+                            return EncodeClassified(block, output, dxt5, highQuality);
+                        });
+    }
+
+    void DSDXTEncoder::EncodeChannelBlock(const uint8_t* pixels, uint32_t channels, uint8_t* dest, bool highQuality) {
+        const bool solid = EncodeChannels(pixels, channels, dest, highQuality);
+        s_blocks.fetch_add(1, std::memory_order_relaxed);
+        if (solid) s_solidBlocks.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void DSDXTEncoder::EncodeChannelRows(const uint8_t* pixels, uint32_t channels, uint32_t width, uint32_t height,
+                                         uint32_t firstBlockRow, uint32_t blockRowCount, uint8_t* dest, bool highQuality) {
+        EncodeBlockRows(pixels, width, height, channels, false, firstBlockRow, blockRowCount, dest, channels * 8,
+                        [=](const uint8_t* block, uint8_t* output) {
+                            return EncodeChannels(block, channels, output, highQuality);
+                        });
+    }
+
+    DSDXTEncoder::Stats DSDXTEncoder::GetStats() {
+        Stats stats;
+        stats.blocks = s_blocks.load(std::memory_order_relaxed);
+        stats.solidBlocks = s_solidBlocks.load(std::memory_order_relaxed);
+        stats.cacheHits = s_cacheHits.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+    void DSDXTEncoder::ResetStats() {
+        s_blocks = 0;
+        s_solidBlocks = 0;
+        s_cacheHits = 0;
+    }
+}
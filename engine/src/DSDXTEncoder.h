@@ -0,0 +1,68 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+
+namespace DSEngine {
+    /**
+     * DXT1 (BC1) and DXT5 (BC3) block encoder on top of stb_dxt, plus a BC4/BC5 encoder.
+     * Blocks are classified before encoding: single colour blocks get an optimal encoding from lookup tables
+     * and blocks repeating one seen earlier in the same call are copied from a small hash cache, so only
+     * blocks with real detail go through stb_dxt. Cache hits are bit identical to encoding the block again.
+     * BC4/BC5 blocks fit each channel between its min and max, high quality also searches inset endpoints
+     * and the 6 value mode (explicit 0 and 255) and keeps the lowest squared error.
+     */
+    class DSDXTEncoder {
+    public:
+        // Counters over every block encoded since the last ResetStats, across all threads
+        struct Stats {
+            uint64_t blocks = 0;       // Blocks encoded
+            uint64_t solidBlocks = 0;  // Single colour blocks encoded without a search
+            uint64_t cacheHits = 0;    // Repeated blocks copied from the cache
+        };
+
+        /**
+         * Encodes one block.
+         *
+         * @param rgba 4x4 RGBA8 texels, row major (64 bytes). DXT1 ignores alpha.
+         * @param dest 8 bytes for DXT1, 16 for DXT5.
+         * @param dxt5 Encode DXT5 instead of DXT1.
+         * @param highQuality stb_dxt HIGHQUAL mode instead of NORMAL.
+         */
+        static void EncodeBlock(const uint8_t* rgba, uint8_t* dest, bool dxt5, bool highQuality);
+
+        /**
+         * Encodes a range of block rows of an RGBA8 image, partial blocks on the right and bottom edges
+         * repeat the last column and row.
+         *
+         * @param rgba Tightly packed RGBA8 image.
+         * @param width Image width in pixels.
+         * @param height Image height in pixels.
+         * @param firstBlockRow First block row to encode.
+         * @param blockRowCount Number of block rows to encode.
+         * @param dest The whole destination image, blocks are written at their place in it.
+         * @param dxt5 Encode DXT5 instead of DXT1.
+         * @param highQuality stb_dxt HIGHQUAL mode instead of NORMAL.
+         */
+        static void EncodeRows(const uint8_t* rgba, uint32_t width, uint32_t height, uint32_t firstBlockRow,
+                               uint32_t blockRowCount, uint8_t* dest, bool dxt5, bool highQuality);
+
+        /**
+         * Encodes one BC4 or BC5 block.
+         *
+         * @param pixels 4x4 R8 (BC4) or RG8 (BC5) texels, row major (16 or 32 bytes).
+         * @param channels 1 for BC4, 2 for BC5.
+         * @param dest 8 bytes for BC4, 16 for BC5 (the red block then the green block).
+         * @param highQuality Search more endpoints instead of the channel min and max only.
+         */
+        static void EncodeChannelBlock(const uint8_t* pixels, uint32_t channels, uint8_t* dest, bool highQuality);
+
+        /**
+         * Encodes a range of block rows of a tightly packed R8 (BC4) or RG8 (BC5) image, see EncodeRows.
+         */
+        static void EncodeChannelRows(const uint8_t* pixels, uint32_t channels, uint32_t width, uint32_t height,
+                                      uint32_t firstBlockRow, uint32_t blockRowCount, uint8_t* dest, bool highQuality);
+
+        static Stats GetStats();
+        static void ResetStats();
+    };
+}
@@ -0,0 +1,279 @@
+#include "DSFloatConverter.h"
+#include "DSCpu.h"
+#include <immintrin.h>
+#include <cstring>
+
+namespace DSEngine {
+    namespace {
+        const uint32_t MAX_11BIT_FLOAT = 0x477E0000;  // 65024.0f
+        const uint32_t MAX_10BIT_FLOAT = 0x477C0000;  // 64512.0f
+        const uint32_t MIN_NORMAL = 113u << 23;       // 2^-14, smallest normal half and 11/10-bit float
+
+        inline uint32_t FloatBits(float value) {
+            uint32_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            return bits;
+        }
+
+        inline float BitsToFloat(uint32_t bits) {
+            float value;
+            std::memcpy(&value, &bits, sizeof(value));
+            return value;
+        }
+
+        // =====================
+        // Scalar
+        // =====================
+
+        // Float bits without sign to a float with a 5-bit exponent (bias 15) and mantissaBits of mantissa.
+        // Denormals are rounded by an add that leaves the denormal step as the float's ulp, normals by adding
+        // half an ulp minus one plus the lowest kept bit, so ties go to even.
+        inline uint32_t PackUnsigned(uint32_t bits, int mantissaBits) {
+            const int shift = 23 - mantissaBits;
+            if (bits < MIN_NORMAL) {
+                const float magic = BitsToFloat(static_cast<uint32_t>(127 + 9 - mantissaBits) << 23);
+                return FloatBits(BitsToFloat(bits) + magic) - FloatBits(magic);
+            }
+            const uint32_t odd = (bits >> shift) & 1;
+            return (bits - ((127u - 15u) << 23) + (1u << (shift - 1)) - 1 + odd) >> shift;
+        }
+
+        // The inverse, for 5 + mantissaBits bits without sign
+        inline float UnpackUnsigned(uint32_t value, int mantissaBits) {
+            uint32_t bits = value << (23 - mantissaBits);
+            const uint32_t exponent = bits & (0x1Fu << 23);
+            bits += (127u - 15u) << 23;
+            if (exponent == (0x1Fu << 23)) {
+                bits += (128u - 16u) << 23;  // Infinity and NaN
+            } else if (exponent == 0) {
+                return BitsToFloat(bits + (1u << 23)) - BitsToFloat(MIN_NORMAL);
+            }
+            return BitsToFloat(bits);
+        }
+
+        uint16_t FloatToHalfScalar(float value) {
+            uint32_t bits = FloatBits(value);
+            const uint32_t sign = (bits >> 16) & 0x8000;
+            bits &= 0x7FFFFFFF;
+
+            if (bits >= (143u << 23)) {
+                // 65536 and above, infinity and NaN (kept quiet)
+                return static_cast<uint16_t>(sign | (bits > 0x7F800000 ? 0x7E00 : 0x7C00));
+            }
+            // Values rounding up past 65504 carry into the exponent and give infinity
+            return static_cast<uint16_t>(sign | PackUnsigned(bits, 10));
+        }
+
+        float HalfToFloatScalar(uint16_t value) {
+            const float result = UnpackUnsigned(value & 0x7FFF, 10);
+            return (value & 0x8000) ? -result : result;
+        }
+
+        void FloatToHalfScalar(const float* src, uint16_t* dest, size_t count) {
+            for (size_t i = 0; i < count; i++) {
+                dest[i] = FloatToHalfScalar(src[i]);
+            }
+        }
+
+        void HalfToFloatScalar(const uint16_t* src, float* dest, size_t count) {
+            for (size_t i = 0; i < count; i++) {
+                dest[i] = HalfToFloatScalar(src[i]);
+            }
+        }
+
+        inline uint32_t ClampBits(float value, uint32_t maxBits) {
+            // NaN fails the comparison and becomes 0 too
+            if (!(value > 0.0f)) return 0;
+            const uint32_t bits = FloatBits(value);
+            return bits < maxBits ? bits : maxBits;
+        }
+
+        void RGBA32FToR11G11B10FScalar(const float* src, uint32_t* dest, size_t count) {
+            for (size_t i = 0; i < count; i++, src += 4) {
+                dest[i] = PackUnsigned(ClampBits(src[0], MAX_11BIT_FLOAT), 6) |
+                          (PackUnsigned(ClampBits(src[1], MAX_11BIT_FLOAT), 6) << 11) |
+                          (PackUnsigned(ClampBits(src[2], MAX_10BIT_FLOAT), 5) << 22);
+            }
+        }
+
+        void R11G11B10FToRGBA32FScalar(const uint32_t* src, float* dest, size_t count) {
+            for (size_t i = 0; i < count; i++, dest += 4) {
+                dest[0] = UnpackUnsigned(src[i] & 0x7FF, 6);
+                dest[1] = UnpackUnsigned((src[i] >> 11) & 0x7FF, 6);
+                dest[2] = UnpackUnsigned(src[i] >> 22, 5);
+                dest[3] = 1.0f;
+            }
+        }
+
+        // =====================
+        // SSE2, 4 pixels per iteration
+        // =====================
+
+        inline __m128i Select(__m128i mask, __m128i a, __m128i b) {
+            return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+        }
+
+        // PackUnsigned on 4 values, already clamped to [0, max]
+        template<int MANTISSA_BITS>
+        inline __m128i PackUnsignedSSE2(__m128 value) {
+            const int shift = 23 - MANTISSA_BITS;
+            const __m128i bits = _mm_castps_si128(value);
+            const __m128 magic = _mm_castsi128_ps(_mm_set1_epi32((127 + 9 - MANTISSA_BITS) << 23));
+            const __m128i denormal = _mm_sub_epi32(_mm_castps_si128(_mm_add_ps(value, magic)), _mm_castps_si128(magic));
+
+            const __m128i odd = _mm_and_si128(_mm_srli_epi32(bits, shift), _mm_set1_epi32(1));
+            __m128i normal = _mm_add_epi32(bits, _mm_set1_epi32(-(112 << 23) + (1 << (shift - 1)) - 1));
+            normal = _mm_srli_epi32(_mm_add_epi32(normal, odd), shift);
+
+            return Select(_mm_cmplt_epi32(bits, _mm_set1_epi32(MIN_NORMAL)), denormal, normal);
+        }
+
+        // UnpackUnsigned on 4 values
+        template<int MANTISSA_BITS>
+        inline __m128 UnpackUnsignedSSE2(__m128i value) {
+            const __m128i exponentMask = _mm_set1_epi32(0x1F << 23);
+            __m128i bits = _mm_slli_epi32(value, 23 - MANTISSA_BITS);
+            const __m128i exponent = _mm_and_si128(bits, exponentMask);
+            bits = _mm_add_epi32(bits, _mm_set1_epi32(112 << 23));
+
+            const __m128i special = _mm_cmpeq_epi32(exponent, exponentMask);
+            bits = _mm_add_epi32(bits, _mm_and_si128(special, _mm_set1_epi32(112 << 23)));
+
+            const __m128 denormal = _mm_sub_ps(_mm_castsi128_ps(_mm_add_epi32(bits, _mm_set1_epi32(1 << 23))),
+                                               _mm_castsi128_ps(_mm_set1_epi32(MIN_NORMAL)));
+            const __m128i isDenormal = _mm_cmpeq_epi32(exponent, _mm_setzero_si128());
+            return _mm_castsi128_ps(Select(isDenormal, _mm_castps_si128(denormal), bits));
+        }
+
+        void RGBA32FToR11G11B10FSSE2(const float* src, uint32_t* dest, size_t count) {
+            const __m128 zero = _mm_setzero_ps();
+            const __m128 max11 = _mm_castsi128_ps(_mm_set1_epi32(MAX_11BIT_FLOAT));
+            const __m128 max10 = _mm_castsi128_ps(_mm_set1_epi32(MAX_10BIT_FLOAT));
+
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4, src += 16) {
+                __m128 r = _mm_loadu_ps(src + 0);
+                __m128 g = _mm_loadu_ps(src + 4);
+                __m128 b = _mm_loadu_ps(src + 8);
+                __m128 a = _mm_loadu_ps(src + 12);
+                _MM_TRANSPOSE4_PS(r, g, b, a);
+
+                // max returns its second operand for NaN
+                r = _mm_min_ps(_mm_max_ps(r, zero), max11);
+                g = _mm_min_ps(_mm_max_ps(g, zero), max11);
+                b = _mm_min_ps(_mm_max_ps(b, zero), max10);
+
+                __m128i packed = _mm_or_si128(PackUnsignedSSE2<6>(r), _mm_slli_epi32(PackUnsignedSSE2<6>(g), 11));
+                packed = _mm_or_si128(packed, _mm_slli_epi32(PackUnsignedSSE2<5>(b), 22));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i), packed);
+            }
+            RGBA32FToR11G11B10FScalar(src, dest + i, count - i);
+        }
+
+        void R11G11B10FToRGBA32FSSE2(const uint32_t* src, float* dest, size_t count) {
+            const __m128i mask11 = _mm_set1_epi32(0x7FF);
+
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4, dest += 16) {
+                const __m128i packed = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+                __m128 r = UnpackUnsignedSSE2<6>(_mm_and_si128(packed, mask11));
+                __m128 g = UnpackUnsignedSSE2<6>(_mm_and_si128(_mm_srli_epi32(packed, 11), mask11));
+                __m128 b = UnpackUnsignedSSE2<5>(_mm_srli_epi32(packed, 22));
+                __m128 a = _mm_set1_ps(1.0f);
+                _MM_TRANSPOSE4_PS(r, g, b, a);
+
+                _mm_storeu_ps(dest + 0, r);
+                _mm_storeu_ps(dest + 4, g);
+                _mm_storeu_ps(dest + 8, b);
+                _mm_storeu_ps(dest + 12, a);
+            }
+            R11G11B10FToRGBA32FScalar(src + i, dest, count - i);
+        }
+
+        // =====================
+        // F16C, 8 values per iteration
+        // =====================
+
+        DS_TARGET("avx,f16c")
+        void FloatToHalfF16C(const float* src, uint16_t* dest, size_t count) {
+            size_t i = 0;
+            for (; i + 8 <= count; i += 8) {
+                const __m128i half = _mm256_cvtps_ph(_mm256_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i), half);
+            }
+            FloatToHalfScalar(src + i, dest + i, count - i);
+        }
+
+        DS_TARGET("avx,f16c")
+        void HalfToFloatF16C(const uint16_t* src, float* dest, size_t count) {
+            size_t i = 0;
+            for (; i + 8 <= count; i += 8) {
+                const __m128i half = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+                _mm256_storeu_ps(dest + i, _mm256_cvtph_ps(half));
+            }
+            HalfToFloatScalar(src + i, dest + i, count - i);
+        }
+
+        DSFloatConverter::Path ResolvePath(DSFloatConverter::Path path) {
+            if (path == DSFloatConverter::Path::Auto) {
+                return DSFloatConverter::GetBestPath();
+            }
+            if (path == DSFloatConverter::Path::F16C && !DSCpu::HasF16C()) {
+                path = DSFloatConverter::Path::SSE2;
+            }
+            return path;
+        }
+    }
+
+    void DSFloatConverter::FloatToHalf(const float* src, uint16_t* dest, size_t count, Path path) {
+        switch (ResolvePath(path)) {
+            case Path::F16C: FloatToHalfF16C(src, dest, count); break;
+            default: FloatToHalfScalar(src, dest, count); break;
+        }
+    }
+
+    void DSFloatConverter::HalfToFloat(const uint16_t* src, float* dest, size_t count, Path path) {
+        switch (ResolvePath(path)) {
+            case Path::F16C: HalfToFloatF16C(src, dest, count); break;
+            default: HalfToFloatScalar(src, dest, count); break;
+        }
+    }
+
+    void DSFloatConverter::RGBA32FToR11G11B10F(const float* src, uint32_t* dest, size_t pixelCount, Path path) {
+        switch (ResolvePath(path)) {
+            case Path::F16C:
+            case Path::SSE2: RGBA32FToR11G11B10FSSE2(src, dest, pixelCount); break;
+            default: RGBA32FToR11G11B10FScalar(src, dest, pixelCount); break;
+        }
+    }
+
+    void DSFloatConverter::R11G11B10FToRGBA32F(const uint32_t* src, float* dest, size_t pixelCount, Path path) {
+        switch (ResolvePath(path)) {
+            case Path::F16C:
+            case Path::SSE2: R11G11B10FToRGBA32FSSE2(src, dest, pixelCount); break;
+            default: R11G11B10FToRGBA32FScalar(src, dest, pixelCount); break;
+        }
+    }
+
+    uint16_t DSFloatConverter::FloatToHalf(float value) {
+        return FloatToHalfScalar(value);
+    }
+
+    float DSFloatConverter::HalfToFloat(uint16_t value) {
+        return HalfToFloatScalar(value);
+    }
+
+    DSFloatConverter::Path DSFloatConverter::GetBestPath() {
+        return DSCpu::HasF16C() ? Path::F16C : Path::SSE2;
+    }
+
+    const char* DSFloatConverter::GetPathName(Path path) {
+        switch (path) {
+            case Path::Auto: return "Auto";
+            case Path::Scalar: return "Scalar";
+            case Path::SSE2: return "SSE2";
+            case Path::F16C: return "F16C";
+        }
+        return "Unknown";
+    }
+}
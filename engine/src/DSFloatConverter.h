@@ -0,0 +1,48 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+
+namespace DSEngine {
+    /**
+     * Conversions between 32-bit floats and the packed float formats of HDR textures:
+     * IEEE half (RGBA16F) and R11G11B10F (unsigned 6-bit mantissa red and green, 5-bit mantissa blue,
+     * red in the low bits). Every conversion rounds to nearest even, like the GPU and F16C do.
+     * Buffers are tightly packed and must not overlap.
+     */
+    class DSFloatConverter {
+    public:
+        /**
+         * Implementation used to convert. Auto picks the fastest one supported by the CPU.
+         * Half conversions without an F16C kernel run the scalar code on the SSE2 path.
+         */
+        enum class Path {
+            Auto,
+            Scalar,
+            SSE2,
+            F16C
+        };
+
+        // float -> half, values too large for a half become infinity
+        static void FloatToHalf(const float* src, uint16_t* dest, size_t count, Path path = Path::Auto);
+
+        // half -> float, exact
+        static void HalfToFloat(const uint16_t* src, float* dest, size_t count, Path path = Path::Auto);
+
+        // RGBA32F -> R11G11B10F, alpha is dropped. Negative values and NaN become 0,
+        // values above the largest finite one (65024 for red and green, 64512 for blue) clamp to it.
+        static void RGBA32FToR11G11B10F(const float* src, uint32_t* dest, size_t pixelCount, Path path = Path::Auto);
+
+        // R11G11B10F -> RGBA32F with alpha 1, exact
+        static void R11G11B10FToRGBA32F(const uint32_t* src, float* dest, size_t pixelCount, Path path = Path::Auto);
+
+        static uint16_t FloatToHalf(float value);
+        static float HalfToFloat(uint16_t value);
+
+        /**
+         * Returns the path Auto resolves to on this CPU.
+         */
+        static Path GetBestPath();
+
+        static const char* GetPathName(Path path);
+    };
+}
@@ -0,0 +1,245 @@
+#include "DSFrustum.h"
+#include "DSCpu.h"
+#include "DSThreadPool.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+namespace DSEngine {
+    namespace {
+        // Items per thread pool job, arrays up to this size are culled on the calling thread
+        const uint32_t CHUNK_SIZE = 16384;
+        const int PLANE_COUNT = static_cast<int>(DSFrustum::Plane::Count);
+
+        const bool s_hasAVX = DSCpu::HasAVX();
+
+        // Structure of arrays bounds, the radius for spheres or the extents for boxes
+        struct Bounds {
+            const float* x;
+            const float* y;
+            const float* z;
+            const float* radius;
+            const float* extentX;
+            const float* extentY;
+            const float* extentZ;
+        };
+
+        // Every path computes the plane distance and the bounds projection in this order, so they agree
+        // on objects touching a plane
+        template <bool BOX>
+        FORCE_INLINE bool TestScalar(const Vector4* planes, const Bounds& bounds, size_t i) {
+            for (int p = 0; p < PLANE_COUNT; p++) {
+                const Vector4& plane = planes[p];
+                const float distance = ((plane.x * bounds.x[i] + plane.y * bounds.y[i]) + plane.z * bounds.z[i]) + plane.w;
+                const float reach = BOX ? (std::fabs(plane.x) * bounds.extentX[i] + std::fabs(plane.y) * bounds.extentY[i]) +
+                                              std::fabs(plane.z) * bounds.extentZ[i]
+                                        : bounds.radius[i];
+                if (!(distance >= -reach)) return false;
+            }
+            return true;
+        }
+
+        // Indices are written for every lane and only kept for visible ones, no branch on the mask
+        FORCE_INLINE uint32_t AppendVisible(uint32_t* visible, uint32_t visibleCount, uint32_t first, int mask, int lanes) {
+            for (int lane = 0; lane < lanes; lane++) {
+                visible[visibleCount] = first + lane;
+                visibleCount += (mask >> lane) & 1;
+            }
+            return visibleCount;
+        }
+
+        template <bool BOX>
+        uint32_t CullSSE(const Vector4* planes, const Bounds& bounds, uint32_t begin, uint32_t end, uint32_t* visible) {
+            __m128 normals[PLANE_COUNT][3], distances[PLANE_COUNT], absNormals[PLANE_COUNT][3];
+            for (int p = 0; p < PLANE_COUNT; p++) {
+                normals[p][0] = _mm_set1_ps(planes[p].x);
+                normals[p][1] = _mm_set1_ps(planes[p].y);
+                normals[p][2] = _mm_set1_ps(planes[p].z);
+                distances[p] = _mm_set1_ps(planes[p].w);
+                absNormals[p][0] = _mm_set1_ps(std::fabs(planes[p].x));
+                absNormals[p][1] = _mm_set1_ps(std::fabs(planes[p].y));
+                absNormals[p][2] = _mm_set1_ps(std::fabs(planes[p].z));
+            }
+            const __m128 signBit = _mm_set1_ps(-0.0f);
+
+            uint32_t visibleCount = 0;
+            uint32_t i = begin;
+            for (; i + 4 <= end; i += 4) {
+                const __m128 x = _mm_loadu_ps(bounds.x + i);
+                const __m128 y = _mm_loadu_ps(bounds.y + i);
+                const __m128 z = _mm_loadu_ps(bounds.z + i);
+                __m128 ex = _mm_setzero_ps(), ey = ex, ez = ex, negRadius = ex;
+                if (BOX) {
+                    ex = _mm_loadu_ps(bounds.extentX + i);
+                    ey = _mm_loadu_ps(bounds.extentY + i);
+                    ez = _mm_loadu_ps(bounds.extentZ + i);
+                } else {
+                    negRadius = _mm_xor_ps(_mm_loadu_ps(bounds.radius + i), signBit);
+                }
+
+                __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+                for (int p = 0; p < PLANE_COUNT; p++) {
+                    __m128 distance = _mm_add_ps(_mm_mul_ps(normals[p][0], x), _mm_mul_ps(normals[p][1], y));
+                    distance = _mm_add_ps(_mm_add_ps(distance, _mm_mul_ps(normals[p][2], z)), distances[p]);
+                    __m128 negReach = negRadius;
+                    if (BOX) {
+                        __m128 reach = _mm_add_ps(_mm_mul_ps(absNormals[p][0], ex), _mm_mul_ps(absNormals[p][1], ey));
+                        reach = _mm_add_ps(reach, _mm_mul_ps(absNormals[p][2], ez));
+                        negReach = _mm_xor_ps(reach, signBit);
+                    }
+                    inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, negReach));
+                }
+                visibleCount = AppendVisible(visible, visibleCount, i - begin, _mm_movemask_ps(inside), 4);
+            }
+            for (; i < end; i++) {
+                if (TestScalar<BOX>(planes, bounds, i)) visible[visibleCount++] = i - begin;
+            }
+            return visibleCount;
+        }
+
+        // Whole groups of 8 only, the caller finishes with the SSE version
+        template <bool BOX>
+        DS_TARGET("avx") uint32_t CullAVX(const Vector4* planes, const Bounds& bounds, uint32_t begin, uint32_t end,
+                                          uint32_t* visible) {
+            __m256 normals[PLANE_COUNT][3], distances[PLANE_COUNT], absNormals[PLANE_COUNT][3];
+            for (int p = 0; p < PLANE_COUNT; p++) {
+                normals[p][0] = _mm256_set1_ps(planes[p].x);
+                normals[p][1] = _mm256_set1_ps(planes[p].y);
+                normals[p][2] = _mm256_set1_ps(planes[p].z);
+                distances[p] = _mm256_set1_ps(planes[p].w);
+                absNormals[p][0] = _mm256_set1_ps(std::fabs(planes[p].x));
+                absNormals[p][1] = _mm256_set1_ps(std::fabs(planes[p].y));
+                absNormals[p][2] = _mm256_set1_ps(std::fabs(planes[p].z));
+            }
+            const __m256 signBit = _mm256_set1_ps(-0.0f);
+
+            uint32_t visibleCount = 0;
+            for (uint32_t i = begin; i + 8 <= end; i += 8) {
+                const __m256 x = _mm256_loadu_ps(bounds.x + i);
+                const __m256 y = _mm256_loadu_ps(bounds.y + i);
+                const __m256 z = _mm256_loadu_ps(bounds.z + i);
+                __m256 ex = _mm256_setzero_ps(), ey = ex, ez = ex, negRadius = ex;
+                if (BOX) {
+                    ex = _mm256_loadu_ps(bounds.extentX + i);
+                    ey = _mm256_loadu_ps(bounds.extentY + i);
+                    ez = _mm256_loadu_ps(bounds.extentZ + i);
+                } else {
+                    negRadius = _mm256_xor_ps(_mm256_loadu_ps(bounds.radius + i), signBit);
+                }
+
+                __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+                for (int p = 0; p < PLANE_COUNT; p++) {
+                    __m256 distance = _mm256_add_ps(_mm256_mul_ps(normals[p][0], x), _mm256_mul_ps(normals[p][1], y));
+                    distance = _mm256_add_ps(_mm256_add_ps(distance, _mm256_mul_ps(normals[p][2], z)), distances[p]);
+                    __m256 negReach = negRadius;
+                    if (BOX) {
+                        __m256 reach = _mm256_add_ps(_mm256_mul_ps(absNormals[p][0], ex), _mm256_mul_ps(absNormals[p][1], ey));
+                        reach = _mm256_add_ps(reach, _mm256_mul_ps(absNormals[p][2], ez));
+                        negReach = _mm256_xor_ps(reach, signBit);
+                    }
+                    inside = _mm256_and_ps(inside, _mm256_cmp_ps(distance, negReach, _CMP_GE_OQ));
+                }
+                visibleCount = AppendVisible(visible, visibleCount, i - begin, _mm256_movemask_ps(inside), 8);
+            }
+            return visibleCount;
+        }
+
+        // Culls [begin, end) into visible, indices relative to begin
+        template <bool BOX>
+        uint32_t CullRange(const Vector4* planes, const Bounds& bounds, uint32_t begin, uint32_t end, uint32_t* visible) {
+            uint32_t visibleCount = 0;
+            uint32_t sseBegin = begin;
+            if (s_hasAVX) {
+                sseBegin = begin + (end - begin) / 8 * 8;
+                visibleCount = CullAVX<BOX>(planes, bounds, begin, sseBegin, visible);
+            }
+            const uint32_t sseCount = CullSSE<BOX>(planes, bounds, sseBegin, end, visible + visibleCount);
+            for (uint32_t i = visibleCount; i < visibleCount + sseCount; i++) {
+                visible[i] += sseBegin - begin;
+            }
+            return visibleCount + sseCount;
+        }
+
+        template <bool BOX>
+        uint32_t Cull(const Vector4* planes, const Bounds& bounds, uint32_t count, uint32_t* visible, uint32_t maxThreads) {
+            const uint32_t chunkCount = (count + CHUNK_SIZE - 1) / CHUNK_SIZE;
+            if (maxThreads == 1 || chunkCount <= 1) {
+                return CullRange<BOX>(planes, bounds, 0, count, visible);
+            }
+
+            // Each chunk fills its own part of visible, then the parts are moved down next to each other
+            std::vector<uint32_t> chunkCounts(chunkCount);
+            DSThreadPool::Global().ParallelFor(chunkCount, [&](uint32_t chunk) {
+                const uint32_t begin = chunk * CHUNK_SIZE;
+                const uint32_t end = std::min(count, begin + CHUNK_SIZE);
+                uint32_t* chunkVisible = visible + begin;
+                chunkCounts[chunk] = CullRange<BOX>(planes, bounds, begin, end, chunkVisible);
+                for (uint32_t i = 0; i < chunkCounts[chunk]; i++) {
+                    chunkVisible[i] += begin;
+                }
+            }, maxThreads);
+
+            uint32_t visibleCount = chunkCounts[0];
+            for (uint32_t chunk = 1; chunk < chunkCount; chunk++) {
+                std::memmove(visible + visibleCount, visible + chunk * CHUNK_SIZE, chunkCounts[chunk] * sizeof(uint32_t));
+                visibleCount += chunkCounts[chunk];
+            }
+            return visibleCount;
+        }
+    }
+
+    DSFrustum::DSFrustum(const Matrix4x4& viewProjection, DepthRange depthRange) {
+        SetMatrix(viewProjection, depthRange);
+    }
+
+    void DSFrustum::SetMatrix(const Matrix4x4& viewProjection, DepthRange depthRange) {
+        // Rows of the matrix, clip space x, y, z and w of a point are their dot products with (p, 1)
+        Vector4 rows[4];
+        for (int row = 0; row < 4; row++) {
+            const float (&m)[4][4] = viewProjection.m;
+            rows[row] = Vector4(m[0][row], m[1][row], m[2][row], m[3][row]);
+        }
+
+        // -w <= x, y <= w, and -w <= z <= w or 0 <= z <= w
+        m_planes[static_cast<int>(Plane::Left)] = rows[3] + rows[0];
+        m_planes[static_cast<int>(Plane::Right)] = rows[3] - rows[0];
+        m_planes[static_cast<int>(Plane::Bottom)] = rows[3] + rows[1];
+        m_planes[static_cast<int>(Plane::Top)] = rows[3] - rows[1];
+        m_planes[static_cast<int>(Plane::Near)] = (depthRange == DepthRange::ZeroToOne) ? rows[2] : rows[3] + rows[2];
+        m_planes[static_cast<int>(Plane::Far)] = rows[3] - rows[2];
+
+        // A zero normal is left as it is, an infinite far plane then keeps everything
+        for (Vector4& plane : m_planes) {
+            const float length = std::sqrt(plane.x * plane.x + plane.y * plane.y + plane.z * plane.z);
+            if (length > 0.0f) plane = plane / length;
+        }
+    }
+
+    bool DSFrustum::TestPoint(const Vector3& point) const {
+        return TestSphere(point, 0.0f);
+    }
+
+    bool DSFrustum::TestSphere(const Vector3& center, float radius) const {
+        const Bounds bounds = { &center.x, &center.y, &center.z, &radius, nullptr, nullptr, nullptr };
+        return TestScalar<false>(m_planes, bounds, 0);
+    }
+
+    bool DSFrustum::TestAABB(const Vector3& center, const Vector3& extents) const {
+        const Bounds bounds = { &center.x, &center.y, &center.z, nullptr, &extents.x, &extents.y, &extents.z };
+        return TestScalar<true>(m_planes, bounds, 0);
+    }
+
+    uint32_t DSFrustum::CullSpheres(const float* x, const float* y, const float* z, const float* radius, uint32_t count,
+                                    uint32_t* visible, uint32_t maxThreads) const {
+        const Bounds bounds = { x, y, z, radius, nullptr, nullptr, nullptr };
+        return Cull<false>(m_planes, bounds, count, visible, maxThreads);
+    }
+
+    uint32_t DSFrustum::CullAABBs(const float* centerX, const float* centerY, const float* centerZ,
+                                  const float* extentX, const float* extentY, const float* extentZ, uint32_t count,
+                                  uint32_t* visible, uint32_t maxThreads) const {
+        const Bounds bounds = { centerX, centerY, centerZ, nullptr, extentX, extentY, extentZ };
+        return Cull<true>(m_planes, bounds, count, visible, maxThreads);
+    }
+}
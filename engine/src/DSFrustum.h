@@ -0,0 +1,78 @@
+#pragma once
+#include "Matrix4x4.h"
+#include "Vector3.h"
+#include "Vector4.h"
+#include <cstdint>
+
+namespace DSEngine {
+    /**
+     * View frustum as 6 planes taken from a view-projection matrix, with visibility tests for bounding spheres
+     * and axis-aligned boxes.
+     * Planes are normalized and face inwards: a point p is inside when dot(plane.xyz, p) + plane.w >= 0.
+     *
+     * The Cull functions test structure of arrays bounds 8 at a time with AVX (4 with SSE) and write the
+     * indices of the visible ones in increasing order. They can split the array across the global thread pool.
+     * Bounds are kept when they intersect every plane, so a few objects near the frustum corners pass
+     * without being visible. Bounds with NaN are culled.
+     */
+    class DSFrustum {
+    public:
+        enum class Plane {
+            Left,
+            Right,
+            Bottom,
+            Top,
+            Near,
+            Far,
+            Count
+        };
+
+        // Clip space depth range of the projection the planes are taken from
+        enum class DepthRange {
+            NegativeOneToOne,  // OpenGL style, Matrix4x4::Perspective and Orthographic
+            ZeroToOne          // Direct3D and Vulkan style
+        };
+
+        // Planes of zero, everything is visible
+        DSFrustum() = default;
+
+        /**
+         * @param viewProjection Projection * view for planes in world space, projection alone for view space.
+         * @param depthRange Depth range of the projection.
+         */
+        explicit DSFrustum(const Matrix4x4& viewProjection, DepthRange depthRange = DepthRange::NegativeOneToOne);
+
+        void SetMatrix(const Matrix4x4& viewProjection, DepthRange depthRange = DepthRange::NegativeOneToOne);
+
+        const Vector4& GetPlane(Plane plane) const { return m_planes[static_cast<int>(plane)]; }
+
+        bool TestPoint(const Vector3& point) const;
+        bool TestSphere(const Vector3& center, float radius) const;
+        // Box given by its center and half size on each axis
+        bool TestAABB(const Vector3& center, const Vector3& extents) const;
+
+        /**
+         * Culls spheres given as separate streams of centers and radii.
+         *
+         * @param visible Receives the indices of the visible spheres, must have room for count entries.
+         * @param maxThreads Threads working on the array (caller included), 0 means no limit. Small arrays are
+         *                   never split.
+         * @return The number of visible spheres.
+         */
+        uint32_t CullSpheres(const float* x, const float* y, const float* z, const float* radius, uint32_t count,
+                             uint32_t* visible, uint32_t maxThreads = 1) const;
+
+        /**
+         * Culls axis-aligned boxes given as separate streams of centers and half sizes.
+         * Same parameters as CullSpheres.
+         */
+        uint32_t CullAABBs(const float* centerX, const float* centerY, const float* centerZ,
+                           const float* extentX, const float* extentY, const float* extentZ, uint32_t count,
+                           uint32_t* visible, uint32_t maxThreads = 1) const;
+
+    private:
+        static constexpr int PLANE_COUNT = static_cast<int>(Plane::Count);
+
+        Vector4 m_planes[PLANE_COUNT];
+    };
+}
@@ -0,0 +1,188 @@
+#include "DSLZCodec.h"
+#include <cstring>
+#include <emmintrin.h>
+
+namespace DSEngine {
+    namespace {
+        const size_t MIN_MATCH = 4;
+        const size_t MAX_OFFSET = 65535;
+        const size_t LAST_LITERALS = 5;   // The stream always ends with at least this many literals
+        const size_t MATCH_START_LIMIT = 12;
+        const uint32_t HASH_BITS = 16;
+
+        inline uint32_t Read32(const uint8_t* p) {
+            uint32_t value;
+            std::memcpy(&value, p, sizeof(value));
+            return value;
+        }
+
+        inline uint32_t Hash(uint32_t sequence) {
+            return (sequence * 2654435761u) >> (32 - HASH_BITS);
+        }
+
+        inline void Copy16(uint8_t* dest, const uint8_t* source) {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dest), _mm_loadu_si128(reinterpret_cast<const __m128i*>(source)));
+        }
+
+        inline uint8_t* WriteLength(uint8_t* out, size_t length) {
+            while (length >= 255) {
+                *out++ = 255;
+                length -= 255;
+            }
+            *out++ = static_cast<uint8_t>(length);
+            return out;
+        }
+
+        // Reads the extra bytes of a length nibble equal to 15
+        inline bool ReadLength(const uint8_t*& in, const uint8_t* end, size_t& length) {
+            uint8_t value;
+            do {
+                if (in >= end) return false;
+                value = *in++;
+                length += value;
+            } while (value == 255);
+            return true;
+        }
+
+        uint8_t* WriteSequence(uint8_t* out, const uint8_t* literals, size_t literalLength,
+                               size_t offset, size_t matchLength) {
+            uint8_t* token = out++;
+            *token = static_cast<uint8_t>((literalLength >= 15 ? 15 : literalLength) << 4);
+            if (literalLength >= 15) out = WriteLength(out, literalLength - 15);
+
+            std::memcpy(out, literals, literalLength);
+            out += literalLength;
+
+            if (matchLength == 0) return out; // Last sequence, literals only
+
+            *out++ = static_cast<uint8_t>(offset & 0xFF);
+            *out++ = static_cast<uint8_t>(offset >> 8);
+
+            size_t code = matchLength - MIN_MATCH;
+            *token |= static_cast<uint8_t>(code >= 15 ? 15 : code);
+            if (code >= 15) out = WriteLength(out, code - 15);
+            return out;
+        }
+    }
+
+    void DSLZCodec::Compress(const uint8_t* source, size_t size, std::vector<uint8_t>& output) {
+        output.resize(GetMaxCompressedSize(size));
+        uint8_t* out = output.data();
+
+        size_t anchor = 0;
+        if (size > MATCH_START_LIMIT) {
+            std::vector<uint32_t> table(size_t(1) << HASH_BITS, 0);
+            const size_t searchLimit = size - MATCH_START_LIMIT;
+            const size_t matchLimit = size - LAST_LITERALS;
+
+            size_t pos = 0;
+            while (pos < searchLimit) {
+                const uint32_t sequence = Read32(source + pos);
+                const uint32_t hash = Hash(sequence);
+                const size_t candidate = table[hash];
+                table[hash] = static_cast<uint32_t>(pos);
+
+                if (candidate < pos && pos - candidate <= MAX_OFFSET && Read32(source + candidate) == sequence) {
+                    size_t length = MIN_MATCH;
+                    while (pos + length < matchLimit && source[candidate + length] == source[pos + length]) {
+                        length++;
+                    }
+
+                    out = WriteSequence(out, source + anchor, pos - anchor, pos - candidate, length);
+                    pos += length;
+                    anchor = pos;
+
+                    // Keep the table fresh inside long matches
+                    if (pos - 2 < searchLimit) {
+                        table[Hash(Read32(source + pos - 2))] = static_cast<uint32_t>(pos - 2);
+                    }
+                    continue;
+                }
+
+                // Skip faster through data that doesn't compress
+                pos += 1 + ((pos - anchor) >> 6);
+            }
+        }
+
+        out = WriteSequence(out, source + anchor, size - anchor, 0, 0);
+        output.resize(out - output.data());
+    }
+
+    bool DSLZCodec::Decompress(const uint8_t* source, size_t sourceSize, uint8_t* dest, size_t destSize) {
+        const uint8_t* in = source;
+        const uint8_t* const inEnd = source + sourceSize;
+        uint8_t* out = dest;
+        uint8_t* const outEnd = dest + destSize;
+
+        for (;;) {
+            if (in >= inEnd) return false;
+            const uint8_t token = *in++;
+
+            // Literals
+            size_t literalLength = token >> 4;
+            if (literalLength == 15 && !ReadLength(in, inEnd, literalLength)) return false;
+            if (literalLength > static_cast<size_t>(inEnd - in) || literalLength > static_cast<size_t>(outEnd - out)) return false;
+
+            if (literalLength <= 16 && inEnd - in >= 16 && outEnd - out >= 16) {
+                Copy16(out, in);
+            } else {
+                std::memcpy(out, in, literalLength);
+            }
+            in += literalLength;
+            out += literalLength;
+
+            if (in == inEnd) {
+                return out == outEnd; // The last sequence has no match
+            }
+
+            // Match
+            if (inEnd - in < 2) return false;
+            const size_t offset = in[0] | (in[1] << 8);
+            in += 2;
+            if (offset == 0 || offset > static_cast<size_t>(out - dest)) return false;
+
+            size_t matchLength = token & 0x0F;
+            if (matchLength == 15 && !ReadLength(in, inEnd, matchLength)) return false;
+            matchLength += MIN_MATCH;
+            if (matchLength > static_cast<size_t>(outEnd - out)) return false;
+
+            const uint8_t* match = out - offset;
+            uint8_t* const matchEnd = out + matchLength;
+
+            if (offset >= 16 && static_cast<size_t>(outEnd - out) >= matchLength + 15) {
+                // Chunks never overlap their source, the last one may write past matchEnd (still inside dest)
+                do {
+                    Copy16(out, match);
+                    out += 16;
+                    match += 16;
+                } while (out < matchEnd);
+            } else if (static_cast<size_t>(outEnd - out) >= matchLength + 7) {
+                // Widen short repeating patterns to a multiple of the offset of at least 8 bytes,
+                // then copy 8 bytes at a time
+                uint8_t* copyOut = out;
+                size_t distance = offset;
+                if (offset < 8) {
+                    distance = offset * ((8 + offset - 1) / offset);
+                    const size_t head = distance < matchLength ? distance : matchLength;
+                    for (size_t i = 0; i < head; i++) {
+                        copyOut[i] = match[i];
+                    }
+                    copyOut += head;
+                }
+
+                const uint8_t* copySource = copyOut - distance;
+                while (copyOut < matchEnd) {
+                    std::memcpy(copyOut, copySource, 8);
+                    copyOut += 8;
+                    copySource += 8;
+                }
+            } else {
+                // Close to the end of the buffer
+                while (out < matchEnd) {
+                    *out++ = *match++;
+                }
+            }
+            out = matchEnd;
+        }
+    }
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+namespace DSEngine {
+    /**
+     * Small self contained LZ77 byte codec (LZ4 style sequences: token, literals, 16-bit offset).
+     * Compression is greedy and meant for offline cooking; decompression is branch light and
+     * copies 16 bytes at a time, reaching several GB/s.
+     */
+    class DSLZCodec {
+    public:
+        /**
+         * Compresses a buffer.
+         *
+         * @param source Data to compress.
+         * @param size Size of the data in bytes.
+         * @param output Receives the compressed stream (resized to fit).
+         */
+        static void Compress(const uint8_t* source, size_t size, std::vector<uint8_t>& output);
+
+        /**
+         * Decompresses a stream produced by Compress. Malformed input never reads or writes out of bounds.
+         *
+         * @param source Compressed stream.
+         * @param sourceSize Size of the compressed stream.
+         * @param dest Output buffer.
+         * @param destSize Exact decompressed size.
+         * @return false if the stream is corrupt or doesn't decode to exactly destSize bytes.
+         */
+        static bool Decompress(const uint8_t* source, size_t sourceSize, uint8_t* dest, size_t destSize);
+
+        static size_t GetMaxCompressedSize(size_t size) { return size + size / 255 + 16; }
+    };
+}
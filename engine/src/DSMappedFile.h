@@ -0,0 +1,41 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+namespace DSEngine {
+    /**
+     * Read-only memory mapping of a whole file. Pages are only committed by the OS
+     * when they are first touched.
+     */
+    class DSMappedFile {
+    public:
+        DSMappedFile() = default;
+        ~DSMappedFile();
+
+        DSMappedFile(const DSMappedFile&) = delete;
+        DSMappedFile& operator=(const DSMappedFile&) = delete;
+
+        /**
+         * Maps the file, closing any previous mapping.
+         *
+         * @param path The file to map.
+         * @return false if the file can't be opened, is empty or can't be mapped.
+         */
+        bool Open(const std::string& path);
+
+        void Close();
+
+        bool IsOpen() const { return m_data != nullptr; }
+        const uint8_t* GetData() const { return m_data; }
+        size_t GetSize() const { return m_size; }
+
+    private:
+        const uint8_t* m_data = nullptr;
+        size_t m_size = 0;
+#ifdef _WIN32
+        void* m_file = nullptr;
+        void* m_mapping = nullptr;
+#endif
+    };
+}
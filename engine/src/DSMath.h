@@ -3,6 +3,7 @@
 #include <immintrin.h> // AVX/SSE intrinsics
 #include <xmmintrin.h>
 #include <emmintrin.h>
+#include "DSCpu.h"
 
 namespace Mathf {
     // Platform detection
@@ -22,15 +23,359 @@ namespace Mathf {
     // Constants
 #define MATH_PI 3.14159265358979323846f
 #define MATH_EPSILON 1.192092896e-07f
+#define MATH_FLOAT_MIN 1.175494351e-38f  // Smallest normal float
 #define MATH_DEG_TO_RAD (MATH_PI / 180.0f)
 #define MATH_RAD_TO_DEG (180.0f / MATH_PI)
 
 
     // Common functions
     FORCE_INLINE float Sqrt(float x) { return sqrtf(x); }
-    FORCE_INLINE float InvSqrt(float x) { return 1.0f / sqrtf(x); } // TODO: Fast inverse sqrt
+
+    // =====================
+    // Fast approximations
+    // =====================
+
+    // Polynomials after a range reduction, 4 values at a time with SSE2 and 8 with AVX2 (check DSCpu::HasAVX2
+    // before calling those). No FMA is used, so both widths give the same result for the same input. The scalar
+    // versions stay on libm, only InvSqrt has a scalar approximation (one lane of the SSE code).
+    // Largest errors measured against double precision:
+    //   InvSqrt    relative 2.5e-7 (x must be a positive normal float: 0, denormals and infinity give NaN)
+    //   Sin, Cos   absolute 1e-7 for |x| <= 8192, NaN above (the range reduction is only exact up to there)
+    //   Tan        relative 4.1e-6 for |x| <= 8192, sine / cosine, NaN above
+    //   Atan2      absolute 2.7e-7, atan2(0, 0) is 0, infinite inputs give NaN
+    //   Exp        relative 1e-7, infinity above 88.376 (libm stays finite up to 88.72), 0 below -87.336
+    //   Log        relative 1e-7, absolute 3e-8 for x in [0.6, 1.6], -infinity for 0, NaN for negative values,
+    //              denormals are read as MATH_FLOAT_MIN
+    // NaN inputs give NaN.
+    namespace Internal {
+        // Largest |x| given to the Sin and Cos reduction
+        constexpr float SIN_COS_RANGE = 8192.0f;
+        // Cody-Waite split of pi / 2, q * PIO2_1 is exact for |q| < 2^16
+        constexpr float PIO2_1 = 1.5703125f;
+        constexpr float PIO2_2 = 4.837512969970703125e-4f;
+        constexpr float PIO2_3 = 7.54978995489188216e-8f;
+        constexpr float TWO_OVER_PI = 0.636619772367581343f;
+        // Minimax polynomials on [-pi/4, pi/4] (Cephes sinf, cosf)
+        constexpr float SIN_1 = -1.6666654611e-1f;
+        constexpr float SIN_2 = 8.3321608736e-3f;
+        constexpr float SIN_3 = -1.9515295891e-4f;
+        constexpr float COS_1 = 4.166664568298827e-2f;
+        constexpr float COS_2 = -1.388731625493765e-3f;
+        constexpr float COS_3 = 2.443315711809948e-5f;
+
+        // atan on [-tan(pi/8), tan(pi/8)] (Cephes atanf)
+        constexpr float TAN_PI_8 = 0.414213562373095f;
+        constexpr float ATAN_1 = -3.33329491539e-1f;
+        constexpr float ATAN_2 = 1.99777106478e-1f;
+        constexpr float ATAN_3 = -1.38776856032e-1f;
+        constexpr float ATAN_4 = 8.05374449538e-2f;
+
+        // exp(r) on [-ln(2) / 2, ln(2) / 2] (Cephes expf), ln(2) split so n * LN2_HIGH is exact
+        constexpr float LOG2_E = 1.44269504088896341f;
+        constexpr float LN2_HIGH = 0.693359375f;
+        constexpr float LN2_LOW = -2.12194440e-4f;
+        constexpr float EXP_HIGH = 88.3762626647949f;   // Keeps 2^n finite
+        constexpr float EXP_LOW = -87.3365447505531f;   // ln(MATH_FLOAT_MIN)
+        constexpr float EXP_1 = 5.0000001201e-1f;
+        constexpr float EXP_2 = 1.6666665459e-1f;
+        constexpr float EXP_3 = 4.1665795894e-2f;
+        constexpr float EXP_4 = 8.3334519073e-3f;
+        constexpr float EXP_5 = 1.3981999507e-3f;
+        constexpr float EXP_6 = 1.9875691500e-4f;
+
+        // log(1 + m) for 1 + m in [sqrt(1/2), sqrt(2)] (Cephes logf)
+        constexpr float SQRT_HALF = 0.707106781186547524f;
+        constexpr float LOG_COEFFICIENTS[9] = {
+            7.0376836292e-2f, -1.1514610310e-1f, 1.1676998740e-1f, -1.2420140846e-1f, 1.4249322787e-1f,
+            -1.6668057665e-1f, 2.0000714765e-1f, -2.4999993993e-1f, 3.3333331174e-1f
+        };
+
+        FORCE_INLINE __m128 Select(__m128 mask, __m128 a, __m128 b) {
+            return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+        }
+
+        DS_TARGET("avx2") FORCE_INLINE __m256 Select(__m256 mask, __m256 a, __m256 b) {
+            return _mm256_blendv_ps(b, a, mask);
+        }
+    }
+
+    // 1 / sqrt(x): the hardware estimate and one Newton-Raphson step
+    FORCE_INLINE __m128 InvSqrt(__m128 x) {
+        const __m128 y = _mm_rsqrt_ps(x);
+        const __m128 halfX = _mm_mul_ps(_mm_set1_ps(0.5f), x);
+        return _mm_mul_ps(y, _mm_sub_ps(_mm_set1_ps(1.5f), _mm_mul_ps(halfX, _mm_mul_ps(y, y))));
+    }
+
+    FORCE_INLINE void SinCos(__m128 x, __m128& sine, __m128& cosine) {
+        using namespace Internal;
+        // x = q * pi / 2 + r with |r| <= pi / 4
+        const __m128i quadrant = _mm_cvtps_epi32(_mm_mul_ps(x, _mm_set1_ps(TWO_OVER_PI)));
+        const __m128 q = _mm_cvtepi32_ps(quadrant);
+        __m128 r = _mm_sub_ps(x, _mm_mul_ps(q, _mm_set1_ps(PIO2_1)));
+        r = _mm_sub_ps(r, _mm_mul_ps(q, _mm_set1_ps(PIO2_2)));
+        r = _mm_sub_ps(r, _mm_mul_ps(q, _mm_set1_ps(PIO2_3)));
+        const __m128 r2 = _mm_mul_ps(r, r);
+
+        // sin(r) = r + r^3 * (S1 + r^2 * (S2 + r^2 * S3)), cos(r) = 1 - r^2 / 2 + r^4 * (C1 + r^2 * (C2 + r^2 * C3))
+        __m128 s = _mm_add_ps(_mm_set1_ps(SIN_2), _mm_mul_ps(r2, _mm_set1_ps(SIN_3)));
+        s = _mm_add_ps(_mm_set1_ps(SIN_1), _mm_mul_ps(r2, s));
+        s = _mm_add_ps(r, _mm_mul_ps(_mm_mul_ps(r2, r), s));
+        __m128 c = _mm_add_ps(_mm_set1_ps(COS_2), _mm_mul_ps(r2, _mm_set1_ps(COS_3)));
+        c = _mm_add_ps(_mm_set1_ps(COS_1), _mm_mul_ps(r2, c));
+        c = _mm_add_ps(_mm_sub_ps(_mm_set1_ps(1.0f), _mm_mul_ps(_mm_set1_ps(0.5f), r2)), _mm_mul_ps(_mm_mul_ps(r2, r2), c));
+
+        // Odd quadrants swap sin and cos, sin is negated in quadrants 2 and 3, cos in 1 and 2
+        const __m128i one = _mm_set1_epi32(1), two = _mm_set1_epi32(2);
+        const __m128 swap = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(quadrant, one), one));
+        const __m128 sineSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(quadrant, two), 30));
+        const __m128 cosineSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(_mm_add_epi32(quadrant, one), two), 30));
+        const __m128 outOfRange = _mm_cmpgt_ps(_mm_andnot_ps(_mm_set1_ps(-0.0f), x), _mm_set1_ps(SIN_COS_RANGE));
+        sine = _mm_or_ps(_mm_xor_ps(Internal::Select(swap, c, s), sineSign), outOfRange);
+        cosine = _mm_or_ps(_mm_xor_ps(Internal::Select(swap, s, c), cosineSign), outOfRange);
+    }
+
+    FORCE_INLINE __m128 Sin(__m128 x) {
+        __m128 sine, cosine;
+        SinCos(x, sine, cosine);
+        return sine;
+    }
+
+    FORCE_INLINE __m128 Cos(__m128 x) {
+        __m128 sine, cosine;
+        SinCos(x, sine, cosine);
+        return cosine;
+    }
+
+    FORCE_INLINE __m128 Tan(__m128 x) {
+        __m128 sine, cosine;
+        SinCos(x, sine, cosine);
+        return _mm_div_ps(sine, cosine);
+    }
+
+    FORCE_INLINE __m128 Atan2(__m128 y, __m128 x) {
+        using namespace Internal;
+        const __m128 signBit = _mm_set1_ps(-0.0f);
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 absX = _mm_andnot_ps(signBit, x), absY = _mm_andnot_ps(signBit, y);
+        const __m128 low = _mm_min_ps(absX, absY), high = _mm_max_ps(absX, absY);
+
+        // atan(low / high) is in [0, pi/4], above tan(pi/8) it is pi/4 + atan((low - high) / (low + high))
+        const __m128 upper = _mm_cmpgt_ps(low, _mm_mul_ps(high, _mm_set1_ps(TAN_PI_8)));
+        const __m128 numerator = Select(upper, _mm_sub_ps(low, high), low);
+        __m128 denominator = Select(upper, _mm_add_ps(low, high), high);
+        denominator = Select(_mm_cmpeq_ps(denominator, zero), _mm_set1_ps(1.0f), denominator);
+        const __m128 a = _mm_div_ps(numerator, denominator);
+        const __m128 z = _mm_mul_ps(a, a);
+
+        __m128 p = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(ATAN_4), z), _mm_set1_ps(ATAN_3));
+        p = _mm_add_ps(_mm_mul_ps(p, z), _mm_set1_ps(ATAN_2));
+        p = _mm_add_ps(_mm_mul_ps(p, z), _mm_set1_ps(ATAN_1));
+        __m128 result = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(p, z), a), a);
+        result = _mm_add_ps(result, _mm_and_ps(upper, _mm_set1_ps(MATH_PI * 0.25f)));
+
+        // Back to the octant of (x, y), the sign of x is used so atan2(0, -0) is pi
+        result = Select(_mm_cmpgt_ps(absY, absX), _mm_sub_ps(_mm_set1_ps(MATH_PI * 0.5f), result), result);
+        const __m128 negativeX = _mm_castsi128_ps(_mm_srai_epi32(_mm_castps_si128(x), 31));
+        result = Select(negativeX, _mm_sub_ps(_mm_set1_ps(MATH_PI), result), result);
+        result = _mm_or_ps(result, _mm_and_ps(y, signBit));
+        return _mm_or_ps(result, _mm_cmpunord_ps(x, y));
+    }
+
+    FORCE_INLINE __m128 Exp(__m128 x) {
+        using namespace Internal;
+        // min and max return their second operand for NaN, which keeps it
+        const __m128 clamped = _mm_max_ps(_mm_set1_ps(EXP_LOW), _mm_min_ps(_mm_set1_ps(EXP_HIGH), x));
+
+        // exp(x) = 2^n * exp(r) with x = n * ln(2) + r
+        const __m128i n = _mm_cvtps_epi32(_mm_mul_ps(clamped, _mm_set1_ps(LOG2_E)));
+        const __m128 fn = _mm_cvtepi32_ps(n);
+        __m128 r = _mm_sub_ps(clamped, _mm_mul_ps(fn, _mm_set1_ps(LN2_HIGH)));
+        r = _mm_sub_ps(r, _mm_mul_ps(fn, _mm_set1_ps(LN2_LOW)));
+
+        __m128 p = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(EXP_6), r), _mm_set1_ps(EXP_5));
+        p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(EXP_4));
+        p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(EXP_3));
+        p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(EXP_2));
+        p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(EXP_1));
+        p = _mm_add_ps(_mm_add_ps(_mm_mul_ps(p, _mm_mul_ps(r, r)), r), _mm_set1_ps(1.0f));
+
+        const __m128 scale = _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(n, _mm_set1_epi32(127)), 23));
+        __m128 result = _mm_mul_ps(p, scale);
+        result = _mm_and_ps(result, _mm_cmpnlt_ps(x, _mm_set1_ps(EXP_LOW)));
+        return Select(_mm_cmpgt_ps(x, _mm_set1_ps(EXP_HIGH)), _mm_set1_ps(INFINITY), result);
+    }
+
+    FORCE_INLINE __m128 Log(__m128 x) {
+        using namespace Internal;
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 invalid = _mm_cmpnge_ps(x, zero);
+        const __m128 isZero = _mm_cmpeq_ps(x, zero);
+        const __m128 isInfinite = _mm_cmpeq_ps(x, _mm_set1_ps(INFINITY));
+
+        // x = 2^e * m with m in [0.5, 1), then m in [sqrt(1/2), sqrt(2)) minus 1
+        const __m128i bits = _mm_castps_si128(_mm_max_ps(x, _mm_set1_ps(MATH_FLOAT_MIN)));
+        __m128 e = _mm_cvtepi32_ps(_mm_sub_epi32(_mm_srli_epi32(bits, 23), _mm_set1_epi32(126)));
+        __m128 m = _mm_castsi128_ps(_mm_or_si128(_mm_and_si128(bits, _mm_set1_epi32(0x007FFFFF)), _mm_set1_epi32(0x3F000000)));
+        const __m128 small = _mm_cmplt_ps(m, _mm_set1_ps(SQRT_HALF));
+        e = _mm_sub_ps(e, _mm_and_ps(small, _mm_set1_ps(1.0f)));
+        m = _mm_add_ps(_mm_sub_ps(m, _mm_set1_ps(1.0f)), _mm_and_ps(small, m));
+        const __m128 z = _mm_mul_ps(m, m);
+
+        __m128 p = _mm_set1_ps(LOG_COEFFICIENTS[0]);
+        for (int i = 1; i < 9; i++) {
+            p = _mm_add_ps(_mm_mul_ps(p, m), _mm_set1_ps(LOG_COEFFICIENTS[i]));
+        }
+        __m128 y = _mm_mul_ps(_mm_mul_ps(p, m), z);
+        y = _mm_add_ps(y, _mm_mul_ps(e, _mm_set1_ps(LN2_LOW)));
+        y = _mm_sub_ps(y, _mm_mul_ps(_mm_set1_ps(0.5f), z));
+        __m128 result = _mm_add_ps(_mm_add_ps(m, y), _mm_mul_ps(e, _mm_set1_ps(LN2_HIGH)));
+
+        result = Select(isInfinite, x, result);
+        result = Select(isZero, _mm_set1_ps(-INFINITY), result);
+        return _mm_or_ps(result, invalid);
+    }
+
+    // 8-wide versions, the same operations as the 4-wide ones
+    DS_TARGET("avx2") FORCE_INLINE __m256 InvSqrt(__m256 x) {
+        const __m256 y = _mm256_rsqrt_ps(x);
+        const __m256 halfX = _mm256_mul_ps(_mm256_set1_ps(0.5f), x);
+        return _mm256_mul_ps(y, _mm256_sub_ps(_mm256_set1_ps(1.5f), _mm256_mul_ps(halfX, _mm256_mul_ps(y, y))));
+    }
+
+    DS_TARGET("avx2") FORCE_INLINE void SinCos(__m256 x, __m256& sine, __m256& cosine) {
+        using namespace Internal;
+        const __m256i quadrant = _mm256_cvtps_epi32(_mm256_mul_ps(x, _mm256_set1_ps(TWO_OVER_PI)));
+        const __m256 q = _mm256_cvtepi32_ps(quadrant);
+        __m256 r = _mm256_sub_ps(x, _mm256_mul_ps(q, _mm256_set1_ps(PIO2_1)));
+        r = _mm256_sub_ps(r, _mm256_mul_ps(q, _mm256_set1_ps(PIO2_2)));
+        r = _mm256_sub_ps(r, _mm256_mul_ps(q, _mm256_set1_ps(PIO2_3)));
+        const __m256 r2 = _mm256_mul_ps(r, r);
+
+        __m256 s = _mm256_add_ps(_mm256_set1_ps(SIN_2), _mm256_mul_ps(r2, _mm256_set1_ps(SIN_3)));
+        s = _mm256_add_ps(_mm256_set1_ps(SIN_1), _mm256_mul_ps(r2, s));
+        s = _mm256_add_ps(r, _mm256_mul_ps(_mm256_mul_ps(r2, r), s));
+        __m256 c = _mm256_add_ps(_mm256_set1_ps(COS_2), _mm256_mul_ps(r2, _mm256_set1_ps(COS_3)));
+        c = _mm256_add_ps(_mm256_set1_ps(COS_1), _mm256_mul_ps(r2, c));
+        c = _mm256_add_ps(_mm256_sub_ps(_mm256_set1_ps(1.0f), _mm256_mul_ps(_mm256_set1_ps(0.5f), r2)),
+                          _mm256_mul_ps(_mm256_mul_ps(r2, r2), c));
+
+        const __m256i one = _mm256_set1_epi32(1), two = _mm256_set1_epi32(2);
+        const __m256 swap = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(quadrant, one), one));
+        const __m256 sineSign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(quadrant, two), 30));
+        const __m256 cosineSign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(_mm256_add_epi32(quadrant, one), two), 30));
+        const __m256 outOfRange = _mm256_cmp_ps(_mm256_andnot_ps(_mm256_set1_ps(-0.0f), x), _mm256_set1_ps(SIN_COS_RANGE), _CMP_GT_OQ);
+        sine = _mm256_or_ps(_mm256_xor_ps(Internal::Select(swap, c, s), sineSign), outOfRange);
+        cosine = _mm256_or_ps(_mm256_xor_ps(Internal::Select(swap, s, c), cosineSign), outOfRange);
+    }
+
+    DS_TARGET("avx2") FORCE_INLINE __m256 Sin(__m256 x) {
+        __m256 sine, cosine;
+        SinCos(x, sine, cosine);
+        return sine;
+    }
+
+    DS_TARGET("avx2") FORCE_INLINE __m256 Cos(__m256 x) {
+        __m256 sine, cosine;
+        SinCos(x, sine, cosine);
+        return cosine;
+    }
+
+    DS_TARGET("avx2") FORCE_INLINE __m256 Tan(__m256 x) {
+        __m256 sine, cosine;
+        SinCos(x, sine, cosine);
+        return _mm256_div_ps(sine, cosine);
+    }
+
+    DS_TARGET("avx2") FORCE_INLINE __m256 Atan2(__m256 y, __m256 x) {
+        using namespace Internal;
+        const __m256 signBit = _mm256_set1_ps(-0.0f);
+        const __m256 zero = _mm256_setzero_ps();
+        const __m256 absX = _mm256_andnot_ps(signBit, x), absY = _mm256_andnot_ps(signBit, y);
+        const __m256 low = _mm256_min_ps(absX, absY), high = _mm256_max_ps(absX, absY);
+
+        const __m256 upper = _mm256_cmp_ps(low, _mm256_mul_ps(high, _mm256_set1_ps(TAN_PI_8)), _CMP_GT_OQ);
+        const __m256 numerator = Select(upper, _mm256_sub_ps(low, high), low);
+        __m256 denominator = Select(upper, _mm256_add_ps(low, high), high);
+        denominator = Select(_mm256_cmp_ps(denominator, zero, _CMP_EQ_OQ), _mm256_set1_ps(1.0f), denominator);
+        const __m256 a = _mm256_div_ps(numerator, denominator);
+        const __m256 z = _mm256_mul_ps(a, a);
+
+        __m256 p = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(ATAN_4), z), _mm256_set1_ps(ATAN_3));
+        p = _mm256_add_ps(_mm256_mul_ps(p, z), _mm256_set1_ps(ATAN_2));
+        p = _mm256_add_ps(_mm256_mul_ps(p, z), _mm256_set1_ps(ATAN_1));
+        __m256 result = _mm256_add_ps(_mm256_mul_ps(_mm256_mul_ps(p, z), a), a);
+        result = _mm256_add_ps(result, _mm256_and_ps(upper, _mm256_set1_ps(MATH_PI * 0.25f)));
+
+        result = Select(_mm256_cmp_ps(absY, absX, _CMP_GT_OQ), _mm256_sub_ps(_mm256_set1_ps(MATH_PI * 0.5f), result), result);
+        const __m256 negativeX = _mm256_castsi256_ps(_mm256_srai_epi32(_mm256_castps_si256(x), 31));
+        result = Select(negativeX, _mm256_sub_ps(_mm256_set1_ps(MATH_PI), result), result);
+        result = _mm256_or_ps(result, _mm256_and_ps(y, signBit));
+        return _mm256_or_ps(result, _mm256_cmp_ps(x, y, _CMP_UNORD_Q));
+    }
+
+    DS_TARGET("avx2") FORCE_INLINE __m256 Exp(__m256 x) {
+        using namespace Internal;
+        const __m256 clamped = _mm256_max_ps(_mm256_set1_ps(EXP_LOW), _mm256_min_ps(_mm256_set1_ps(EXP_HIGH), x));
+
+        const __m256i n = _mm256_cvtps_epi32(_mm256_mul_ps(clamped, _mm256_set1_ps(LOG2_E)));
+        const __m256 fn = _mm256_cvtepi32_ps(n);
+        __m256 r = _mm256_sub_ps(clamped, _mm256_mul_ps(fn, _mm256_set1_ps(LN2_HIGH)));
+        r = _mm256_sub_ps(r, _mm256_mul_ps(fn, _mm256_set1_ps(LN2_LOW)));
+
+        __m256 p = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(EXP_6), r), _mm256_set1_ps(EXP_5));
+        p = _mm256_add_ps(_mm256_mul_ps(p, r), _mm256_set1_ps(EXP_4));
+        p = _mm256_add_ps(_mm256_mul_ps(p, r), _mm256_set1_ps(EXP_3));
+        p = _mm256_add_ps(_mm256_mul_ps(p, r), _mm256_set1_ps(EXP_2));
+        p = _mm256_add_ps(_mm256_mul_ps(p, r), _mm256_set1_ps(EXP_1));
+        p = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(p, _mm256_mul_ps(r, r)), r), _mm256_set1_ps(1.0f));
+
+        const __m256 scale = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_add_epi32(n, _mm256_set1_epi32(127)), 23));
+        __m256 result = _mm256_mul_ps(p, scale);
+        result = _mm256_and_ps(result, _mm256_cmp_ps(x, _mm256_set1_ps(EXP_LOW), _CMP_NLT_UQ));
+        return Select(_mm256_cmp_ps(x, _mm256_set1_ps(EXP_HIGH), _CMP_GT_OQ), _mm256_set1_ps(INFINITY), result);
+    }
+
+    DS_TARGET("avx2") FORCE_INLINE __m256 Log(__m256 x) {
+        using namespace Internal;
+        const __m256 zero = _mm256_setzero_ps();
+        const __m256 invalid = _mm256_cmp_ps(x, zero, _CMP_NGE_UQ);
+        const __m256 isZero = _mm256_cmp_ps(x, zero, _CMP_EQ_OQ);
+        const __m256 isInfinite = _mm256_cmp_ps(x, _mm256_set1_ps(INFINITY), _CMP_EQ_OQ);
+
+        const __m256i bits = _mm256_castps_si256(_mm256_max_ps(x, _mm256_set1_ps(MATH_FLOAT_MIN)));
+        __m256 e = _mm256_cvtepi32_ps(_mm256_sub_epi32(_mm256_srli_epi32(bits, 23), _mm256_set1_epi32(126)));
+        __m256 m = _mm256_castsi256_ps(_mm256_or_si256(_mm256_and_si256(bits, _mm256_set1_epi32(0x007FFFFF)),
+                                                       _mm256_set1_epi32(0x3F000000)));
+        const __m256 small = _mm256_cmp_ps(m, _mm256_set1_ps(SQRT_HALF), _CMP_LT_OQ);
+        e = _mm256_sub_ps(e, _mm256_and_ps(small, _mm256_set1_ps(1.0f)));
+        m = _mm256_add_ps(_mm256_sub_ps(m, _mm256_set1_ps(1.0f)), _mm256_and_ps(small, m));
+        const __m256 z = _mm256_mul_ps(m, m);
+
+        __m256 p = _mm256_set1_ps(LOG_COEFFICIENTS[0]);
+        for (int i = 1; i < 9; i++) {
+            p = _mm256_add_ps(_mm256_mul_ps(p, m), _mm256_set1_ps(LOG_COEFFICIENTS[i]));
+        }
+        __m256 y = _mm256_mul_ps(_mm256_mul_ps(p, m), z);
+        y = _mm256_add_ps(y, _mm256_mul_ps(e, _mm256_set1_ps(LN2_LOW)));
+        y = _mm256_sub_ps(y, _mm256_mul_ps(_mm256_set1_ps(0.5f), z));
+        __m256 result = _mm256_add_ps(_mm256_add_ps(m, y), _mm256_mul_ps(e, _mm256_set1_ps(LN2_HIGH)));
+
+        result = Select(isInfinite, x, result);
+        result = Select(isZero, _mm256_set1_ps(-INFINITY), result);
+        return _mm256_or_ps(result, invalid);
+    }
+
+    // Scalar versions
+    FORCE_INLINE float InvSqrt(float x) { return _mm_cvtss_f32(InvSqrt(_mm_set_ss(x))); }
     FORCE_INLINE float Sin(float x) { return sinf(x); }
     FORCE_INLINE float Cos(float x) { return cosf(x); }
     FORCE_INLINE float Tan(float x) { return tanf(x); }
+    FORCE_INLINE float Atan2(float y, float x) { return atan2f(y, x); }
+    FORCE_INLINE float Exp(float x) { return expf(x); }
+    FORCE_INLINE float Log(float x) { return logf(x); }
 
-}
\ No newline at end of file
+    FORCE_INLINE void SinCos(float x, float& sine, float& cosine) {
+        sine = sinf(x);
+        cosine = cosf(x);
+    }
+}
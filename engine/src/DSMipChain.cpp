@@ -0,0 +1,22 @@
+#include "DSMipChain.h"
+
+namespace DSEngine {
+    void DSMipChain::Allocate(const std::vector<size_t>& levelSizes) {
+        m_sizes = levelSizes;
+        m_offsets.resize(levelSizes.size());
+
+        size_t totalSize = 0;
+        for (size_t i = 0; i < levelSizes.size(); ++i) {
+            m_offsets[i] = totalSize;
+            totalSize += (levelSizes[i] + DSBufferPool::ALIGNMENT - 1) & ~(DSBufferPool::ALIGNMENT - 1);
+        }
+
+        m_buffer.Resize(totalSize);
+    }
+
+    void DSMipChain::Reset() {
+        m_buffer.Reset();
+        m_offsets.clear();
+        m_sizes.clear();
+    }
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include "DSBufferPool.h"
+#include <vector>
+
+namespace DSEngine {
+    /**
+     * Storage for a whole mip chain in a single pooled allocation. Levels are laid out one after the
+     * other, each starting on a DSBufferPool::ALIGNMENT boundary, and found through an offset table.
+     * Levels can be empty (not resident or stored elsewhere).
+     */
+    class DSMipChain {
+    public:
+        DSMipChain() = default;
+        DSMipChain(DSMipChain&&) noexcept = default;
+        DSMipChain& operator=(DSMipChain&&) noexcept = default;
+        DSMipChain(const DSMipChain&) = delete;
+        DSMipChain& operator=(const DSMipChain&) = delete;
+
+        /**
+         * Lays out the chain, previous contents are lost.
+         *
+         * @param levelSizes Size in bytes of each level, 0 for levels without storage.
+         */
+        void Allocate(const std::vector<size_t>& levelSizes);
+        void Reset();
+
+        uint32_t GetLevelCount() const { return static_cast<uint32_t>(m_sizes.size()); }
+        uint8_t* GetLevel(uint32_t level) const { return m_sizes[level] ? m_buffer.Data() + m_offsets[level] : nullptr; }
+        size_t GetLevelSize(uint32_t level) const { return m_sizes[level]; }
+        size_t GetTotalSize() const { return m_buffer.Size(); }
+
+    private:
+        DSBufferPool::Buffer m_buffer;
+        std::vector<size_t> m_offsets;
+        std::vector<size_t> m_sizes;
+    };
+}
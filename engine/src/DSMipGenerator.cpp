@@ -0,0 +1,507 @@
+#include "DSMipGenerator.h"
+#include "DSThreadPool.h"
+#include "DSCpu.h"
+#include "DSMath.h"
+#include "DSBufferPool.h"
+#include "DSFloatConverter.h"
+#include <immintrin.h>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace DSEngine {
+    namespace {
+        const uint32_t TILE_ROWS = 32;
+        const float KAISER_RADIUS = 3.0f;  // In destination pixels
+        const float KAISER_ALPHA = 4.0f;
+
+        struct ColorTables {
+            float toLinear[256];    // sRGB byte to linear float
+            float toUnorm[256];     // Linear byte to float
+            uint8_t toSRGB[65536];  // Linear value (16-bit fixed point) to sRGB byte
+        };
+
+        const ColorTables& GetColorTables() {
+            static const ColorTables* tables = []() {
+                auto* result = new ColorTables();
+                for (int i = 0; i < 256; i++) {
+                    float c = i / 255.0f;
+                    result->toLinear[i] = (c <= 0.04045f) ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+                    result->toUnorm[i] = c;
+                }
+                for (int i = 0; i < 65536; i++) {
+                    float l = i / 65535.0f;
+                    float c = (l <= 0.0031308f) ? l * 12.92f : 1.055f * std::pow(l, 1.0f / 2.4f) - 0.055f;
+                    result->toSRGB[i] = static_cast<uint8_t>(std::min(255.0f, c * 255.0f + 0.5f));
+                }
+                return result;
+            }();
+            return *tables;
+        }
+
+        // Per output coordinate list of (source index, weight) pairs
+        struct FilterTaps {
+            std::vector<uint32_t> offset; // First tap of each output, offset.size() == outputs + 1
+            std::vector<uint32_t> index;
+            std::vector<float> weight;
+        };
+
+        void AddTap(FilterTaps& taps, int index, uint32_t size, float weight) {
+            taps.index.push_back(static_cast<uint32_t>(std::min(std::max(index, 0), static_cast<int>(size) - 1)));
+            taps.weight.push_back(weight);
+        }
+
+        void NormalizeLastOutput(FilterTaps& taps) {
+            float sum = 0.0f;
+            for (uint32_t i = taps.offset.back(); i < taps.weight.size(); i++) sum += taps.weight[i];
+            for (uint32_t i = taps.offset.back(); i < taps.weight.size(); i++) taps.weight[i] /= sum;
+            taps.offset.push_back(static_cast<uint32_t>(taps.weight.size()));
+        }
+
+        // Area weighted box, exact 2x2 average on even sizes
+        FilterTaps BuildBoxTaps(uint32_t inSize, uint32_t outSize) {
+            FilterTaps taps;
+            taps.offset.push_back(0);
+            const float ratio = static_cast<float>(inSize) / outSize;
+
+            for (uint32_t x = 0; x < outSize; x++) {
+                const float start = x * ratio;
+                const float end = start + ratio;
+                for (int i = static_cast<int>(start); i < static_cast<int>(std::ceil(end)); i++) {
+                    float overlap = std::min(i + 1.0f, end) - std::max(static_cast<float>(i), start);
+                    if (overlap > 0.0f) AddTap(taps, i, inSize, overlap);
+                }
+                NormalizeLastOutput(taps);
+            }
+            return taps;
+        }
+
+        float BesselI0(float x) {
+            float sum = 1.0f, term = 1.0f;
+            for (int k = 1; k < 20; k++) {
+                term *= (x / (2.0f * k)) * (x / (2.0f * k));
+                sum += term;
+            }
+            return sum;
+        }
+
+        float KaiserSinc(float t) {
+            const float window = t / KAISER_RADIUS;
+            if (std::fabs(window) >= 1.0f) return 0.0f;
+
+            const float sinc = (t == 0.0f) ? 1.0f : std::sin(MATH_PI * t) / (MATH_PI * t);
+            return sinc * BesselI0(KAISER_ALPHA * std::sqrt(1.0f - window * window)) / BesselI0(KAISER_ALPHA);
+        }
+
+        // Edges are clamped
+        FilterTaps BuildKaiserTaps(uint32_t inSize, uint32_t outSize) {
+            FilterTaps taps;
+            taps.offset.push_back(0);
+            const float scale = static_cast<float>(inSize) / outSize;
+            const float support = KAISER_RADIUS * scale;
+
+            for (uint32_t x = 0; x < outSize; x++) {
+                const float center = (x + 0.5f) * scale;
+                const int first = static_cast<int>(std::floor(center - support));
+                const int last = static_cast<int>(std::ceil(center + support));
+                for (int i = first; i <= last; i++) {
+                    float weight = KaiserSinc((i + 0.5f - center) / scale);
+                    if (weight != 0.0f) AddTap(taps, i, inSize, weight);
+                }
+                NormalizeLastOutput(taps);
+            }
+            return taps;
+        }
+
+        using Layout = DSMipGenerator::Layout;
+
+        // Channels of the 8-bit layouts, 0 for the float ones
+        uint32_t GetChannelCount(Layout layout) {
+            switch (layout) {
+                case Layout::R8: return 1;
+                case Layout::RG8: return 2;
+                case Layout::RGB8: return 3;
+                case Layout::RGBA8: return 4;
+                default: return 0;
+            }
+        }
+
+        size_t GetPixelSize(Layout layout) {
+            switch (layout) {
+                case Layout::RGBA16F: return 8;
+                case Layout::R11G11B10F: return 4;
+                default: return GetChannelCount(layout);
+            }
+        }
+
+        bool GetLayout(uint32_t channels, Layout& layout) {
+            switch (channels) {
+                case 1: layout = Layout::R8; return true;
+                case 2: layout = Layout::RG8; return true;
+                case 3: layout = Layout::RGB8; return true;
+                case 4: layout = Layout::RGBA8; return true;
+                default: return false;
+            }
+        }
+
+        // Rows of a level as float RGBA: the base converted on the fly, or the float level above
+        struct LevelSource {
+            uint32_t width = 0;
+            uint32_t height = 0;
+            const uint8_t* base = nullptr;
+            Layout layout = Layout::RGBA8;
+            const float* pixels = nullptr;
+            const DSMipGenerator::Settings* settings = nullptr;
+
+            const float* GetRow(uint32_t y, float* scratch) const {
+                if (pixels) return pixels + static_cast<size_t>(y) * width * 4;
+
+                const uint8_t* row = base + static_cast<size_t>(y) * width * GetPixelSize(layout);
+                if (layout == Layout::RGBA16F) {
+                    DSFloatConverter::HalfToFloat(reinterpret_cast<const uint16_t*>(row), scratch, static_cast<size_t>(width) * 4);
+                    if (settings->premultiplyAlpha) {
+                        for (float* pixel = scratch; pixel < scratch + width * 4; pixel += 4) {
+                            pixel[0] *= pixel[3];
+                            pixel[1] *= pixel[3];
+                            pixel[2] *= pixel[3];
+                        }
+                    }
+                    return scratch;
+                }
+                if (layout == Layout::R11G11B10F) {
+                    DSFloatConverter::R11G11B10FToRGBA32F(reinterpret_cast<const uint32_t*>(row), scratch, width);
+                    return scratch;
+                }
+
+                const ColorTables& tables = GetColorTables();
+                const float* colorTable = settings->sRGB ? tables.toLinear : tables.toUnorm;
+                const uint32_t channels = GetChannelCount(layout);
+
+                for (uint32_t x = 0; x < width; x++, row += channels) {
+                    float alpha = (channels == 4) ? tables.toUnorm[row[3]] : 1.0f;
+                    float scale = settings->premultiplyAlpha ? alpha : 1.0f;
+                    scratch[x * 4 + 0] = colorTable[row[0]] * scale;
+                    scratch[x * 4 + 1] = (channels >= 2) ? colorTable[row[1]] * scale : 0.0f;
+                    scratch[x * 4 + 2] = (channels >= 3) ? colorTable[row[2]] * scale : 0.0f;
+                    scratch[x * 4 + 3] = alpha;
+                }
+                return scratch;
+            }
+        };
+
+        void Box2x2RowSSE(const float* row0, const float* row1, float* out, uint32_t outWidth) {
+            const __m128 quarter = _mm_set1_ps(0.25f);
+            for (uint32_t x = 0; x < outWidth; x++) {
+                __m128 sum = _mm_add_ps(_mm_add_ps(_mm_loadu_ps(row0), _mm_loadu_ps(row0 + 4)),
+                                        _mm_add_ps(_mm_loadu_ps(row1), _mm_loadu_ps(row1 + 4)));
+                _mm_storeu_ps(out, _mm_mul_ps(sum, quarter));
+                row0 += 8;
+                row1 += 8;
+                out += 4;
+            }
+        }
+
+        DS_TARGET("avx")
+        void Box2x2RowAVX(const float* row0, const float* row1, float* out, uint32_t outWidth) {
+            const __m256 quarter = _mm256_set1_ps(0.25f);
+            uint32_t x = 0;
+            for (; x + 2 <= outWidth; x += 2) {
+                // Vertical sums of source pixels 0,1 and 2,3
+                __m256 sum01 = _mm256_add_ps(_mm256_loadu_ps(row0), _mm256_loadu_ps(row1));
+                __m256 sum23 = _mm256_add_ps(_mm256_loadu_ps(row0 + 8), _mm256_loadu_ps(row1 + 8));
+                __m256 even = _mm256_permute2f128_ps(sum01, sum23, 0x20);
+                __m256 odd = _mm256_permute2f128_ps(sum01, sum23, 0x31);
+                _mm256_storeu_ps(out, _mm256_mul_ps(_mm256_add_ps(even, odd), quarter));
+                row0 += 16;
+                row1 += 16;
+                out += 8;
+            }
+            if (x < outWidth) {
+                Box2x2RowSSE(row0, row1, out, outWidth - x);
+            }
+        }
+
+        void FilterTileBox2x2(const LevelSource& source, float* dest, uint32_t outWidth, uint32_t firstRow, uint32_t lastRow) {
+            std::vector<float> scratch0(source.pixels ? 0 : source.width * 4);
+            std::vector<float> scratch1(scratch0.size());
+            const bool useAVX = DSCpu::HasAVX();
+
+            for (uint32_t y = firstRow; y < lastRow; y++) {
+                const float* row0 = source.GetRow(y * 2, scratch0.data());
+                const float* row1 = source.GetRow(y * 2 + 1, scratch1.data());
+                float* out = dest + static_cast<size_t>(y) * outWidth * 4;
+                if (useAVX) {
+                    Box2x2RowAVX(row0, row1, out, outWidth);
+                } else {
+                    Box2x2RowSSE(row0, row1, out, outWidth);
+                }
+            }
+        }
+
+        // Separable filter: horizontal pass on every source row the tile needs, then vertical pass per output row
+        void FilterTileSeparable(const LevelSource& source, const FilterTaps& horizontal, const FilterTaps& vertical,
+                                 float* dest, uint32_t outWidth, uint32_t firstRow, uint32_t lastRow) {
+            uint32_t minRow = source.height, maxRow = 0;
+            for (uint32_t i = vertical.offset[firstRow]; i < vertical.offset[lastRow]; i++) {
+                minRow = std::min(minRow, vertical.index[i]);
+                maxRow = std::max(maxRow, vertical.index[i]);
+            }
+
+            const size_t outRowFloats = static_cast<size_t>(outWidth) * 4;
+            std::vector<float> filteredRows((maxRow - minRow + 1) * outRowFloats);
+            std::vector<float> scratch(source.pixels ? 0 : source.width * 4);
+
+            for (uint32_t sy = minRow; sy <= maxRow; sy++) {
+                const float* row = source.GetRow(sy, scratch.data());
+                float* out = filteredRows.data() + (sy - minRow) * outRowFloats;
+
+                for (uint32_t x = 0; x < outWidth; x++) {
+                    __m128 sum = _mm_setzero_ps();
+                    for (uint32_t t = horizontal.offset[x]; t < horizontal.offset[x + 1]; t++) {
+                        sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(row + horizontal.index[t] * 4), _mm_set1_ps(horizontal.weight[t])));
+                    }
+                    _mm_storeu_ps(out + x * 4, sum);
+                }
+            }
+
+            for (uint32_t y = firstRow; y < lastRow; y++) {
+                float* out = dest + y * outRowFloats;
+                std::fill(out, out + outRowFloats, 0.0f);
+
+                for (uint32_t t = vertical.offset[y]; t < vertical.offset[y + 1]; t++) {
+                    const float* row = filteredRows.data() + (vertical.index[t] - minRow) * outRowFloats;
+                    const __m128 weight = _mm_set1_ps(vertical.weight[t]);
+                    for (size_t i = 0; i < outRowFloats; i += 4) {
+                        _mm_storeu_ps(out + i, _mm_add_ps(_mm_loadu_ps(out + i), _mm_mul_ps(_mm_loadu_ps(row + i), weight)));
+                    }
+                }
+            }
+        }
+
+        FilterTaps BuildTaps(DSMipGenerator::Filter filter, uint32_t inSize, uint32_t outSize) {
+            return (filter == DSMipGenerator::Filter::Box) ? BuildBoxTaps(inSize, outSize) : BuildKaiserTaps(inSize, outSize);
+        }
+
+        // Taps of outputs [first, last) with source indices made relative to sourceFirst
+        FilterTaps SliceTaps(const FilterTaps& taps, uint32_t first, uint32_t last, uint32_t sourceFirst) {
+            FilterTaps slice;
+            slice.offset.push_back(0);
+            for (uint32_t x = first; x < last; x++) {
+                for (uint32_t t = taps.offset[x]; t < taps.offset[x + 1]; t++) {
+                    slice.index.push_back(taps.index[t] - sourceFirst);
+                    slice.weight.push_back(taps.weight[t]);
+                }
+                slice.offset.push_back(static_cast<uint32_t>(slice.weight.size()));
+            }
+            return slice;
+        }
+
+        // Source indices read by outputs [first, last), as [sourceFirst, sourceLast)
+        void GetTapRange(const FilterTaps& taps, uint32_t first, uint32_t last, uint32_t& sourceFirst, uint32_t& sourceLast) {
+            sourceFirst = UINT32_MAX;
+            sourceLast = 0;
+            for (uint32_t t = taps.offset[first]; t < taps.offset[last]; t++) {
+                sourceFirst = std::min(sourceFirst, taps.index[t]);
+                sourceLast = std::max(sourceLast, taps.index[t] + 1);
+            }
+        }
+
+        // Outputs reading any source index in [sourceFirst, sourceLast), as [first, last)
+        void GetAffectedRange(const FilterTaps& taps, uint32_t sourceFirst, uint32_t sourceLast, uint32_t& first, uint32_t& last) {
+            const uint32_t outSize = static_cast<uint32_t>(taps.offset.size()) - 1;
+            first = outSize;
+            last = 0;
+            for (uint32_t x = 0; x < outSize; x++) {
+                for (uint32_t t = taps.offset[x]; t < taps.offset[x + 1]; t++) {
+                    if (taps.index[t] >= sourceFirst && taps.index[t] < sourceLast) {
+                        first = std::min(first, x);
+                        last = x + 1;
+                        break;
+                    }
+                }
+            }
+            if (first >= last) first = last = 0;
+        }
+
+        void QuantizeRows(const float* pixels, uint8_t* dest, uint32_t width, uint32_t firstRow, uint32_t lastRow,
+                          uint32_t channels, const DSMipGenerator::Settings& settings) {
+            const ColorTables& tables = GetColorTables();
+            const uint32_t colorChannels = std::min(channels, 3u);
+
+            for (uint32_t y = firstRow; y < lastRow; y++) {
+                const float* in = pixels + static_cast<size_t>(y) * width * 4;
+                uint8_t* out = dest + static_cast<size_t>(y) * width * channels;
+
+                for (uint32_t x = 0; x < width; x++, in += 4, out += channels) {
+                    float alpha = std::min(std::max(in[3], 0.0f), 1.0f);
+                    float scale = 1.0f;
+                    if (settings.premultiplyAlpha) {
+                        scale = alpha > 0.0f ? 1.0f / alpha : 0.0f;
+                    }
+
+                    for (uint32_t c = 0; c < colorChannels; c++) {
+                        float value = std::min(std::max(in[c] * scale, 0.0f), 1.0f);
+                        out[c] = settings.sRGB ? tables.toSRGB[static_cast<uint32_t>(value * 65535.0f + 0.5f)]
+                                               : static_cast<uint8_t>(value * 255.0f + 0.5f);
+                    }
+                    if (channels == 4) {
+                        out[3] = static_cast<uint8_t>(alpha * 255.0f + 0.5f);
+                    }
+                }
+            }
+        }
+
+        // Float layouts are stored without clamping, only premultiplied alpha is undone
+        void StoreFloatRows(const float* pixels, uint8_t* dest, uint32_t width, uint32_t firstRow, uint32_t lastRow,
+                            Layout layout, const DSMipGenerator::Settings& settings) {
+            const bool unpremultiply = settings.premultiplyAlpha && layout == Layout::RGBA16F;
+            std::vector<float> scratch(unpremultiply ? width * 4 : 0);
+
+            for (uint32_t y = firstRow; y < lastRow; y++) {
+                const float* in = pixels + static_cast<size_t>(y) * width * 4;
+                uint8_t* out = dest + static_cast<size_t>(y) * width * GetPixelSize(layout);
+
+                if (unpremultiply) {
+                    for (uint32_t x = 0; x < width * 4; x += 4) {
+                        const float scale = in[x + 3] > 0.0f ? 1.0f / in[x + 3] : 0.0f;
+                        scratch[x + 0] = in[x + 0] * scale;
+                        scratch[x + 1] = in[x + 1] * scale;
+                        scratch[x + 2] = in[x + 2] * scale;
+                        scratch[x + 3] = in[x + 3];
+                    }
+                    in = scratch.data();
+                }
+
+                if (layout == Layout::RGBA16F) {
+                    DSFloatConverter::FloatToHalf(in, reinterpret_cast<uint16_t*>(out), static_cast<size_t>(width) * 4);
+                } else {
+                    DSFloatConverter::RGBA32FToR11G11B10F(in, reinterpret_cast<uint32_t*>(out), width);
+                }
+            }
+        }
+
+        void StoreRows(const float* pixels, uint8_t* dest, uint32_t width, uint32_t firstRow, uint32_t lastRow,
+                       Layout layout, const DSMipGenerator::Settings& settings) {
+            const uint32_t channels = GetChannelCount(layout);
+            if (channels > 0) {
+                QuantizeRows(pixels, dest, width, firstRow, lastRow, channels, settings);
+            } else {
+                StoreFloatRows(pixels, dest, width, firstRow, lastRow, layout, settings);
+            }
+        }
+    }
+
+    bool DSMipGenerator::Generate(const uint8_t* base, uint32_t width, uint32_t height, uint32_t channels,
+                                  const Settings& settings, uint8_t* const* levels) {
+        Layout layout;
+        return GetLayout(channels, layout) && Generate(base, width, height, layout, settings, levels);
+    }
+
+    bool DSMipGenerator::Generate(const uint8_t* base, uint32_t width, uint32_t height, Layout layout,
+                                  const Settings& settings, uint8_t* const* levels) {
+        LevelSource source;
+        source.width = width;
+        source.height = height;
+        source.base = base;
+        source.layout = layout;
+        source.settings = &settings;
+
+        // Only the previous level is kept in float, both buffers come from the pool
+        DSBufferPool::Buffer previous, current;
+
+        for (uint32_t levelIndex = 0; width > 1 || height > 1; levelIndex++) {
+            const uint32_t outWidth = std::max(1u, width / 2);
+            const uint32_t outHeight = std::max(1u, height / 2);
+
+            current.Resize(static_cast<size_t>(outWidth) * outHeight * 4 * sizeof(float));
+            float* level = reinterpret_cast<float*>(current.Data());
+            uint8_t* quantized = levels[levelIndex];
+
+            const bool box2x2 = settings.filter == Filter::Box && width % 2 == 0 && height % 2 == 0;
+            FilterTaps horizontal, vertical;
+            if (!box2x2) {
+                horizontal = (settings.filter == Filter::Box) ? BuildBoxTaps(width, outWidth) : BuildKaiserTaps(width, outWidth);
+                vertical = (settings.filter == Filter::Box) ? BuildBoxTaps(height, outHeight) : BuildKaiserTaps(height, outHeight);
+            }
+
+            const uint32_t tileCount = (outHeight + TILE_ROWS - 1) / TILE_ROWS;
+            DSThreadPool::Global().ParallelFor(tileCount, [&](uint32_t tile) {
+                const uint32_t firstRow = tile * TILE_ROWS;
+                const uint32_t lastRow = std::min(outHeight, firstRow + TILE_ROWS);
+
+                if (box2x2) {
+                    FilterTileBox2x2(source, level, outWidth, firstRow, lastRow);
+                } else {
+                    FilterTileSeparable(source, horizontal, vertical, level, outWidth, firstRow, lastRow);
+                }
+                StoreRows(level, quantized, outWidth, firstRow, lastRow, layout, settings);
+            }, settings.maxThreads);
+
+            std::swap(previous, current);
+            source.width = width = outWidth;
+            source.height = height = outHeight;
+            source.pixels = reinterpret_cast<const float*>(previous.Data());
+        }
+
+        return true;
+    }
+
+    DSMipGenerator::Region DSMipGenerator::GetAffectedRegion(uint32_t width, uint32_t height, const Region& region,
+                                                             const Settings& settings) {
+        const FilterTaps horizontal = BuildTaps(settings.filter, width, std::max(1u, width / 2));
+        const FilterTaps vertical = BuildTaps(settings.filter, height, std::max(1u, height / 2));
+
+        Region affected;
+        uint32_t lastX, lastY;
+        GetAffectedRange(horizontal, region.x, region.x + region.width, affected.x, lastX);
+        GetAffectedRange(vertical, region.y, region.y + region.height, affected.y, lastY);
+        affected.width = lastX - affected.x;
+        affected.height = lastY - affected.y;
+        return affected;
+    }
+
+    DSMipGenerator::Region DSMipGenerator::GetSourceRegion(uint32_t width, uint32_t height, const Region& destRegion,
+                                                           const Settings& settings) {
+        const FilterTaps horizontal = BuildTaps(settings.filter, width, std::max(1u, width / 2));
+        const FilterTaps vertical = BuildTaps(settings.filter, height, std::max(1u, height / 2));
+
+        Region source;
+        uint32_t lastX, lastY;
+        GetTapRange(horizontal, destRegion.x, destRegion.x + destRegion.width, source.x, lastX);
+        GetTapRange(vertical, destRegion.y, destRegion.y + destRegion.height, source.y, lastY);
+        source.width = lastX - source.x;
+        source.height = lastY - source.y;
+        return source;
+    }
+
+    bool DSMipGenerator::GenerateRegion(const uint8_t* source, uint32_t width, uint32_t height, uint32_t channels,
+                                        const Settings& settings, const Region& destRegion, uint8_t* dest) {
+        Layout layout;
+        return GetLayout(channels, layout) && GenerateRegion(source, width, height, layout, settings, destRegion, dest);
+    }
+
+    bool DSMipGenerator::GenerateRegion(const uint8_t* source, uint32_t width, uint32_t height, Layout layout,
+                                        const Settings& settings, const Region& destRegion, uint8_t* dest) {
+        if (destRegion.width == 0 || destRegion.height == 0) return true;
+
+        // The full level taps restricted to the region, so every output gets the same weights as in Generate
+        const Region sourceRegion = GetSourceRegion(width, height, destRegion, settings);
+        const FilterTaps horizontal = SliceTaps(BuildTaps(settings.filter, width, std::max(1u, width / 2)),
+                                                destRegion.x, destRegion.x + destRegion.width, sourceRegion.x);
+        const FilterTaps vertical = SliceTaps(BuildTaps(settings.filter, height, std::max(1u, height / 2)),
+                                              destRegion.y, destRegion.y + destRegion.height, sourceRegion.y);
+
+        LevelSource level;
+        level.width = sourceRegion.width;
+        level.height = sourceRegion.height;
+        level.base = source;
+        level.layout = layout;
+        level.settings = &settings;
+
+        DSBufferPool::Buffer filtered(static_cast<size_t>(destRegion.width) * destRegion.height * 4 * sizeof(float));
+        float* pixels = reinterpret_cast<float*>(filtered.Data());
+        FilterTileSeparable(level, horizontal, vertical, pixels, destRegion.width, 0, destRegion.height);
+        StoreRows(pixels, dest, destRegion.width, 0, destRegion.height, layout, settings);
+        return true;
+    }
+}
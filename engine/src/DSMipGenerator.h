@@ -0,0 +1,102 @@
+#pragma once
+#include <cstdint>
+
+namespace DSEngine {
+    /**
+     * Builds mip chains for 8-bit R/RG/RGB/RGBA images and RGBA16F/R11G11B10F HDR images, only RGBA has alpha.
+     * Levels are filtered in 32-bit float (linear space for sRGB data) and every level is computed from
+     * the unquantized level above it, so rounding and gamma errors don't build up down the chain.
+     * Each level is split in tiles of rows that are filtered in parallel.
+     */
+    class DSMipGenerator {
+    public:
+        enum class Filter {
+            Box,     // 2x2 average (SIMD fast path on even sizes), area weighted on odd sizes
+            Kaiser   // Kaiser windowed sinc, sharper and without the box aliasing
+        };
+
+        // Pixel layout of every level
+        enum class Layout {
+            R8,
+            RG8,
+            RGB8,
+            RGBA8,
+            RGBA16F,     // Half float RGBA
+            R11G11B10F   // Packed unsigned float RGB, see DSFloatConverter
+        };
+
+        struct Settings {
+            Filter filter = Filter::Box;
+            bool sRGB = false;              // Color channels are sRGB encoded, filter them in linear space (8-bit layouts only)
+            bool premultiplyAlpha = false;  // Weight color by alpha while filtering (for straight alpha sources)
+            uint32_t maxThreads = 0;        // 0 uses the whole engine thread pool
+        };
+
+        // Rectangle of a level in pixels
+        struct Region {
+            uint32_t x = 0;
+            uint32_t y = 0;
+            uint32_t width = 0;
+            uint32_t height = 0;
+        };
+
+        /**
+         * Generates every level below the base image, down to 1x1.
+         *
+         * @param base The base level pixels, tightly packed.
+         * @param width Base width.
+         * @param height Base height.
+         * @param channels 1 (R8), 2 (RG8), 3 (RGB8) or 4 (RGBA8).
+         * @param settings Filtering settings.
+         * @param levels Destination of level 1, 2... in the same layout as the base, one pointer per level.
+         *               Level n is max(1, width >> n) by max(1, height >> n).
+         * @return false if the channel count is not supported.
+         */
+        static bool Generate(const uint8_t* base, uint32_t width, uint32_t height, uint32_t channels,
+                             const Settings& settings, uint8_t* const* levels);
+
+        /**
+         * Generate for any layout. Float layouts keep values outside [0, 1], R11G11B10F clamps negatives to 0.
+         */
+        static bool Generate(const uint8_t* base, uint32_t width, uint32_t height, Layout layout,
+                             const Settings& settings, uint8_t* const* levels);
+
+        /**
+         * Returns the rectangle of the next level whose pixels depend on a rectangle of this level.
+         *
+         * @param width This level's width.
+         * @param height This level's height.
+         * @param region Changed rectangle of this level.
+         * @param settings Filtering settings.
+         */
+        static Region GetAffectedRegion(uint32_t width, uint32_t height, const Region& region, const Settings& settings);
+
+        /**
+         * Returns the rectangle of a level that GenerateRegion reads to filter a rectangle of the next level.
+         *
+         * @param width This level's width.
+         * @param height This level's height.
+         * @param destRegion Rectangle of the next level.
+         * @param settings Filtering settings.
+         */
+        static Region GetSourceRegion(uint32_t width, uint32_t height, const Region& destRegion, const Settings& settings);
+
+        /**
+         * Filters a rectangle of one level from the quantized level above, to refresh the mips under a partial update.
+         * Generate filters from the unquantized level above, so results can differ from it by rounding.
+         *
+         * @param source The GetSourceRegion rectangle of the level above, tightly packed.
+         * @param width Width of the level above.
+         * @param height Height of the level above.
+         * @param channels 1 (R8), 2 (RG8), 3 (RGB8) or 4 (RGBA8).
+         * @param settings Filtering settings.
+         * @param destRegion Rectangle of the next level to filter.
+         * @param dest Destination rectangle, tightly packed.
+         * @return false if the channel count is not supported.
+         */
+        static bool GenerateRegion(const uint8_t* source, uint32_t width, uint32_t height, uint32_t channels,
+                                   const Settings& settings, const Region& destRegion, uint8_t* dest);
+        static bool GenerateRegion(const uint8_t* source, uint32_t width, uint32_t height, Layout layout,
+                                   const Settings& settings, const Region& destRegion, uint8_t* dest);
+    };
+}
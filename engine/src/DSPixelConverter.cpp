@@ -0,0 +1,325 @@
+#include "DSPixelConverter.h"
+#include "DSCpu.h"
+#include <immintrin.h>
+
+namespace DSEngine {
+    namespace {
+        // =====================
+        // Scalar
+        // =====================
+
+        void RGB8ToRGBA8Scalar(const uint8_t* src, uint8_t* dest, size_t count, uint8_t alpha) {
+            for (size_t i = 0; i < count; i++, src += 3, dest += 4) {
+                dest[0] = src[0];
+                dest[1] = src[1];
+                dest[2] = src[2];
+                dest[3] = alpha;
+            }
+        }
+
+        void RGBA8ToRGB8Scalar(const uint8_t* src, uint8_t* dest, size_t count) {
+            for (size_t i = 0; i < count; i++, src += 4, dest += 3) {
+                dest[0] = src[0];
+                dest[1] = src[1];
+                dest[2] = src[2];
+            }
+        }
+
+        void GrayToRGB8Scalar(const uint8_t* src, uint8_t* dest, size_t count) {
+            for (size_t i = 0; i < count; i++, dest += 3) {
+                dest[0] = dest[1] = dest[2] = src[i];
+            }
+        }
+
+        void GrayAlphaToRGB8Scalar(const uint8_t* src, uint8_t* dest, size_t count) {
+            for (size_t i = 0; i < count; i++, src += 2, dest += 3) {
+                dest[0] = dest[1] = dest[2] = src[0];
+            }
+        }
+
+        void GrayAlphaToRGBA8Scalar(const uint8_t* src, uint8_t* dest, size_t count) {
+            for (size_t i = 0; i < count; i++, src += 2, dest += 4) {
+                dest[0] = dest[1] = dest[2] = src[0];
+                dest[3] = src[1];
+            }
+        }
+
+        void SwapRedBlueScalar(const uint8_t* src, uint8_t* dest, size_t count) {
+            for (size_t i = 0; i < count; i++, src += 4, dest += 4) {
+                const uint8_t red = src[0];
+                dest[0] = src[2];
+                dest[1] = src[1];
+                dest[2] = red;
+                dest[3] = src[3];
+            }
+        }
+
+        inline __m128i Load128(const uint8_t* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+        inline void Store128(uint8_t* p, __m128i v) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v); }
+
+        // =====================
+        // SSSE3, 16 pixels per iteration
+        // =====================
+
+        DS_TARGET("ssse3")
+        void RGB8ToRGBA8SSSE3(const uint8_t* src, uint8_t* dest, size_t count, uint8_t alpha) {
+            const __m128i spread = _mm_setr_epi8(0, 1, 2, -128, 3, 4, 5, -128, 6, 7, 8, -128, 9, 10, 11, -128);
+            const __m128i alphaMask = _mm_set1_epi32(static_cast<int>(static_cast<uint32_t>(alpha) << 24));
+
+            // Each load covers 4 pixels plus 4 bytes of the next ones, keep 2 pixels of slack at the end
+            size_t i = 0;
+            for (; i + 18 <= count; i += 16, src += 48, dest += 64) {
+                Store128(dest + 0, _mm_or_si128(_mm_shuffle_epi8(Load128(src + 0), spread), alphaMask));
+                Store128(dest + 16, _mm_or_si128(_mm_shuffle_epi8(Load128(src + 12), spread), alphaMask));
+                Store128(dest + 32, _mm_or_si128(_mm_shuffle_epi8(Load128(src + 24), spread), alphaMask));
+                Store128(dest + 48, _mm_or_si128(_mm_shuffle_epi8(Load128(src + 36), spread), alphaMask));
+            }
+            RGB8ToRGBA8Scalar(src, dest, count - i, alpha);
+        }
+
+        DS_TARGET("ssse3")
+        void RGBA8ToRGB8SSSE3(const uint8_t* src, uint8_t* dest, size_t count) {
+            // Packs the 12 color bytes of 4 pixels at the bottom of the register
+            const __m128i pack = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -128, -128, -128, -128);
+
+            size_t i = 0;
+            for (; i + 16 <= count; i += 16, src += 64, dest += 48) {
+                const __m128i p0 = _mm_shuffle_epi8(Load128(src + 0), pack);
+                const __m128i p1 = _mm_shuffle_epi8(Load128(src + 16), pack);
+                const __m128i p2 = _mm_shuffle_epi8(Load128(src + 32), pack);
+                const __m128i p3 = _mm_shuffle_epi8(Load128(src + 48), pack);
+                Store128(dest + 0, _mm_or_si128(p0, _mm_slli_si128(p1, 12)));
+                Store128(dest + 16, _mm_or_si128(_mm_srli_si128(p1, 4), _mm_slli_si128(p2, 8)));
+                Store128(dest + 32, _mm_or_si128(_mm_srli_si128(p2, 8), _mm_slli_si128(p3, 4)));
+            }
+            RGBA8ToRGB8Scalar(src, dest, count - i);
+        }
+
+        DS_TARGET("ssse3")
+        void GrayToRGB8SSSE3(const uint8_t* src, uint8_t* dest, size_t count) {
+            const __m128i spread0 = _mm_setr_epi8(0, 0, 0, 1, 1, 1, 2, 2, 2, 3, 3, 3, 4, 4, 4, 5);
+            const __m128i spread1 = _mm_setr_epi8(5, 5, 6, 6, 6, 7, 7, 7, 8, 8, 8, 9, 9, 9, 10, 10);
+            const __m128i spread2 = _mm_setr_epi8(10, 11, 11, 11, 12, 12, 12, 13, 13, 13, 14, 14, 14, 15, 15, 15);
+
+            size_t i = 0;
+            for (; i + 16 <= count; i += 16, src += 16, dest += 48) {
+                const __m128i gray = Load128(src);
+                Store128(dest + 0, _mm_shuffle_epi8(gray, spread0));
+                Store128(dest + 16, _mm_shuffle_epi8(gray, spread1));
+                Store128(dest + 32, _mm_shuffle_epi8(gray, spread2));
+            }
+            GrayToRGB8Scalar(src, dest, count - i);
+        }
+
+        DS_TARGET("ssse3")
+        void GrayAlphaToRGB8SSSE3(const uint8_t* src, uint8_t* dest, size_t count) {
+            // Output bytes 16..31 straddle both input registers
+            const __m128i spread0 = _mm_setr_epi8(0, 0, 0, 2, 2, 2, 4, 4, 4, 6, 6, 6, 8, 8, 8, 10);
+            const __m128i spread1Low = _mm_setr_epi8(10, 10, 12, 12, 12, 14, 14, 14, -128, -128, -128, -128, -128, -128, -128, -128);
+            const __m128i spread1High = _mm_setr_epi8(-128, -128, -128, -128, -128, -128, -128, -128, 0, 0, 0, 2, 2, 2, 4, 4);
+            const __m128i spread2 = _mm_setr_epi8(4, 6, 6, 6, 8, 8, 8, 10, 10, 10, 12, 12, 12, 14, 14, 14);
+
+            size_t i = 0;
+            for (; i + 16 <= count; i += 16, src += 32, dest += 48) {
+                const __m128i in0 = Load128(src);
+                const __m128i in1 = Load128(src + 16);
+                Store128(dest + 0, _mm_shuffle_epi8(in0, spread0));
+                Store128(dest + 16, _mm_or_si128(_mm_shuffle_epi8(in0, spread1Low), _mm_shuffle_epi8(in1, spread1High)));
+                Store128(dest + 32, _mm_shuffle_epi8(in1, spread2));
+            }
+            GrayAlphaToRGB8Scalar(src, dest, count - i);
+        }
+
+        DS_TARGET("ssse3")
+        void GrayAlphaToRGBA8SSSE3(const uint8_t* src, uint8_t* dest, size_t count) {
+            const __m128i spread0 = _mm_setr_epi8(0, 0, 0, 1, 2, 2, 2, 3, 4, 4, 4, 5, 6, 6, 6, 7);
+            const __m128i spread1 = _mm_setr_epi8(8, 8, 8, 9, 10, 10, 10, 11, 12, 12, 12, 13, 14, 14, 14, 15);
+
+            size_t i = 0;
+            for (; i + 8 <= count; i += 8, src += 16, dest += 32) {
+                const __m128i in = Load128(src);
+                Store128(dest + 0, _mm_shuffle_epi8(in, spread0));
+                Store128(dest + 16, _mm_shuffle_epi8(in, spread1));
+            }
+            GrayAlphaToRGBA8Scalar(src, dest, count - i);
+        }
+
+        DS_TARGET("ssse3")
+        void SwapRedBlueSSSE3(const uint8_t* src, uint8_t* dest, size_t count) {
+            const __m128i swap = _mm_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4, src += 16, dest += 16) {
+                Store128(dest, _mm_shuffle_epi8(Load128(src), swap));
+            }
+            SwapRedBlueScalar(src, dest, count - i);
+        }
+
+        // =====================
+        // AVX2 (pshufb works per 128-bit lane, so lanes are fed separately where needed)
+        // =====================
+
+        DS_TARGET("avx2")
+        void RGB8ToRGBA8AVX2(const uint8_t* src, uint8_t* dest, size_t count, uint8_t alpha) {
+            const __m256i spread = _mm256_setr_epi8(0, 1, 2, -128, 3, 4, 5, -128, 6, 7, 8, -128, 9, 10, 11, -128,
+                                                    0, 1, 2, -128, 3, 4, 5, -128, 6, 7, 8, -128, 9, 10, 11, -128);
+            const __m256i alphaMask = _mm256_set1_epi32(static_cast<int>(static_cast<uint32_t>(alpha) << 24));
+
+            // 4 pixels per lane, the last lane reads 4 bytes past the 16 pixels
+            size_t i = 0;
+            for (; i + 18 <= count; i += 16, src += 48, dest += 64) {
+                const __m256i in0 = _mm256_inserti128_si256(_mm256_castsi128_si256(Load128(src + 0)), Load128(src + 12), 1);
+                const __m256i in1 = _mm256_inserti128_si256(_mm256_castsi128_si256(Load128(src + 24)), Load128(src + 36), 1);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(dest), _mm256_or_si256(_mm256_shuffle_epi8(in0, spread), alphaMask));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(dest + 32), _mm256_or_si256(_mm256_shuffle_epi8(in1, spread), alphaMask));
+            }
+            RGB8ToRGBA8Scalar(src, dest, count - i, alpha);
+        }
+
+        DS_TARGET("avx2")
+        void RGBA8ToRGB8AVX2(const uint8_t* src, uint8_t* dest, size_t count) {
+            const __m256i pack = _mm256_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -128, -128, -128, -128,
+                                                  0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -128, -128, -128, -128);
+            // Packed dwords are 0-2 and 4-6 of each register, 16 pixels make 12 dwords (8 + 4)
+            const __m256i firstOrder = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 0, 0);
+            const __m256i secondOrder = _mm256_setr_epi32(2, 4, 5, 6, 0, 0, 0, 1);
+
+            size_t i = 0;
+            for (; i + 16 <= count; i += 16, src += 64, dest += 48) {
+                const __m256i a = _mm256_shuffle_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src)), pack);
+                const __m256i b = _mm256_shuffle_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + 32)), pack);
+                const __m256i first = _mm256_permutevar8x32_epi32(a, firstOrder);
+                const __m256i second = _mm256_permutevar8x32_epi32(b, secondOrder);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(dest), _mm256_blend_epi32(first, second, 0xC0));
+                Store128(dest + 32, _mm256_castsi256_si128(second));
+            }
+            RGBA8ToRGB8Scalar(src, dest, count - i);
+        }
+
+        DS_TARGET("avx2")
+        void GrayAlphaToRGBA8AVX2(const uint8_t* src, uint8_t* dest, size_t count) {
+            const __m256i spread = _mm256_setr_epi8(0, 0, 0, 1, 2, 2, 2, 3, 4, 4, 4, 5, 6, 6, 6, 7,
+                                                    8, 8, 8, 9, 10, 10, 10, 11, 12, 12, 12, 13, 14, 14, 14, 15);
+
+            size_t i = 0;
+            for (; i + 8 <= count; i += 8, src += 16, dest += 32) {
+                const __m256i in = _mm256_broadcastsi128_si256(Load128(src));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(dest), _mm256_shuffle_epi8(in, spread));
+            }
+            GrayAlphaToRGBA8Scalar(src, dest, count - i);
+        }
+
+        DS_TARGET("avx2")
+        void SwapRedBlueAVX2(const uint8_t* src, uint8_t* dest, size_t count) {
+            const __m256i swap = _mm256_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15,
+                                                  2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+
+            size_t i = 0;
+            for (; i + 8 <= count; i += 8, src += 32, dest += 32) {
+                const __m256i in = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(dest), _mm256_shuffle_epi8(in, swap));
+            }
+            SwapRedBlueScalar(src, dest, count - i);
+        }
+
+        DSPixelConverter::Path ResolvePath(DSPixelConverter::Path path) {
+            if (path == DSPixelConverter::Path::Auto) {
+                return DSPixelConverter::GetBestPath();
+            }
+            if (path == DSPixelConverter::Path::AVX2 && !DSCpu::HasAVX2()) {
+                path = DSPixelConverter::Path::SSSE3;
+            }
+            if (path == DSPixelConverter::Path::SSSE3 && !DSCpu::HasSSSE3()) {
+                path = DSPixelConverter::Path::Scalar;
+            }
+            return path;
+        }
+    }
+
+    void DSPixelConverter::RGB8ToRGBA8(const uint8_t* src, uint8_t* dest, size_t pixelCount, uint8_t alpha, Path path) {
+        switch (ResolvePath(path)) {
+            case Path::AVX2: RGB8ToRGBA8AVX2(src, dest, pixelCount, alpha); break;
+            case Path::SSSE3: RGB8ToRGBA8SSSE3(src, dest, pixelCount, alpha); break;
+            default: RGB8ToRGBA8Scalar(src, dest, pixelCount, alpha); break;
+        }
+    }
+
+    void DSPixelConverter::RGBA8ToRGB8(const uint8_t* src, uint8_t* dest, size_t pixelCount, Path path) {
+        switch (ResolvePath(path)) {
+            case Path::AVX2: RGBA8ToRGB8AVX2(src, dest, pixelCount); break;
+            case Path::SSSE3: RGBA8ToRGB8SSSE3(src, dest, pixelCount); break;
+            default: RGBA8ToRGB8Scalar(src, dest, pixelCount); break;
+        }
+    }
+
+    void DSPixelConverter::GrayToRGB8(const uint8_t* src, uint8_t* dest, size_t pixelCount, Path path) {
+        switch (ResolvePath(path)) {
+            case Path::AVX2:
+            case Path::SSSE3: GrayToRGB8SSSE3(src, dest, pixelCount); break;
+            default: GrayToRGB8Scalar(src, dest, pixelCount); break;
+        }
+    }
+
+    void DSPixelConverter::GrayAlphaToRGB8(const uint8_t* src, uint8_t* dest, size_t pixelCount, Path path) {
+        switch (ResolvePath(path)) {
+            case Path::AVX2:
+            case Path::SSSE3: GrayAlphaToRGB8SSSE3(src, dest, pixelCount); break;
+            default: GrayAlphaToRGB8Scalar(src, dest, pixelCount); break;
+        }
+    }
+
+    void DSPixelConverter::GrayAlphaToRGBA8(const uint8_t* src, uint8_t* dest, size_t pixelCount, Path path) {
+        switch (ResolvePath(path)) {
+            case Path::AVX2: GrayAlphaToRGBA8AVX2(src, dest, pixelCount); break;
+            case Path::SSSE3: GrayAlphaToRGBA8SSSE3(src, dest, pixelCount); break;
+            default: GrayAlphaToRGBA8Scalar(src, dest, pixelCount); break;
+        }
+    }
+
+    void DSPixelConverter::SwapRedBlue(const uint8_t* src, uint8_t* dest, size_t pixelCount, Path path) {
+        switch (ResolvePath(path)) {
+            case Path::AVX2: SwapRedBlueAVX2(src, dest, pixelCount); break;
+            case Path::SSSE3: SwapRedBlueSSSE3(src, dest, pixelCount); break;
+            default: SwapRedBlueScalar(src, dest, pixelCount); break;
+        }
+    }
+
+    void DSPixelConverter::KeepChannels(const uint8_t* src, uint32_t srcChannels, uint8_t* dest, uint32_t destChannels,
+                                        size_t pixelCount) {
+        for (size_t i = 0; i < pixelCount; i++, src += srcChannels, dest += destChannels) {
+            for (uint32_t c = 0; c < destChannels; c++) {
+                dest[c] = src[c];
+            }
+        }
+    }
+
+    void DSPixelConverter::ExpandChannels(const uint8_t* src, uint32_t srcChannels, uint8_t* dest, uint32_t destChannels,
+                                          size_t pixelCount) {
+        for (size_t i = 0; i < pixelCount; i++, src += srcChannels, dest += destChannels) {
+            for (uint32_t c = 0; c < destChannels; c++) {
+                if (c < srcChannels) {
+                    dest[c] = src[c];
+                } else if (c < 3) {
+                    dest[c] = (srcChannels == 1) ? src[0] : 0;
+                } else {
+                    dest[c] = 255;
+                }
+            }
+        }
+    }
+
+    DSPixelConverter::Path DSPixelConverter::GetBestPath() {
+        if (DSCpu::HasAVX2()) return Path::AVX2;
+        return DSCpu::HasSSSE3() ? Path::SSSE3 : Path::Scalar;
+    }
+
+    const char* DSPixelConverter::GetPathName(Path path) {
+        switch (path) {
+            case Path::Auto: return "Auto";
+            case Path::Scalar: return "Scalar";
+            case Path::SSSE3: return "SSSE3";
+            case Path::AVX2: return "AVX2";
+        }
+        return "Unknown";
+    }
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+
+namespace DSEngine {
+    /**
+     * Channel layout conversions for 8-bit images (import, format conversion, swizzles).
+     * Every function works on tightly packed pixels; source and destination must not overlap
+     * except for SwapRedBlue, which can run in place.
+     */
+    class DSPixelConverter {
+    public:
+        /**
+         * Implementation used to convert. Auto picks the fastest one supported by the CPU.
+         * Conversions without an AVX2 kernel run the SSSE3 one on the AVX2 path.
+         */
+        enum class Path {
+            Auto,
+            Scalar,
+            SSSE3,
+            AVX2
+        };
+
+        // RGB8 -> RGBA8 with a constant alpha
+        static void RGB8ToRGBA8(const uint8_t* src, uint8_t* dest, size_t pixelCount, uint8_t alpha = 255, Path path = Path::Auto);
+
+        // RGBA8 -> RGB8, alpha is dropped
+        static void RGBA8ToRGB8(const uint8_t* src, uint8_t* dest, size_t pixelCount, Path path = Path::Auto);
+
+        // Gray8 -> RGB8
+        static void GrayToRGB8(const uint8_t* src, uint8_t* dest, size_t pixelCount, Path path = Path::Auto);
+
+        // Gray/alpha 8-bit pairs -> RGB8, alpha is dropped
+        static void GrayAlphaToRGB8(const uint8_t* src, uint8_t* dest, size_t pixelCount, Path path = Path::Auto);
+
+        // Gray/alpha 8-bit pairs -> RGBA8
+        static void GrayAlphaToRGBA8(const uint8_t* src, uint8_t* dest, size_t pixelCount, Path path = Path::Auto);
+
+        // RGBA8 <-> BGRA8, src and dest may be the same buffer
+        static void SwapRedBlue(const uint8_t* src, uint8_t* dest, size_t pixelCount, Path path = Path::Auto);
+
+        // Keeps the first destChannels channels of every pixel (RGBA8 -> RG8, RGB8 -> R8...), scalar only
+        static void KeepChannels(const uint8_t* src, uint32_t srcChannels, uint8_t* dest, uint32_t destChannels, size_t pixelCount);
+
+        // Adds channels (R8 -> RGBA8, RG8 -> RGB8...), scalar only. A single channel is replicated like gray,
+        // otherwise missing color channels are 0. Alpha is 255.
+        static void ExpandChannels(const uint8_t* src, uint32_t srcChannels, uint8_t* dest, uint32_t destChannels, size_t pixelCount);
+
+        /**
+         * Returns the path Auto resolves to on this CPU.
+         */
+        static Path GetBestPath();
+
+        static const char* GetPathName(Path path);
+    };
+}
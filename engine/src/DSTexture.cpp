@@ -1,15 +1,28 @@
 ﻿#include "DSTexture.h"
+#include "DSThreadPool.h"
+#include "DSDXTDecoder.h"
+#include "DSDXTEncoder.h"
+#include "DSTextureStreamer.h"
+#include "DSLZCodec.h"
+#include "DSPixelConverter.h"
+#include "DSFloatConverter.h"
+#include "DSTextureLoader.h"
+#include "DSTexturePack.h"
+#include <immintrin.h>
 #include <fstream>
 #include <algorithm>
 #include <cstring>
+#include <atomic>
+#include <numeric>
 
 // STB implementations
 #define STB_IMAGE_IMPLEMENTATION
 #define STB_IMAGE_STATIC
+// Images are decoded on pool threads, the flip flag must be per thread
+#ifndef STBI_THREAD_LOCAL
+#define STBI_THREAD_LOCAL thread_local
+#endif
 #include "../third_party/stb/stb_image.h"
-
-#define STB_IMAGE_RESIZE_IMPLEMENTATION
-#include "../third_party/stb/stb_image_resize.h"
 namespace DSEngine {
     // =====================
     // Construction/Destruction
@@ -17,7 +30,9 @@ namespace DSEngine {
 
     DSTexture::DSTexture() : m_format(Format::UNKNOWN), m_flags(0) {}
 
-    DSTexture::~DSTexture() = default;
+    DSTexture::~DSTexture() {
+        ResetStreaming();
+    }
 
     // =====================
     // Static Creation Methods
@@ -38,9 +53,14 @@ namespace DSEngine {
         MipLevel baseLevel;
         baseLevel.width = width;
         baseLevel.height = height;
-        baseLevel.data.resize(width * height * GetPixelSize(format));
+        texture->m_mipmaps.push_back(baseLevel);
 
-        texture->m_mipmaps.push_back(std::move(baseLevel));
+        DSMipChain storage;
+        storage.Allocate(GetMipSizes(texture->m_mipmaps, format));
+        if (storage.GetLevel(0)) {
+            std::memset(storage.GetLevel(0), 0, storage.GetLevelSize(0));
+        }
+        texture->SetStorage(std::move(storage));
         return texture;
     }
 
@@ -51,10 +71,14 @@ namespace DSEngine {
         MipLevel baseLevel;
         baseLevel.width = width;
         baseLevel.height = height;
-        const size_t dataSize = width * height * GetPixelSize(format);
-        baseLevel.data.assign(data, data + dataSize);
+        texture->m_mipmaps.push_back(baseLevel);
 
-        texture->m_mipmaps.push_back(std::move(baseLevel));
+        DSMipChain storage;
+        storage.Allocate(GetMipSizes(texture->m_mipmaps, format));
+        if (storage.GetLevel(0)) {
+            std::memcpy(storage.GetLevel(0), data, storage.GetLevelSize(0));
+        }
+        texture->SetStorage(std::move(storage));
         return texture;
     }
 
@@ -62,7 +86,25 @@ namespace DSEngine {
     // File Operations
     // =====================
 
-    bool DSTexture::SaveToFile(const std::string& path) const {
+    bool DSTexture::SaveToFile(const std::string& path, FileCompression compression) const {
+        // Every mip must be in memory
+        if (m_streaming && m_streaming->residentMip > 0) {
+            return false;
+        }
+
+        // Compress the mips in parallel, keep the compressed data only when it pays off
+        const uint32_t mipCount = GetMipLevels();
+        std::vector<std::vector<uint8_t>> packedMips(mipCount);
+        if (compression == FileCompression::LZ) {
+            DSThreadPool::Global().ParallelFor(mipCount, [&](uint32_t i) {
+                const MipLevel& mip = m_mipmaps[i];
+                DSLZCodec::Compress(mip.Bytes(), mip.Size(), packedMips[i]);
+                if (packedMips[i].size() > mip.Size() - mip.Size() / 8) {
+                    std::vector<uint8_t>().swap(packedMips[i]);
+                }
+            });
+        }
+
         std::ofstream file(path, std::ios::binary);
         if (!file.is_open()) {
             return false;
@@ -70,38 +112,105 @@ namespace DSEngine {
 
         // Prepare header
         DSTHeader header;
+        header.version = (compression == FileCompression::LZ) ? DST_VERSION_LZ : DST_VERSION_RAW;
         header.width = GetWidth();
         header.height = GetHeight();
         header.format = static_cast<uint16_t>(m_format);
-        header.mipLevels = GetMipLevels();
+        header.mipLevels = mipCount;
         header.flags = m_flags;
 
         // Write header
         file.write(reinterpret_cast<const char*>(&header), sizeof(DSTHeader));
 
         // Calculate data offset (header + mip info array)
-        uint32_t dataOffset = sizeof(DSTHeader) + (header.mipLevels * sizeof(DSTMipInfo));
+        uint32_t dataOffset = static_cast<uint32_t>(sizeof(DSTHeader) + header.mipLevels * GetMipInfoSize(header.version));
 
         // Write mipmap info and accumulate data offset
-        for (const auto& mip : m_mipmaps) {
-            DSTMipInfo info;
+        for (uint32_t i = 0; i < mipCount; ++i) {
+            const MipLevel& mip = m_mipmaps[i];
+            DSTMipInfoV4 info;
             info.width = mip.width;
             info.height = mip.height;
-            info.dataSize = static_cast<uint32_t>(mip.data.size());
+            info.dataSize = static_cast<uint32_t>(mip.Size());
             info.dataOffset = dataOffset;
+            info.storedSize = packedMips[i].empty() ? info.dataSize : static_cast<uint32_t>(packedMips[i].size());
+            info.compression = packedMips[i].empty() ? DST_MIP_RAW : DST_MIP_LZ;
 
-            file.write(reinterpret_cast<const char*>(&info), sizeof(DSTMipInfo));
-            dataOffset += info.dataSize;
+            file.write(reinterpret_cast<const char*>(&info), GetMipInfoSize(header.version));
+            dataOffset += info.storedSize;
         }
 
         // Write pixel data
-        for (const auto& mip : m_mipmaps) {
-            file.write(reinterpret_cast<const char*>(mip.data.data()), mip.data.size());
+        for (uint32_t i = 0; i < mipCount; ++i) {
+            if (packedMips[i].empty()) {
+                file.write(reinterpret_cast<const char*>(m_mipmaps[i].Bytes()), m_mipmaps[i].Size());
+            } else {
+                file.write(reinterpret_cast<const char*>(packedMips[i].data()), packedMips[i].size());
+            }
         }
 
         return file.good();
     }
 
+    bool DSTexture::SaveToFile(const std::string& path, const UploadAlignment& alignment) const {
+        // Every mip must be in memory
+        if (m_streaming && m_streaming->residentMip > 0) {
+            return false;
+        }
+
+        const UploadLayout layout = GetUploadLayout(alignment);
+        if (layout.mips.empty()) {
+            return false;
+        }
+
+        // The payload starts on an aligned file offset so the mip offsets stay aligned in a mapping
+        const uint32_t mipCount = GetMipLevels();
+        const size_t offsetAlignment = std::lcm<size_t>(std::max<uint32_t>(alignment.offset, 1), GetBlockSize(m_format));
+        const size_t tableEnd = sizeof(DSTHeader) + mipCount * sizeof(DSTMipInfoV4);
+        const size_t payloadOffset = (tableEnd + offsetAlignment - 1) / offsetAlignment * offsetAlignment;
+        if (payloadOffset + layout.size > UINT32_MAX) {
+            return false;
+        }
+
+        DSBufferPool::Buffer payload(layout.size);
+        if (!CopyUploadData(alignment, payload.Data())) {
+            return false;
+        }
+
+        std::ofstream file(path, std::ios::binary);
+        if (!file.is_open()) {
+            return false;
+        }
+
+        DSTHeader header;
+        header.version = DST_VERSION_UPLOAD;
+        header.width = GetWidth();
+        header.height = GetHeight();
+        header.format = static_cast<uint16_t>(m_format);
+        header.mipLevels = mipCount;
+        header.flags = m_flags;
+        file.write(reinterpret_cast<const char*>(&header), sizeof(DSTHeader));
+
+        for (uint32_t i = 0; i < mipCount; ++i) {
+            const UploadMip& mip = layout.mips[i];
+            DSTMipInfoV4 info;
+            info.width = m_mipmaps[i].width;
+            info.height = m_mipmaps[i].height;
+            info.dataSize = static_cast<uint32_t>(mip.rowSize * mip.rowCount);
+            info.dataOffset = static_cast<uint32_t>(payloadOffset + mip.offset);
+            info.storedSize = static_cast<uint32_t>(mip.rowPitch * mip.rowCount);
+            info.compression = DST_MIP_RAW;
+            info.rowPitch = static_cast<uint32_t>(mip.rowPitch);
+            info.rowCount = mip.rowCount;
+            file.write(reinterpret_cast<const char*>(&info), sizeof(DSTMipInfoV4));
+        }
+
+        const std::vector<char> padding(payloadOffset - tableEnd, 0);
+        file.write(padding.data(), padding.size());
+        file.write(reinterpret_cast<const char*>(payload.Data()), layout.size);
+        return file.good();
+    }
+
     bool DSTexture::LoadFromFile(const std::string& path) {
         // Try loading as DST first
         std::ifstream file(path, std::ios::binary);
@@ -115,39 +224,516 @@ namespace DSEngine {
                 return LoadFromSTB(path, true);
             }
 
-            m_format = static_cast<Format>(header.format);
-            m_flags = header.flags;
-
             // Read mipmap info
-            std::vector<DSTMipInfo> mipInfos(header.mipLevels);
-            file.read(reinterpret_cast<char*>(mipInfos.data()), header.mipLevels * sizeof(DSTMipInfo));
+            std::vector<DSTMipInfoV4> mipInfos;
+            if (!ReadMipTable(file, header, mipInfos)) {
+                return false;
+            }
 
-            // Read mipmap data
-            m_mipmaps.resize(header.mipLevels);
+            // The whole chain goes in one allocation
+            std::vector<MipLevel> mips(header.mipLevels);
+            std::vector<size_t> sizes(header.mipLevels);
             for (uint32_t i = 0; i < header.mipLevels; ++i) {
-                MipLevel& mip = m_mipmaps[i];
-                mip.width = mipInfos[i].width;
-                mip.height = mipInfos[i].height;
-                mip.data.resize(mipInfos[i].dataSize);
+                mips[i].width = mipInfos[i].width;
+                mips[i].height = mipInfos[i].height;
+                sizes[i] = mipInfos[i].dataSize;
+            }
+
+            DSMipChain storage;
+            storage.Allocate(sizes);
+
+            // Read mipmap data, raw mips go straight to their level
+            std::vector<DSBufferPool::Buffer> packedMips(header.mipLevels);
+            bool hasPackedMips = false;
+
+            for (uint32_t i = 0; i < header.mipLevels; ++i) {
+                uint8_t* target = storage.GetLevel(i);
+                size_t targetSize = mipInfos[i].dataSize;
+                if (!IsMipStoredAsIs(mipInfos[i])) {
+                    packedMips[i].Resize(mipInfos[i].storedSize);
+                    target = packedMips[i].Data();
+                    targetSize = packedMips[i].Size();
+                    hasPackedMips = true;
+                }
 
                 file.seekg(mipInfos[i].dataOffset);
-                file.read(reinterpret_cast<char*>(mip.data.data()), mip.data.size());
+                file.read(reinterpret_cast<char*>(target), targetSize);
             }
 
-            return file.good();
+            if (!file.good()) {
+                return false;
+            }
+
+            // Once all the reads are done, decode the compressed mips in parallel
+            if (hasPackedMips) {
+                std::atomic<bool> success{true};
+                DSThreadPool::Global().ParallelFor(header.mipLevels, [&](uint32_t i) {
+                    if (!IsMipStoredAsIs(mipInfos[i]) &&
+                        !UnpackMip(mipInfos[i], packedMips[i].Data(), storage.GetLevel(i))) {
+                        success = false;
+                    }
+                });
+                if (!success) {
+                    return false;
+                }
+            }
+
+            ResetStreaming();
+            m_mappedFile.reset();
+            m_format = static_cast<Format>(header.format);
+            m_flags = header.flags;
+            m_dirtyRegions.clear();
+            m_mipmaps = std::move(mips);
+            SetStorage(std::move(storage));
+            return true;
         }
 
         // Fall back to STB loader
         return LoadFromSTB(path, true);
     }
 
+    bool DSTexture::LoadFromFileMapped(const std::string& path) {
+        auto mappedFile = std::make_shared<DSMappedFile>();
+        if (!mappedFile->Open(path)) {
+            return false;
+        }
+
+        // Not a DST file, images decoded by STB can't be mapped
+        if (!IsDSTData(mappedFile->GetData(), mappedFile->GetSize())) {
+            mappedFile.reset();
+            return LoadFromSTB(path, true);
+        }
+
+        if (!LoadDSTFromMemory(mappedFile->GetData(), mappedFile->GetSize(), true)) {
+            return false;
+        }
+        m_mappedFile = std::move(mappedFile);
+        return true;
+    }
+
+    bool DSTexture::LoadFromMemory(const uint8_t* data, size_t size) {
+        if (IsDSTData(data, size)) {
+            return LoadDSTFromMemory(data, size, false);
+        }
+        return LoadFromSTBMemory(data, size, true);
+    }
+
+    bool DSTexture::LoadFromPack(const DSTexturePack& pack, const std::string& name) {
+        const uint8_t* data = nullptr;
+        size_t size = 0;
+        if (!pack.Find(name, data, size) || !IsDSTData(data, size)) {
+            return false;
+        }
+        return LoadDSTFromMemory(data, size, false);
+    }
+
+    bool DSTexture::LoadFromPackMapped(const DSTexturePack& pack, const std::string& name) {
+        const uint8_t* data = nullptr;
+        size_t size = 0;
+        if (!pack.Find(name, data, size) || !IsDSTData(data, size)) {
+            return false;
+        }
+
+        if (!LoadDSTFromMemory(data, size, true)) {
+            return false;
+        }
+        m_mappedFile = pack.m_file;
+        return true;
+    }
+
+    DSTextureLoadHandle DSTexture::LoadAsync(const std::string& path) {
+        return LoadAsync(path, AsyncLoadOptions());
+    }
+
+    DSTextureLoadHandle DSTexture::LoadAsync(const std::string& path, const AsyncLoadOptions& options) {
+        return DSTextureLoader::Get().Load(path, options);
+    }
+
+    bool DSTexture::IsDSTData(const uint8_t* data, size_t size) {
+        return size >= sizeof(DSTHeader) && data[0] == 'D' && data[1] == 'S' && data[2] == 'T';
+    }
+
+    // Raw mips either point into the data (mapRawMips, the caller keeps it alive) or are copied to the heap
+    bool DSTexture::LoadDSTFromMemory(const uint8_t* fileData, size_t fileSize, bool mapRawMips) {
+        DSTHeader header;
+        std::memcpy(&header, fileData, sizeof(DSTHeader));
+
+        const size_t mipTableEnd = sizeof(DSTHeader) + static_cast<size_t>(header.mipLevels) * GetMipInfoSize(header.version);
+        if (mipTableEnd > fileSize) {
+            return false;
+        }
+
+        std::vector<DSTMipInfoV4> mipInfos;
+        if (!ParseMipTable(header, fileData + sizeof(DSTHeader), mipInfos)) {
+            return false;
+        }
+
+        // Mapped raw mips point into the data, nothing is read until a mip is touched
+        std::vector<MipLevel> mips(header.mipLevels);
+        std::vector<size_t> heapSizes(header.mipLevels, 0);
+        bool hasHeapMips = false;
+        for (uint32_t i = 0; i < header.mipLevels; ++i) {
+            const DSTMipInfoV4& info = mipInfos[i];
+            if (static_cast<size_t>(info.dataOffset) + info.storedSize > fileSize ||
+                (info.compression == DST_MIP_RAW && info.rowPitch == 0 && info.storedSize != info.dataSize)) {
+                return false;
+            }
+
+            MipLevel& mip = mips[i];
+            mip.width = info.width;
+            mip.height = info.height;
+            if (mapRawMips && IsMipStoredAsIs(info)) {
+                mip.mapped = fileData + info.dataOffset;
+                mip.size = info.dataSize;
+            } else {
+                heapSizes[i] = info.dataSize;
+                hasHeapMips = true;
+            }
+        }
+
+        // Compressed and row padded mips can't be used in place, decode them to the heap in parallel
+        DSMipChain storage;
+        storage.Allocate(heapSizes);
+        if (hasHeapMips) {
+            std::atomic<bool> success{true};
+            DSThreadPool::Global().ParallelFor(header.mipLevels, [&](uint32_t i) {
+                if (!mips[i].mapped && !UnpackMip(mipInfos[i], fileData + mipInfos[i].dataOffset, storage.GetLevel(i))) {
+                    success = false;
+                }
+            });
+            if (!success) {
+                return false;
+            }
+        }
+
+        // A version 4 payload is kept as the upload data while the caller keeps the mapping
+        const uint8_t* uploadData = nullptr;
+        UploadLayout uploadLayout;
+        if (mapRawMips && header.version >= DST_VERSION_UPLOAD && header.mipLevels > 0) {
+            uploadData = fileData + mipInfos[0].dataOffset;
+            uploadLayout.mips.resize(header.mipLevels);
+            for (uint32_t i = 0; i < header.mipLevels; ++i) {
+                const DSTMipInfoV4& info = mipInfos[i];
+                if (info.compression != DST_MIP_RAW || info.rowCount == 0 || info.dataOffset < mipInfos[0].dataOffset) {
+                    uploadData = nullptr;
+                    uploadLayout = UploadLayout();
+                    break;
+                }
+
+                UploadMip& mip = uploadLayout.mips[i];
+                mip.offset = info.dataOffset - mipInfos[0].dataOffset;
+                mip.rowPitch = info.rowPitch;
+                mip.rowSize = info.dataSize / info.rowCount;
+                mip.rowCount = info.rowCount;
+                uploadLayout.size = std::max(uploadLayout.size, mip.offset + info.storedSize);
+            }
+        }
+
+        ResetStreaming();
+        m_mappedFile.reset();
+        m_format = static_cast<Format>(header.format);
+        m_flags = header.flags;
+        m_dirtyRegions.clear();
+        m_mipmaps = std::move(mips);
+        m_uploadData = uploadData;
+        m_uploadLayout = std::move(uploadLayout);
+        SetStorage(std::move(storage));
+        return true;
+    }
+
+    bool DSTexture::LoadFromFileStreamed(const std::string& path, size_t tailBytes) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file.is_open()) {
+            return false;
+        }
+
+        // Only DST files can be streamed
+        DSTHeader header;
+        file.read(reinterpret_cast<char*>(&header), sizeof(DSTHeader));
+        if (!file.good() || header.magic[0] != 'D' || header.magic[1] != 'S' || header.magic[2] != 'T' ||
+            header.mipLevels == 0) {
+            return false;
+        }
+
+        std::vector<DSTMipInfoV4> mipInfos;
+        if (!ReadMipTable(file, header, mipInfos)) {
+            return false;
+        }
+
+        // The tail is made of the smallest mips fitting in tailBytes, the last one is always loaded
+        uint32_t tailMip = header.mipLevels - 1;
+        size_t tailSize = mipInfos[tailMip].dataSize;
+        while (tailMip > 0 && tailSize + mipInfos[tailMip - 1].dataSize <= tailBytes) {
+            tailMip--;
+            tailSize += mipInfos[tailMip].dataSize;
+        }
+
+        std::vector<MipLevel> mips(header.mipLevels);
+        std::vector<size_t> sizes(header.mipLevels, 0);
+        for (uint32_t i = 0; i < header.mipLevels; ++i) {
+            mips[i].width = mipInfos[i].width;
+            mips[i].height = mipInfos[i].height;
+            if (i >= tailMip) {
+                sizes[i] = mipInfos[i].dataSize;
+            }
+        }
+
+        DSMipChain storage;
+        storage.Allocate(sizes);
+        for (uint32_t i = tailMip; i < header.mipLevels; ++i) {
+            if (!ReadMip(file, mipInfos[i], storage.GetLevel(i))) {
+                return false;
+            }
+        }
+
+        ResetStreaming();
+        m_mappedFile.reset();
+        m_format = static_cast<Format>(header.format);
+        m_flags = header.flags;
+        m_dirtyRegions.clear();
+        m_mipmaps = std::move(mips);
+        SetStorage(std::move(storage));
+
+        m_streaming = std::make_unique<StreamingState>();
+        m_streaming->path = path;
+        m_streaming->mipInfos = std::move(mipInfos);
+        m_streaming->residentMip = tailMip;
+        m_streaming->tailMip = tailMip;
+        DSTextureStreamer::Get().Register(this);
+        return true;
+    }
+
+    // =====================
+    // GPU Upload Layout
+    // =====================
+
+    DSTexture::UploadLayout DSTexture::GetUploadLayout(const UploadAlignment& alignment) const {
+        UploadLayout layout;
+        const size_t texelSize = GetBlockSize(m_format);  // A whole 4x4 block for DXT
+        if (texelSize == 0) {
+            return layout;
+        }
+
+        // Vulkan wants offsets and row lengths in whole texels (blocks), on top of the optimal alignments
+        const size_t offsetAlignment = std::lcm<size_t>(std::max<uint32_t>(alignment.offset, 1), texelSize);
+        const size_t pitchAlignment = std::lcm<size_t>(std::max<uint32_t>(alignment.rowPitch, 1), texelSize);
+        const bool compressed = IsCompressed();
+
+        layout.mips.resize(m_mipmaps.size());
+        for (size_t i = 0; i < m_mipmaps.size(); ++i) {
+            const MipLevel& level = m_mipmaps[i];
+            UploadMip& mip = layout.mips[i];
+            const size_t columns = compressed ? (level.width + 3) / 4 : level.width;
+            mip.rowCount = compressed ? (level.height + 3) / 4 : level.height;
+            mip.rowSize = columns * texelSize;
+            mip.rowPitch = (mip.rowSize + pitchAlignment - 1) / pitchAlignment * pitchAlignment;
+            mip.offset = (layout.size + offsetAlignment - 1) / offsetAlignment * offsetAlignment;
+            layout.size = mip.offset + mip.rowPitch * mip.rowCount;
+        }
+        return layout;
+    }
+
+    bool DSTexture::CopyUploadData(const UploadAlignment& alignment, uint8_t* dest) const {
+        const UploadLayout layout = GetUploadLayout(alignment);
+        if (const uint8_t* mapped = GetMappedUploadData(alignment)) {
+            std::memcpy(dest, mapped, layout.size);
+            return true;
+        }
+
+        // Repack row by row, padding is zeroed so saved files don't depend on the staging memory
+        size_t end = 0;
+        for (size_t i = 0; i < layout.mips.size(); ++i) {
+            const UploadMip& mip = layout.mips[i];
+            const uint8_t* source = m_mipmaps[i].Bytes();
+            if (!source) {
+                return false;
+            }
+
+            std::memset(dest + end, 0, mip.offset - end);
+            for (uint32_t row = 0; row < mip.rowCount; ++row) {
+                uint8_t* target = dest + mip.offset + row * mip.rowPitch;
+                std::memcpy(target, source + row * mip.rowSize, mip.rowSize);
+                std::memset(target + mip.rowSize, 0, mip.rowPitch - mip.rowSize);
+            }
+            end = mip.offset + mip.rowPitch * mip.rowCount;
+        }
+        return true;
+    }
+
+    const uint8_t* DSTexture::GetMappedUploadData(const UploadAlignment& alignment) const {
+        if (!m_mappedFile || !m_uploadData) {
+            return nullptr;
+        }
+
+        // The layout only depends on the mip sizes, format and alignment, the one the file was saved with matches
+        const UploadLayout layout = GetUploadLayout(alignment);
+        if (layout.size != m_uploadLayout.size || layout.mips.size() != m_uploadLayout.mips.size()) {
+            return nullptr;
+        }
+        for (size_t i = 0; i < layout.mips.size(); ++i) {
+            const UploadMip& expected = layout.mips[i];
+            const UploadMip& stored = m_uploadLayout.mips[i];
+            if (expected.offset != stored.offset || expected.rowPitch != stored.rowPitch ||
+                expected.rowSize != stored.rowSize || expected.rowCount != stored.rowCount) {
+                return nullptr;
+            }
+        }
+        return m_uploadData;
+    }
+
+    // =====================
+    // DST Mip Table Helpers
+    // =====================
+
+    size_t DSTexture::GetMipInfoSize(uint16_t version) {
+        if (version >= DST_VERSION_UPLOAD) return sizeof(DSTMipInfoV4);
+        return version >= DST_VERSION_LZ ? sizeof(DSTMipInfoV3) : sizeof(DSTMipInfo);
+    }
+
+    bool DSTexture::ParseMipTable(const DSTHeader& header, const uint8_t* table, std::vector<DSTMipInfoV4>& mipInfos) {
+        const Format format = static_cast<Format>(header.format);
+        if (GetPixelSize(format) == 0) {
+            return false;
+        }
+
+        mipInfos.resize(header.mipLevels);
+
+        for (uint32_t i = 0; i < header.mipLevels; ++i) {
+            DSTMipInfoV4& info = mipInfos[i];
+            if (header.version >= DST_VERSION_UPLOAD) {
+                std::memcpy(&info, table + i * sizeof(DSTMipInfoV4), sizeof(DSTMipInfoV4));
+            } else if (header.version >= DST_VERSION_LZ) {
+                // Same fields without the row layout, rows are tightly packed
+                std::memcpy(&info, table + i * sizeof(DSTMipInfoV3), sizeof(DSTMipInfoV3));
+                info.rowPitch = 0;
+                info.rowCount = 0;
+            } else {
+                // Version 2 mips are always stored raw
+                DSTMipInfo legacy;
+                std::memcpy(&legacy, table + i * sizeof(DSTMipInfo), sizeof(DSTMipInfo));
+                info.width = legacy.width;
+                info.height = legacy.height;
+                info.dataSize = legacy.dataSize;
+                info.dataOffset = legacy.dataOffset;
+                info.storedSize = legacy.dataSize;
+                info.compression = DST_MIP_RAW;
+                info.rowPitch = 0;
+                info.rowCount = 0;
+            }
+
+            // Loaders size and map the levels from dataSize, it must cover exactly the mip (in 64 bits, no overflow)
+            const uint64_t blockSize = GetBlockSize(format);
+            const uint64_t expectedSize = IsFormatCompressed(format)
+                ? ((info.width + 3ull) / 4) * ((info.height + 3ull) / 4) * blockSize
+                : static_cast<uint64_t>(info.width) * info.height * blockSize;
+            if (info.dataSize != expectedSize) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool DSTexture::ReadMipTable(std::istream& file, const DSTHeader& header, std::vector<DSTMipInfoV4>& mipInfos) {
+        std::vector<uint8_t> table(header.mipLevels * GetMipInfoSize(header.version));
+        file.read(reinterpret_cast<char*>(table.data()), table.size());
+        if (!file.good()) {
+            return false;
+        }
+
+        return ParseMipTable(header, table.data(), mipInfos);
+    }
+
+    bool DSTexture::ReadMip(std::istream& file, const DSTMipInfoV4& info, uint8_t* dest) {
+        file.seekg(info.dataOffset);
+
+        if (IsMipStoredAsIs(info)) {
+            file.read(reinterpret_cast<char*>(dest), info.dataSize);
+            return file.good();
+        }
+
+        DSBufferPool::Buffer packed(info.storedSize);
+        file.read(reinterpret_cast<char*>(packed.Data()), packed.Size());
+        return file.good() && UnpackMip(info, packed.Data(), dest);
+    }
+
+    bool DSTexture::UnpackMip(const DSTMipInfoV4& info, const uint8_t* stored, uint8_t* dest) {
+        switch (info.compression) {
+            case DST_MIP_RAW: {
+                if (info.rowPitch == 0) {
+                    std::memcpy(dest, stored, info.dataSize);
+                    return true;
+                }
+
+                // Upload layout, rows are padded to the row pitch
+                if (info.rowCount == 0 || info.dataSize % info.rowCount != 0 || info.dataSize / info.rowCount > info.rowPitch ||
+                    static_cast<uint64_t>(info.rowPitch) * info.rowCount > info.storedSize) {
+                    return false;
+                }
+                const size_t rowSize = info.dataSize / info.rowCount;
+                for (uint32_t row = 0; row < info.rowCount; ++row) {
+                    std::memcpy(dest + row * rowSize, stored + static_cast<size_t>(row) * info.rowPitch, rowSize);
+                }
+                return true;
+            }
+            case DST_MIP_LZ:
+                return DSLZCodec::Decompress(stored, info.storedSize, dest, info.dataSize);
+            default:
+                return false;
+        }
+    }
+
+    bool DSTexture::IsMipStoredAsIs(const DSTMipInfoV4& info) {
+        return info.compression == DST_MIP_RAW && info.storedSize == info.dataSize;
+    }
+
+    bool DSTexture::IsMipResident(uint32_t mipLevel) const {
+        return ValidateMipLevel(mipLevel) && (!m_streaming || mipLevel >= m_streaming->residentMip);
+    }
+
+    uint32_t DSTexture::GetResidentMip() const {
+        return m_streaming ? m_streaming->residentMip : 0;
+    }
+
+    void DSTexture::RequestMip(uint32_t mipLevel) {
+        if (m_streaming && ValidateMipLevel(mipLevel)) {
+            DSTextureStreamer::Get().Request(this, mipLevel);
+        }
+    }
+
     bool DSTexture::LoadFromSTB(const std::string& path, bool flipVertically) {
-        stbi_set_flip_vertically_on_load(flipVertically);
+        stbi_set_flip_vertically_on_load_thread(flipVertically);
 
-        int width, height, channels;
+        int width = 0, height = 0, channels = 0;
+        if (stbi_is_hdr(path.c_str())) {
+            float* data = stbi_loadf(path.c_str(), &width, &height, &channels, 0);
+            return AdoptSTBFloatImage(data, width, height, channels);
+        }
         unsigned char* data = stbi_load(path.c_str(), &width, &height, &channels, 0);
+        return AdoptSTBImage(data, width, height, channels);
+    }
+
+    bool DSTexture::LoadFromSTBMemory(const uint8_t* fileData, size_t fileSize, bool flipVertically) {
+        if (fileSize > static_cast<size_t>(INT32_MAX)) return false;
+        stbi_set_flip_vertically_on_load_thread(flipVertically);
+
+        int width = 0, height = 0, channels = 0;
+        if (stbi_is_hdr_from_memory(fileData, static_cast<int>(fileSize))) {
+            float* data = stbi_loadf_from_memory(fileData, static_cast<int>(fileSize), &width, &height, &channels, 0);
+            return AdoptSTBFloatImage(data, width, height, channels);
+        }
+        unsigned char* data = stbi_load_from_memory(fileData, static_cast<int>(fileSize), &width, &height, &channels, 0);
+        return AdoptSTBImage(data, width, height, channels);
+    }
+
+    // Takes ownership of an image returned by stb_image
+    bool DSTexture::AdoptSTBImage(unsigned char* data, int width, int height, int channels) {
         if (!data) return false;
 
+        m_mipmaps.clear();
+        m_mappedFile.reset();
+        ResetStreaming();
+        m_dirtyRegions.clear();
+
         // Determine format
         switch (channels) {
             case 1: m_format = Format::RGB8; break; // Convert to RGB8 for consistency
@@ -163,36 +749,77 @@ namespace DSEngine {
         MipLevel baseLevel;
         baseLevel.width = width;
         baseLevel.height = height;
+        m_mipmaps.push_back(baseLevel);
+
+        DSMipChain storage;
+        storage.Allocate(GetMipSizes(m_mipmaps, m_format));
+        uint8_t* dest = storage.GetLevel(0);
 
         // Convert to target format if needed
         if ((channels == 3 && m_format == Format::RGB8) ||
             (channels == 4 && m_format == Format::RGBA8)) {
             // Direct copy
             const size_t dataSize = width * height * channels;
-            baseLevel.data.assign(data, data + dataSize);
-            } else {
-                // Convert channels
-                const size_t targetPixelSize = GetPixelSize(m_format);
-                baseLevel.data.resize(width * height * targetPixelSize);
-
-                if (channels == 1 && m_format == Format::RGB8) {
-                    // Grayscale to RGB
-                    for (int i = 0; i < width * height; i++) {
-                        baseLevel.data[i*3] = data[i];
-                        baseLevel.data[i*3+1] = data[i];
-                        baseLevel.data[i*3+2] = data[i];
-                    }
-                } else if (channels == 2 && m_format == Format::RGB8) {
-                    // GA to RGB (drop alpha)
-                    for (int i = 0; i < width * height; i++) {
-                        baseLevel.data[i*3] = data[i*2];
-                        baseLevel.data[i*3+1] = data[i*2];
-                        baseLevel.data[i*3+2] = data[i*2];
-                    }
+            std::memcpy(dest, data, dataSize);
+        } else if (channels == 1 && m_format == Format::RGB8) {
+            // Grayscale to RGB
+            DSPixelConverter::GrayToRGB8(data, dest, static_cast<size_t>(width) * height);
+        } else if (channels == 2 && m_format == Format::RGB8) {
+            // GA to RGB (drop alpha)
+            DSPixelConverter::GrayAlphaToRGB8(data, dest, static_cast<size_t>(width) * height);
+        }
+
+        SetStorage(std::move(storage));
+        stbi_image_free(data);
+        return true;
+    }
+
+    // Takes ownership of a float image returned by stb_image, channels are laid out like in AdoptSTBImage
+    bool DSTexture::AdoptSTBFloatImage(float* data, int width, int height, int channels) {
+        if (!data) return false;
+        if (channels < 1 || channels > 4) {
+            stbi_image_free(data);
+            return false;
+        }
+
+        m_mipmaps.clear();
+        m_mappedFile.reset();
+        ResetStreaming();
+        m_dirtyRegions.clear();
+
+        m_format = Format::RGBA16F;
+        MipLevel baseLevel;
+        baseLevel.width = width;
+        baseLevel.height = height;
+        m_mipmaps.push_back(baseLevel);
+
+        DSMipChain storage;
+        storage.Allocate(GetMipSizes(m_mipmaps, m_format));
+        uint16_t* dest = reinterpret_cast<uint16_t*>(storage.GetLevel(0));
+        const size_t pixelCount = static_cast<size_t>(width) * height;
+
+        if (channels == 4) {
+            DSFloatConverter::FloatToHalf(data, dest, pixelCount * 4);
+        } else {
+            // Gray is replicated, alpha is 1 unless the image has it
+            const bool hasAlpha = (channels == 2);
+            const uint32_t colorChannels = hasAlpha ? 1 : channels;
+            DSBufferPool::Buffer row(static_cast<size_t>(width) * 4 * sizeof(float));
+            float* rgba = reinterpret_cast<float*>(row.Data());
+
+            for (int y = 0; y < height; y++) {
+                const float* src = data + static_cast<size_t>(y) * width * channels;
+                for (int x = 0; x < width; x++, src += channels) {
+                    rgba[x * 4 + 0] = src[0];
+                    rgba[x * 4 + 1] = src[colorChannels > 1 ? 1 : 0];
+                    rgba[x * 4 + 2] = src[colorChannels > 2 ? 2 : 0];
+                    rgba[x * 4 + 3] = hasAlpha ? src[1] : 1.0f;
                 }
+                DSFloatConverter::FloatToHalf(rgba, dest + static_cast<size_t>(y) * width * 4, static_cast<size_t>(width) * 4);
             }
+        }
 
-        m_mipmaps.push_back(std::move(baseLevel));
+        SetStorage(std::move(storage));
         stbi_image_free(data);
         return true;
     }
@@ -206,11 +833,96 @@ namespace DSEngine {
         return level < m_mipmaps.size();
     }
 
+    std::vector<size_t> DSTexture::GetMipSizes(const std::vector<MipLevel>& mips, Format format) {
+        std::vector<size_t> sizes(mips.size());
+        for (size_t i = 0; i < mips.size(); ++i) {
+            sizes[i] = CalculateMipSize(mips[i].width, mips[i].height, format);
+        }
+        return sizes;
+    }
+
+    // Points every mip with storage into the new chain, the others keep their mapping or stay non resident.
+    // The previous chain goes back to the buffer pool.
+    void DSTexture::SetStorage(DSMipChain&& storage) {
+        m_storage = std::move(storage);
+
+        for (uint32_t i = 0; i < m_mipmaps.size(); ++i) {
+            MipLevel& mip = m_mipmaps[i];
+            mip.data = (i < m_storage.GetLevelCount()) ? m_storage.GetLevel(i) : nullptr;
+            if (mip.data) {
+                mip.mapped = nullptr;
+                mip.size = m_storage.GetLevelSize(i);
+            } else if (!mip.mapped) {
+                mip.size = 0;
+            }
+        }
+    }
+
+    // Copies the mapped mips to the heap so they can be modified
+    void DSTexture::DetachMapping() {
+        if (!m_mappedFile) return;
+
+        std::vector<size_t> sizes(m_mipmaps.size());
+        for (size_t i = 0; i < m_mipmaps.size(); ++i) {
+            sizes[i] = m_mipmaps[i].Size();
+        }
+
+        DSMipChain storage;
+        storage.Allocate(sizes);
+        for (uint32_t i = 0; i < m_mipmaps.size(); ++i) {
+            if (sizes[i]) {
+                std::memcpy(storage.GetLevel(i), m_mipmaps[i].Bytes(), sizes[i]);
+            }
+        }
+
+        SetStorage(std::move(storage));
+        m_mappedFile.reset();
+    }
+
+    // Loads the mips that are not resident and turns the texture back into a regular one
+    bool DSTexture::EndStreaming() {
+        if (!m_streaming) return true;
+
+        const uint32_t residentMip = m_streaming->residentMip;
+        if (residentMip > 0) {
+            std::vector<size_t> sizes(m_mipmaps.size());
+            for (uint32_t i = 0; i < m_mipmaps.size(); ++i) {
+                sizes[i] = (i < residentMip) ? m_streaming->mipInfos[i].dataSize : m_mipmaps[i].Size();
+            }
+
+            DSMipChain storage;
+            storage.Allocate(sizes);
+
+            std::ifstream file(m_streaming->path, std::ios::binary);
+            for (uint32_t i = 0; i < residentMip; ++i) {
+                if (!ReadMip(file, m_streaming->mipInfos[i], storage.GetLevel(i))) {
+                    return false;
+                }
+            }
+            for (uint32_t i = residentMip; i < m_mipmaps.size(); ++i) {
+                std::memcpy(storage.GetLevel(i), m_mipmaps[i].Bytes(), sizes[i]);
+            }
+
+            SetStorage(std::move(storage));
+        }
+
+        ResetStreaming();
+        return true;
+    }
+
+    void DSTexture::ResetStreaming() {
+        if (m_streaming) {
+            DSTextureStreamer::Get().Unregister(this);
+            m_streaming.reset();
+        }
+    }
+
     bool DSTexture::ConvertFormat(Format newFormat) {
         if (m_mipmaps.empty()) return false;
 
         // No conversion needed if formats match
         if (m_format == newFormat) return true;
+        if (!EndStreaming()) return false;
 
         // Handle compressed-to-compressed conversion
         if (IsFormatCompressed(m_format) && IsFormatCompressed(newFormat)) {
@@ -230,239 +942,214 @@ namespace DSEngine {
         }
 
         // Handle uncompressed-to-uncompressed conversion
-        std::vector<MipLevel> convertedMips;
-        convertedMips.reserve(m_mipmaps.size());
+        DSMipChain storage;
+        storage.Allocate(GetMipSizes(m_mipmaps, newFormat));
 
-        for (const auto& mip : m_mipmaps) {
-            MipLevel newMip;
-            newMip.width = mip.width;
-            newMip.height = mip.height;
-
-            // Calculate new data size
-            size_t newPixelSize = GetPixelSize(newFormat);
-            size_t newDataSize = mip.width * mip.height * newPixelSize;
-            newMip.data.resize(newDataSize);
+        for (uint32_t i = 0; i < m_mipmaps.size(); ++i) {
+            if (IsFormatFloat(m_format) || IsFormatFloat(newFormat)) {
+                if (!ConvertThroughFloat(m_mipmaps[i], storage.GetLevel(i), newFormat)) return false;
+                continue;
+            }
 
             // Perform conversion
             bool success = false;
             switch (m_format) {
                 case Format::RGB8:
-                    success = ConvertFromRGB8(mip, newMip, newFormat);
+                    success = ConvertFromRGB8(m_mipmaps[i], storage.GetLevel(i), newFormat);
                     break;
                 case Format::RGBA8:
-                    success = ConvertFromRGBA8(mip, newMip, newFormat);
+                    success = ConvertFromRGBA8(m_mipmaps[i], storage.GetLevel(i), newFormat);
+                    break;
+                case Format::R8:
+                    success = ConvertFromR8(m_mipmaps[i], storage.GetLevel(i), newFormat);
+                    break;
+                case Format::RG8:
+                    success = ConvertFromRG8(m_mipmaps[i], storage.GetLevel(i), newFormat);
                     break;
                 default:
                     return false;
             }
 
             if (!success) return false;
-            convertedMips.push_back(std::move(newMip));
         }
 
-        m_mipmaps = std::move(convertedMips);
+        SetStorage(std::move(storage));
+        m_mappedFile.reset();
         m_format = newFormat;
         return true;
     }
 
-    bool DSTexture::ConvertFromRGB8(const MipLevel& source, MipLevel& dest, Format newFormat) {
-        const uint8_t* src = source.data.data();
-        uint8_t* dst = dest.data.data();
-        const size_t srcPixelSize = 3; // RGB8
-        const size_t dstPixelSize = GetPixelSize(newFormat);
-        const size_t pixelCount = source.width * source.height;
+    bool DSTexture::ConvertFromRGB8(const MipLevel& source, uint8_t* dest, Format newFormat) {
+        const size_t pixelCount = static_cast<size_t>(source.width) * source.height;
 
         switch (newFormat) {
-            case Format::RGBA8: {
-                // RGB8 -> RGBA8 (add alpha channel)
-                for (size_t i = 0; i < pixelCount; i++) {
-                    dst[0] = src[0]; // R
-                    dst[1] = src[1]; // G
-                    dst[2] = src[2]; // B
-                    dst[3] = 255;    // A (fully opaque)
-                    src += srcPixelSize;
-                    dst += dstPixelSize;
-                }
+            case Format::RGBA8:
+                // RGB8 -> RGBA8 (add alpha channel, fully opaque)
+                DSPixelConverter::RGB8ToRGBA8(source.Bytes(), dest, pixelCount);
+                return true;
+            case Format::R8:
+            case Format::RG8:
+                // Keep red (and green)
+                DSPixelConverter::KeepChannels(source.Bytes(), 3, dest, GetChannelCount(newFormat), pixelCount);
                 return true;
-            }
             default:
                 return false;
         }
     }
 
-    bool DSTexture::ConvertFromRGBA8(const MipLevel& source, MipLevel& dest, Format newFormat) {
-        const uint8_t* src = source.data.data();
-        uint8_t* dst = dest.data.data();
-        const size_t srcPixelSize = 4; // RGBA8
-        const size_t dstPixelSize = GetPixelSize(newFormat);
-        const size_t pixelCount = source.width * source.height;
+    bool DSTexture::ConvertFromRGBA8(const MipLevel& source, uint8_t* dest, Format newFormat) {
+        const size_t pixelCount = static_cast<size_t>(source.width) * source.height;
 
         switch (newFormat) {
-            case Format::RGB8: {
+            case Format::RGB8:
                 // RGBA8 -> RGB8 (drop alpha channel)
-                for (size_t i = 0; i < pixelCount; i++) {
-                    dst[0] = src[0]; // R
-                    dst[1] = src[1]; // G
-                    dst[2] = src[2]; // B
-                    src += srcPixelSize;
-                    dst += dstPixelSize;
-                }
+                DSPixelConverter::RGBA8ToRGB8(source.Bytes(), dest, pixelCount);
+                return true;
+            case Format::R8:
+            case Format::RG8:
+                // Keep red (and green)
+                DSPixelConverter::KeepChannels(source.Bytes(), 4, dest, GetChannelCount(newFormat), pixelCount);
                 return true;
-            }
             default:
                 return false;
         }
     }
 
-    // =============================================
-    // Compression/Decompression Implementation
-    // =============================================
+    bool DSTexture::ConvertFromR8(const MipLevel& source, uint8_t* dest, Format newFormat) {
+        const size_t pixelCount = static_cast<size_t>(source.width) * source.height;
 
-    // Compression implementation using stb_dxt
-    bool DSTexture::Compress(Format dxtFormat, CompressionQuality quality) {
-        if (m_mipmaps.empty() || (dxtFormat != Format::DXT1 && dxtFormat != Format::DXT5)) {
-            return false;
+        switch (newFormat) {
+            case Format::RGB8:
+                // R8 -> RGB8 (gray)
+                DSPixelConverter::GrayToRGB8(source.Bytes(), dest, pixelCount);
+                return true;
+            case Format::RGBA8:
+            case Format::RG8:
+                DSPixelConverter::ExpandChannels(source.Bytes(), 1, dest, GetChannelCount(newFormat), pixelCount);
+                return true;
+            default:
+                return false;
         }
+    }
 
-        // If already in target format, return success
-        if (m_format == dxtFormat) {
-            return true;
-        }
+    bool DSTexture::ConvertFromRG8(const MipLevel& source, uint8_t* dest, Format newFormat) {
+        const size_t pixelCount = static_cast<size_t>(source.width) * source.height;
 
-        // Must be RGBA8 to compress to DXT
-        if (m_format != Format::RGBA8) {
-            // Convert to RGBA8 first
-            if (!ConvertFormat(Format::RGBA8)) {
+        switch (newFormat) {
+            case Format::R8:
+                // RG8 -> R8 (drop green)
+                DSPixelConverter::KeepChannels(source.Bytes(), 2, dest, 1, pixelCount);
+                return true;
+            case Format::RGB8:
+            case Format::RGBA8:
+                // Blue 0, alpha opaque
+                DSPixelConverter::ExpandChannels(source.Bytes(), 2, dest, GetChannelCount(newFormat), pixelCount);
+                return true;
+            default:
                 return false;
-            }
         }
+    }
 
-        std::vector<MipLevel> compressedMips;
-        compressedMips.reserve(m_mipmaps.size());
-
-        for (MipLevel &mip : m_mipmaps) {
-            MipLevel newMip;
-            newMip.width = mip.width;
-            newMip.height = mip.height;
-
-            // Calculate compressed size (4x4 blocks)
-            uint32_t blocksWide = (mip.width + 3) / 4;
-            uint32_t blocksHigh = (mip.height + 3) / 4;
-            size_t compressedSize = blocksWide * blocksHigh * (dxtFormat == Format::DXT1 ? 8 : 16);
-            newMip.data.resize(compressedSize);
+    bool DSTexture::ConvertThroughFloat(const MipLevel& source, uint8_t* dest, Format newFormat) {
+        if (GetPixelSize(m_format) == 0 || GetPixelSize(newFormat) == 0) return false;
 
-            // Compress using appropriate method
-            bool success = false;
-            switch (dxtFormat) {
-                case Format::DXT1:
-                    success = CompressDXT1(mip, newMip, quality);
-                    break;
-                case Format::DXT5:
-                    success = CompressDXT5(mip, newMip, quality);
-                    break;
-                default:
-                    return false;
-            }
+        const size_t sourceRowSize = source.width * GetPixelSize(m_format);
+        const size_t destRowSize = source.width * GetPixelSize(newFormat);
+        DSBufferPool::Buffer row(static_cast<size_t>(source.width) * 4 * sizeof(float));
+        float* rgba = reinterpret_cast<float*>(row.Data());
 
-            if (!success) return false;
-            compressedMips.push_back(std::move(newMip));
+        for (uint32_t y = 0; y < source.height; ++y) {
+            ConvertToRGBA32F(m_format, source.Bytes() + y * sourceRowSize, rgba, source.width);
+            ConvertFromRGBA32F(newFormat, rgba, dest + y * destRowSize, source.width);
         }
-
-        m_mipmaps = std::move(compressedMips);
-        m_format = dxtFormat;
         return true;
     }
 
+    // =============================================
+    // Compression/Decompression Implementation
+    // =============================================
 
-    bool DSTexture::CompressDXT1(MipLevel& source, MipLevel& dest, CompressionQuality quality) {
-        const int alpha = 1; // STB_DXT flag for DXT1 with alpha
-        const int mode = (quality == CompressionQuality::FAST) ? STB_DXT_NORMAL : STB_DXT_HIGHQUAL;
-
-        // Process all 4x4 blocks
-        uint32_t blocksWide = (source.width + 3) / 4;
-        uint32_t blocksHigh = (source.height + 3) / 4;
-
-        for (uint32_t by = 0; by < blocksHigh; by++) {
-            for (uint32_t bx = 0; bx < blocksWide; bx++) {
-                uint8_t blockPixels[4*4*4];
-
-                // Extract 4x4 RGBA block (with edge padding)
-                for (int y = 0; y < 4; y++) {
-                    for (int x = 0; x < 4; x++) {
-                        int sx = bx*4 + x;
-                        int sy = by*4 + y;
-
-                        // Clamp to texture dimensions
-                        sx = std::min(sx, (int)source.width-1);
-                        sy = std::min(sy, (int)source.height-1);
+    // Compression implementation using DSDXTEncoder (stb_dxt with fast paths, BC4/BC5 encoder)
+    bool DSTexture::Compress(Format dxtFormat, CompressionQuality quality, uint32_t maxThreads) {
+        if (m_mipmaps.empty() || !IsFormatCompressed(dxtFormat)) {
+            return false;
+        }
 
-                        const uint8_t* src = source.data.data() + (sy * source.width + sx) * 4;
-                        uint8_t* dst = blockPixels + (y*4 + x) * 4;
+        // If already in target format, return success
+        if (m_format == dxtFormat) {
+            return true;
+        }
 
-                        dst[0] = src[0];
-                        dst[1] = src[1];
-                        dst[2] = src[2];
-                        dst[3] = src[3];
-                    }
-                }
+        if (!EndStreaming()) {
+            return false;
+        }
 
-                // Compress the block
-                uint8_t* output = dest.data.data() + (by * blocksWide + bx) * 8;
-                stb_compress_dxt_block(output, blockPixels, alpha, mode);
+        // DXT encodes RGBA8, BC4/BC5 their decompressed layout
+        const bool dxt = (dxtFormat == Format::DXT1 || dxtFormat == Format::DXT5);
+        const Format sourceFormat = dxt ? Format::RGBA8 : GetDecompressedFormat(dxtFormat);
+        if (m_format != sourceFormat) {
+            // Convert first
+            if (!ConvertFormat(sourceFormat)) {
+                return false;
             }
         }
 
-        return true;
-    }
-
-    bool DSTexture::CompressDXT5(MipLevel& source, MipLevel& dest, CompressionQuality quality) {
-        const int mode = (quality == CompressionQuality::FAST) ? STB_DXT_NORMAL : STB_DXT_HIGHQUAL;
+        // Split every mip in ranges of block rows, each range is an independent job
+        struct CompressJob {
+            uint32_t mip;
+            uint32_t firstBlockRow;
+            uint32_t blockRowCount;
+        };
+        const uint32_t blockRowsPerJob = 16;
 
-        // Process all 4x4 blocks
-        uint32_t blocksWide = (source.width + 3) / 4;
-        uint32_t blocksHigh = (source.height + 3) / 4;
+        DSMipChain storage;
+        storage.Allocate(GetMipSizes(m_mipmaps, dxtFormat));
+        std::vector<CompressJob> jobs;
 
-        for (uint32_t by = 0; by < blocksHigh; by++) {
-            for (uint32_t bx = 0; bx < blocksWide; bx++) {
-                uint8_t blockPixels[4*4*4];
-
-                // Extract 4x4 RGBA block (with edge padding)
-                for (int y = 0; y < 4; y++) {
-                    for (int x = 0; x < 4; x++) {
-                        int sx = bx*4 + x;
-                        int sy = by*4 + y;
-
-                        // Clamp to texture dimensions
-                        sx = std::min(sx, (int)source.width-1);
-                        sy = std::min(sy, (int)source.height-1);
+        for (uint32_t i = 0; i < m_mipmaps.size(); i++) {
+            const MipLevel& mip = m_mipmaps[i];
+            uint32_t blocksHigh = (mip.height + 3) / 4;
+            for (uint32_t row = 0; row < blocksHigh; row += blockRowsPerJob) {
+                jobs.push_back({i, row, std::min(blockRowsPerJob, blocksHigh - row)});
+            }
+        }
 
-                        const uint8_t* src = source.data.data() + (sy * source.width + sx) * 4;
-                        uint8_t* dst = blockPixels + (y*4 + x) * 4;
+        auto compressJob = [&](uint32_t jobIndex) {
+            const CompressJob& job = jobs[jobIndex];
+            const MipLevel& source = m_mipmaps[job.mip];
+            uint8_t* dest = storage.GetLevel(job.mip);
 
-                        dst[0] = src[0];
-                        dst[1] = src[1];
-                        dst[2] = src[2];
-                        dst[3] = src[3];
-                    }
-                }
+            if (dxt) {
+                DSDXTEncoder::EncodeRows(source.Bytes(), source.width, source.height, job.firstBlockRow, job.blockRowCount,
+                                         dest, dxtFormat == Format::DXT5, quality == CompressionQuality::NORMAL);
+            } else {
+                DSDXTEncoder::EncodeChannelRows(source.Bytes(), GetChannelCount(dxtFormat), source.width, source.height,
+                                                job.firstBlockRow, job.blockRowCount, dest, quality == CompressionQuality::NORMAL);
+            }
+        };
 
-                // Compress the block (DXT5 is two DXT blocks: alpha + color)
-                uint8_t* output = dest.data.data() + (by * blocksWide + bx) * 16;
-                stb_compress_dxt_block(output, blockPixels, 0, mode); // Alpha block
-                stb_compress_dxt_block(output+8, blockPixels, 0, mode); // Color block
+        if (maxThreads == 1) {
+            for (uint32_t j = 0; j < jobs.size(); j++) {
+                compressJob(j);
             }
+        } else {
+            DSThreadPool::Global().ParallelFor(static_cast<uint32_t>(jobs.size()), compressJob, maxThreads);
         }
 
+        SetStorage(std::move(storage));
+        m_mappedFile.reset();
+        m_format = dxtFormat;
         return true;
     }
 
+
     bool DSTexture::Decompress() {
-        if (!IsCompressed() || m_mipmaps.empty()) {
+        if (!IsCompressed() || m_mipmaps.empty() || !EndStreaming()) {
             return false;
         }
 
         // Determine target format based on compression type
-        Format targetFormat = (m_format == Format::DXT1) ? Format::RGB8 : Format::RGBA8;
+        Format targetFormat = GetDecompressedFormat(m_format);
 
         // Perform the decompression
         if (!DecompressDXT()) {
@@ -474,156 +1161,49 @@ namespace DSEngine {
     }
 
     bool DSTexture::DecompressDXT() {
-        std::vector<MipLevel> decompressedMips;
-        decompressedMips.reserve(m_mipmaps.size());
+        const Format decompressedFormat = GetDecompressedFormat(m_format);
+        DSMipChain storage;
+        storage.Allocate(GetMipSizes(m_mipmaps, decompressedFormat));
 
-        for (const auto& mip : m_mipmaps) {
-            MipLevel newMip;
-            newMip.width = mip.width;
-            newMip.height = mip.height;
+        for (uint32_t i = 0; i < m_mipmaps.size(); ++i) {
+            const MipLevel& mip = m_mipmaps[i];
 
-            // Calculate decompressed size
-            size_t pixelSize = (m_format == Format::DXT1) ? 3 : 4;
-            size_t decompressedSize = mip.width * mip.height * pixelSize;
-            newMip.data.resize(decompressedSize);
-
-            uint32_t blocksWide = (mip.width + 3) / 4;
-            uint32_t blocksHigh = (mip.height + 3) / 4;
-            uint32_t blockSize = (m_format == Format::DXT1) ? 8 : 16;
-
-            for (uint32_t by = 0; by < blocksHigh; by++) {
-                for (uint32_t bx = 0; bx < blocksWide; bx++) {
-                    const uint8_t* block = mip.data.data() + (by * blocksWide + bx) * blockSize;
-                    uint8_t* output = newMip.data.data() + (by * 4 * mip.width + bx * 4) * pixelSize;
-
-                    if (m_format == Format::DXT1) {
-                        DecompressDXT1Block(block, output, mip.width * pixelSize);
-                    } else {
-                        DecompressDXT5Block(block, output, mip.width * pixelSize);
-                    }
-                }
+            // Whole block rows are decoded straight into the new mip
+            switch (m_format) {
+                case Format::DXT1: DSDXTDecoder::DecodeDXT1(mip.Bytes(), mip.width, mip.height, storage.GetLevel(i)); break;
+                case Format::DXT5: DSDXTDecoder::DecodeDXT5(mip.Bytes(), mip.width, mip.height, storage.GetLevel(i)); break;
+                case Format::BC4: DSDXTDecoder::DecodeBC4(mip.Bytes(), mip.width, mip.height, storage.GetLevel(i)); break;
+                case Format::BC5: DSDXTDecoder::DecodeBC5(mip.Bytes(), mip.width, mip.height, storage.GetLevel(i)); break;
+                default: return false;
             }
-
-            decompressedMips.push_back(std::move(newMip));
         }
 
-        m_mipmaps = std::move(decompressedMips);
+        SetStorage(std::move(storage));
+        m_mappedFile.reset();
         return true;
     }
 
-    void DSTexture::DecompressDXT1Block(const uint8_t* block, uint8_t* output, uint32_t outputStride) {
-        // Extract color endpoints (stored as R5G6B5)
-        uint16_t color0 = block[0] | (block[1] << 8);
-        uint16_t color1 = block[2] | (block[3] << 8);
-
-        // Convert to R8G8B8
-        uint32_t colors[4];
-        colors[0] = ConvertR5G6B5ToR8G8B8(color0);
-        colors[1] = ConvertR5G6B5ToR8G8B8(color1);
-
-        // Calculate intermediate colors
-        if (color0 > color1) {
-            colors[2] = ((2 * colors[0]) + colors[1]) / 3;
-            colors[3] = ((2 * colors[1]) + colors[0]) / 3;
-        } else {
-            colors[2] = (colors[0] + colors[1]) / 2;
-            colors[3] = 0; // Transparent black
-        }
-
-        // Decode 4x4 block
-        for (int y = 0; y < 4; y++) {
-            uint8_t rowBits = block[4 + y];
-            for (int x = 0; x < 4; x++) {
-                uint8_t idx = (rowBits >> (2 * x)) & 0x03;
-                uint8_t* pixel = output + y * outputStride + x * 3;
-
-                pixel[0] = (colors[idx] >> 16) & 0xFF; // R
-                pixel[1] = (colors[idx] >> 8) & 0xFF;  // G
-                pixel[2] = colors[idx] & 0xFF;         // B
-            }
-        }
-    }
-
-    void DSTexture::DecompressDXT5Block(const uint8_t* block, uint8_t* output, uint32_t outputStride) {
-        // Decompress alpha channel (first 8 bytes)
-        uint8_t alpha0 = block[0];
-        uint8_t alpha1 = block[1];
-        const uint8_t* alphaBits = block + 2;
-        uint8_t alphaValues[8];
-
-        alphaValues[0] = alpha0;
-        alphaValues[1] = alpha1;
-
-        if (alpha0 > alpha1) {
-            alphaValues[2] = (6 * alpha0 + 1 * alpha1) / 7;
-            alphaValues[3] = (5 * alpha0 + 2 * alpha1) / 7;
-            alphaValues[4] = (4 * alpha0 + 3 * alpha1) / 7;
-            alphaValues[5] = (3 * alpha0 + 4 * alpha1) / 7;
-            alphaValues[6] = (2 * alpha0 + 5 * alpha1) / 7;
-            alphaValues[7] = (1 * alpha0 + 6 * alpha1) / 7;
-        } else {
-            alphaValues[2] = (4 * alpha0 + 1 * alpha1) / 5;
-            alphaValues[3] = (3 * alpha0 + 2 * alpha1) / 5;
-            alphaValues[4] = (2 * alpha0 + 3 * alpha1) / 5;
-            alphaValues[5] = (1 * alpha0 + 4 * alpha1) / 5;
-            alphaValues[6] = 0x00;
-            alphaValues[7] = 0xFF;
-        }
-
-        // Decompress color channel (last 8 bytes, same as DXT1)
-        uint8_t colorBlock[8];
-        memcpy(colorBlock, block + 8, 8);
-
-        // Temporary storage for color
-        uint8_t tempColor[4*4*3];
-        DecompressDXT1Block(colorBlock, tempColor, 12);
-
-        // Combine alpha and color channels
-        for (int y = 0; y < 4; y++) {
-            // Get alpha bits for this row
-            uint32_t alphaRow;
-            if (y < 2) {
-                alphaRow = alphaBits[0] | (alphaBits[1] << 8) | (alphaBits[2] << 16);
-                if (y == 1) alphaBits += 3;
-            } else {
-                alphaRow = alphaBits[0] | (alphaBits[1] << 8) | (alphaBits[2] << 16);
-                alphaBits += 3;
-            }
-
-            for (int x = 0; x < 4; x++) {
-                uint8_t alphaIdx = (alphaRow >> (3 * x)) & 0x07;
-                uint8_t alpha = alphaValues[alphaIdx];
-
-                uint8_t* srcPixel = tempColor + (y * 4 + x) * 3;
-                uint8_t* dstPixel = output + y * outputStride + x * 4;
-
-                dstPixel[0] = srcPixel[0]; // R
-                dstPixel[1] = srcPixel[1]; // G
-                dstPixel[2] = srcPixel[2]; // B
-                dstPixel[3] = alpha;       // A
-            }
+    void DSTexture::DecodeBlockRow(Format format, const uint8_t* blocks, uint32_t width, uint32_t rows,
+                                   uint8_t* dest, size_t destStride) {
+        switch (format) {
+            case Format::DXT1: DSDXTDecoder::DecodeDXT1Row(blocks, width, rows, dest, destStride); break;
+            case Format::DXT5: DSDXTDecoder::DecodeDXT5Row(blocks, width, rows, dest, destStride); break;
+            case Format::BC4: DSDXTDecoder::DecodeBC4Row(blocks, width, rows, dest, destStride); break;
+            case Format::BC5: DSDXTDecoder::DecodeBC5Row(blocks, width, rows, dest, destStride); break;
+            default: break;
         }
     }
 
-    uint32_t DSTexture::ConvertR5G6B5ToR8G8B8(uint16_t color) {
-        uint8_t r = (color >> 11) & 0x1F;
-        uint8_t g = (color >> 5) & 0x3F;
-        uint8_t b = color & 0x1F;
-
-        // Scale up to 8 bits
-        r = (r << 3) | (r >> 2);
-        g = (g << 2) | (g >> 4);
-        b = (b << 3) | (b >> 2);
-
-        return (r << 16) | (g << 8) | b;
-    }
-
     // =============================================
     // Mipmap Operations
     // =============================================
 
     bool DSTexture::GenerateMipmaps(CompressionQuality quality) {
-        if (m_mipmaps.empty()) return false;
+        return GenerateMipmaps(DSMipGenerator::Settings(), quality);
+    }
+
+    bool DSTexture::GenerateMipmaps(const DSMipGenerator::Settings& settings, CompressionQuality quality) {
+        if (m_mipmaps.empty() || !EndStreaming()) return false;
 
         // If compressed, we need to decompress first
         bool wasCompressed = IsCompressed();
@@ -633,33 +1213,34 @@ namespace DSEngine {
             return false;
         }
 
-        // Clear existing mipmaps (except base level)
-        if (m_mipmaps.size() > 1) {
-            m_mipmaps.erase(m_mipmaps.begin() + 1, m_mipmaps.end());
-        }
-
-        const MipLevel& base = m_mipmaps[0];
-        uint32_t width = base.width;
-        uint32_t height = base.height;
-
-        while (width > 1 || height > 1) {
-            width = std::max(1u, width / 2);
-            height = std::max(1u, height / 2);
-
+        // Lay out the full chain, the base is copied over and every other level filtered straight into it
+        std::vector<MipLevel> mips(1, m_mipmaps[0]);
+        while (mips.back().width > 1 || mips.back().height > 1) {
             MipLevel newLevel;
-            newLevel.width = width;
-            newLevel.height = height;
-            newLevel.data.resize(width * height * GetPixelSize(m_format));
+            newLevel.width = std::max(1u, mips.back().width / 2);
+            newLevel.height = std::max(1u, mips.back().height / 2);
+            mips.push_back(newLevel);
+        }
 
-            const MipLevel& prevLevel = m_mipmaps.back();
-            stbir_resize_uint8(
-                prevLevel.data.data(), prevLevel.width, prevLevel.height, 0,
-                newLevel.data.data(), width, height, 0,
-                GetChannelCount(m_format)
-            );
+        DSMipChain storage;
+        storage.Allocate(GetMipSizes(mips, m_format));
 
-            m_mipmaps.push_back(std::move(newLevel));
+        std::vector<uint8_t*> levels;
+        for (uint32_t i = 1; i < mips.size(); ++i) {
+            levels.push_back(storage.GetLevel(i));
+        }
+        DSMipGenerator::Layout layout;
+        if (!GetMipLayout(m_format, layout) ||
+            !DSMipGenerator::Generate(m_mipmaps[0].Bytes(), mips[0].width, mips[0].height, layout, settings, levels.data())) {
+            return false;
         }
+        std::memcpy(storage.GetLevel(0), m_mipmaps[0].Bytes(), storage.GetLevelSize(0));
+
+        m_mipmaps = std::move(mips);
+        SetStorage(std::move(storage));
+        m_mappedFile.reset();
+        m_mipSettings = settings;
+        m_dirtyRegions.clear();
 
         // Recompress if we were compressed before
         if (wasCompressed) {
@@ -670,23 +1251,247 @@ namespace DSEngine {
     }
 
     bool DSTexture::SetMipLevel(uint32_t level, const void* data, size_t size) {
-        if (!ValidateMipLevel(level) || !data) return false;
+        if (!ValidateMipLevel(level) || !data || !EndStreaming()) return false;
+        DetachMapping();
 
         MipLevel& mip = m_mipmaps[level];
-        if (size != mip.width * mip.height * GetPixelSize(m_format)) {
+        if (size != mip.Size()) {
             return false;
         }
 
-        std::memcpy(mip.data.data(), data, size);
+        std::memcpy(mip.data, data, size);
         return true;
     }
 
     bool DSTexture::RemoveMipmaps() {
-        if (m_mipmaps.size() <= 1) return false;
+        if (m_mipmaps.size() <= 1 || !EndStreaming()) return false;
         m_mipmaps.resize(1);
+
+        // Move the base to a chain of its own so the memory of the dropped levels is released
+        const MipLevel& base = m_mipmaps[0];
+        DSMipChain storage;
+        storage.Allocate({ base.data ? base.Size() : 0 });
+        if (base.data) {
+            std::memcpy(storage.GetLevel(0), base.data, base.Size());
+        }
+        SetStorage(std::move(storage));
+        return true;
+    }
+
+    // =============================================
+    // Region Updates
+    // =============================================
+
+    bool DSTexture::UpdateRegion(const Region& region, const void* pixels, size_t rowPitch, CompressionQuality quality) {
+        if (m_mipmaps.empty() || !pixels || region.width == 0 || region.height == 0) return false;
+
+        const MipLevel& base = m_mipmaps[0];
+        if (region.x >= base.width || region.width > base.width - region.x ||
+            region.y >= base.height || region.height > base.height - region.y) {
+            return false;
+        }
+        if (!EndStreaming()) return false;
+        DetachMapping();
+
+        const size_t pixelSize = GetPixelSize(m_format);
+        const size_t rowSize = region.width * pixelSize;
+        if (rowPitch == 0) rowPitch = rowSize;
+        const uint8_t* source = static_cast<const uint8_t*>(pixels);
+
+        if (!IsCompressed()) {
+            for (uint32_t y = 0; y < region.height; ++y) {
+                std::memcpy(base.data + ((region.y + y) * static_cast<size_t>(base.width) + region.x) * pixelSize,
+                            source + y * rowPitch, rowSize);
+            }
+        } else {
+            // Decode the touched blocks, overwrite the region in them and encode them again
+            const Region blocks = ExpandToBlocks(region, base.width, base.height);
+            DSBufferPool::Buffer blockPixels(static_cast<size_t>(blocks.width) * blocks.height * pixelSize);
+            ReadRegion(0, blocks, blockPixels.Data());
+
+            for (uint32_t y = 0; y < region.height; ++y) {
+                const size_t offset = ((region.y - blocks.y + y) * static_cast<size_t>(blocks.width) + region.x - blocks.x) * pixelSize;
+                std::memcpy(blockPixels.Data() + offset, source + y * rowPitch, rowSize);
+            }
+            WriteRegion(0, blocks, blockPixels.Data(), quality);
+        }
+
+        AddDirtyRegion(region);
+        return true;
+    }
+
+    bool DSTexture::FlushDirtyRegions(CompressionQuality quality) {
+        if (m_dirtyRegions.empty()) return true;
+        if (!EndStreaming()) return false;
+        DetachMapping();
+
+        DSMipGenerator::Layout layout;
+        if (!GetMipLayout(GetDecompressedFormat(m_format), layout)) return false;
+        const size_t pixelSize = GetPixelSize(m_format);
+        DSBufferPool::Buffer sourcePixels, destPixels;
+
+        for (const Region& dirty : m_dirtyRegions) {
+            Region changed = dirty;
+            for (uint32_t level = 1; level < m_mipmaps.size() && changed.width > 0; ++level) {
+                const MipLevel& parent = m_mipmaps[level - 1];
+                const MipLevel& mip = m_mipmaps[level];
+
+                // Compressed levels are refreshed in whole blocks
+                Region dest = DSMipGenerator::GetAffectedRegion(parent.width, parent.height, changed, m_mipSettings);
+                if (IsCompressed()) {
+                    dest = ExpandToBlocks(dest, mip.width, mip.height);
+                }
+                const Region source = DSMipGenerator::GetSourceRegion(parent.width, parent.height, dest, m_mipSettings);
+
+                sourcePixels.Resize(static_cast<size_t>(source.width) * source.height * pixelSize);
+                destPixels.Resize(static_cast<size_t>(dest.width) * dest.height * pixelSize);
+                ReadRegion(level - 1, source, sourcePixels.Data());
+                if (!DSMipGenerator::GenerateRegion(sourcePixels.Data(), parent.width, parent.height, layout,
+                                                    m_mipSettings, dest, destPixels.Data())) {
+                    return false;
+                }
+                WriteRegion(level, dest, destPixels.Data(), quality);
+                changed = dest;
+            }
+        }
+
+        m_dirtyRegions.clear();
         return true;
     }
 
+    bool DSTexture::GetMipLayout(Format format, DSMipGenerator::Layout& layout) {
+        switch (format) {
+            case Format::R8: layout = DSMipGenerator::Layout::R8; return true;
+            case Format::RG8: layout = DSMipGenerator::Layout::RG8; return true;
+            case Format::RGB8: layout = DSMipGenerator::Layout::RGB8; return true;
+            case Format::RGBA8: layout = DSMipGenerator::Layout::RGBA8; return true;
+            case Format::RGBA16F: layout = DSMipGenerator::Layout::RGBA16F; return true;
+            case Format::R11G11B10F: layout = DSMipGenerator::Layout::R11G11B10F; return true;
+            default: return false;
+        }
+    }
+
+    DSTexture::Region DSTexture::ExpandToBlocks(const Region& region, uint32_t width, uint32_t height) {
+        Region blocks;
+        blocks.x = region.x & ~3u;
+        blocks.y = region.y & ~3u;
+        blocks.width = std::min((region.x + region.width + 3) & ~3u, width) - blocks.x;
+        blocks.height = std::min((region.y + region.height + 3) & ~3u, height) - blocks.y;
+        return blocks;
+    }
+
+    void DSTexture::AddDirtyRegion(const Region& region) {
+        // Overlapping or touching regions are merged into their bounding rectangle
+        Region merged = region;
+        for (size_t i = 0; i < m_dirtyRegions.size();) {
+            const Region& other = m_dirtyRegions[i];
+            if (merged.x > other.x + other.width || other.x > merged.x + merged.width ||
+                merged.y > other.y + other.height || other.y > merged.y + merged.height) {
+                ++i;
+                continue;
+            }
+
+            const uint32_t right = std::max(merged.x + merged.width, other.x + other.width);
+            const uint32_t bottom = std::max(merged.y + merged.height, other.y + other.height);
+            merged.x = std::min(merged.x, other.x);
+            merged.y = std::min(merged.y, other.y);
+            merged.width = right - merged.x;
+            merged.height = bottom - merged.y;
+
+            // The grown region may now touch ones already checked
+            m_dirtyRegions.erase(m_dirtyRegions.begin() + i);
+            i = 0;
+        }
+        m_dirtyRegions.push_back(merged);
+    }
+
+    void DSTexture::ReadRegion(uint32_t level, const Region& region, uint8_t* dest) const {
+        const MipLevel& mip = m_mipmaps[level];
+        const size_t pixelSize = GetPixelSize(m_format);
+        const size_t rowSize = region.width * pixelSize;
+
+        if (!IsCompressed()) {
+            for (uint32_t y = 0; y < region.height; ++y) {
+                std::memcpy(dest + y * rowSize,
+                            mip.Bytes() + ((region.y + y) * static_cast<size_t>(mip.width) + region.x) * pixelSize, rowSize);
+            }
+            return;
+        }
+
+        // Decode the block rows covering the region into a 4 row scratch, then copy the region part out
+        const Region blocks = ExpandToBlocks(region, mip.width, mip.height);
+        const size_t blockSize = GetBlockSize(m_format);
+        const uint32_t blocksWide = (mip.width + 3) / 4;
+        const size_t scratchPitch = blocks.width * pixelSize;
+        DSBufferPool::Buffer scratch(scratchPitch * 4);
+        uint8_t* rows = scratch.Data();
+
+        for (uint32_t blockY = blocks.y; blockY < blocks.y + blocks.height; blockY += 4) {
+            const uint8_t* blockRow = mip.Bytes() + ((blockY / 4) * static_cast<size_t>(blocksWide) + blocks.x / 4) * blockSize;
+            const uint32_t rowCount = std::min(4u, mip.height - blockY);
+            DecodeBlockRow(m_format, blockRow, blocks.width, rowCount, rows, scratchPitch);
+
+            const uint32_t firstY = std::max(blockY, region.y);
+            const uint32_t lastY = std::min(blockY + rowCount, region.y + region.height);
+            for (uint32_t y = firstY; y < lastY; ++y) {
+                std::memcpy(dest + (y - region.y) * rowSize,
+                            rows + (y - blockY) * scratchPitch + (region.x - blocks.x) * pixelSize, rowSize);
+            }
+        }
+    }
+
+    void DSTexture::WriteRegion(uint32_t level, const Region& region, const uint8_t* pixels, CompressionQuality quality) {
+        const MipLevel& mip = m_mipmaps[level];
+        const size_t pixelSize = GetPixelSize(m_format);
+        const size_t rowSize = region.width * pixelSize;
+
+        if (!IsCompressed()) {
+            for (uint32_t y = 0; y < region.height; ++y) {
+                std::memcpy(mip.data + ((region.y + y) * static_cast<size_t>(mip.width) + region.x) * pixelSize,
+                            pixels + y * rowSize, rowSize);
+            }
+            return;
+        }
+
+        const size_t blockSize = GetBlockSize(m_format);
+        const uint32_t blocksWide = (mip.width + 3) / 4;
+
+        const bool dxt = (m_format == Format::DXT1 || m_format == Format::DXT5);
+
+        for (uint32_t blockY = region.y; blockY < region.y + region.height; blockY += 4) {
+            for (uint32_t blockX = region.x; blockX < region.x + region.width; blockX += 4) {
+                // Gather the block as RGBA for DXT, as is for BC4/BC5, clamped to the region like Compress clamps to the texture
+                uint8_t blockPixels[4*4*4];
+                for (uint32_t y = 0; y < 4; y++) {
+                    for (uint32_t x = 0; x < 4; x++) {
+                        const uint32_t sx = std::min(blockX + x, region.x + region.width - 1) - region.x;
+                        const uint32_t sy = std::min(blockY + y, region.y + region.height - 1) - region.y;
+                        const uint8_t* src = pixels + sy * rowSize + sx * pixelSize;
+
+                        if (!dxt) {
+                            std::memcpy(blockPixels + (y * 4 + x) * pixelSize, src, pixelSize);
+                            continue;
+                        }
+
+                        uint8_t* dst = blockPixels + (y * 4 + x) * 4;
+                        dst[0] = src[0];
+                        dst[1] = src[1];
+                        dst[2] = src[2];
+                        dst[3] = (pixelSize == 4) ? src[3] : 255;
+                    }
+                }
+
+                uint8_t* output = mip.data + ((blockY / 4) * static_cast<size_t>(blocksWide) + blockX / 4) * blockSize;
+                if (dxt) {
+                    DSDXTEncoder::EncodeBlock(blockPixels, output, m_format == Format::DXT5, quality == CompressionQuality::NORMAL);
+                } else {
+                    DSDXTEncoder::EncodeChannelBlock(blockPixels, static_cast<uint32_t>(pixelSize), output,
+                                                     quality == CompressionQuality::NORMAL);
+                }
+            }
+        }
+    }
+
     // =============================================
     // Accessors and Utility Methods
     // =============================================
@@ -700,11 +1505,11 @@ namespace DSEngine {
     }
 
     const uint8_t* DSTexture::GetPixels(uint32_t mipLevel) const {
-        return ValidateMipLevel(mipLevel) ? m_mipmaps[mipLevel].data.data() : nullptr;
+        return IsMipResident(mipLevel) ? m_mipmaps[mipLevel].Bytes() : nullptr;
     }
 
     size_t DSTexture::GetPixelDataSize(uint32_t mipLevel) const {
-        return ValidateMipLevel(mipLevel) ? m_mipmaps[mipLevel].data.size() : 0;
+        return ValidateMipLevel(mipLevel) ? m_mipmaps[mipLevel].Size() : 0;
     }
 
     // Static format helpers
@@ -714,6 +1519,12 @@ namespace DSEngine {
             case Format::RGBA8: return 4;
             case Format::DXT1: return 3; // Decompresses to RGB
             case Format::DXT5: return 4; // Decompresses to RGBA
+            case Format::R8: return 1;
+            case Format::RG8: return 2;
+            case Format::BC4: return 1;  // Decompresses to R
+            case Format::BC5: return 2;  // Decompresses to RG
+            case Format::RGBA16F: return 4;
+            case Format::R11G11B10F: return 3;
             default: return 0;
         }
     }
@@ -724,6 +1535,12 @@ namespace DSEngine {
             case Format::RGBA8: return 4;
             case Format::DXT1: return 3; // Decompressed size
             case Format::DXT5: return 4; // Decompressed size
+            case Format::R8: return 1;
+            case Format::RG8: return 2;
+            case Format::BC4: return 1;  // Decompressed size
+            case Format::BC5: return 2;  // Decompressed size
+            case Format::RGBA16F: return 8;
+            case Format::R11G11B10F: return 4;
             default: return 0;
         }
     }
@@ -732,12 +1549,83 @@ namespace DSEngine {
         switch (format) {
             case Format::DXT1: return 8;  // 8 bytes per 4x4 block
             case Format::DXT5: return 16; // 16 bytes per 4x4 block
+            case Format::BC4: return 8;   // 8 bytes per 4x4 block
+            case Format::BC5: return 16;  // 16 bytes per 4x4 block
             default: return GetPixelSize(format); // Uncompressed
         }
     }
 
     bool DSTexture::IsFormatCompressed(Format format) {
-        return format == Format::DXT1 || format == Format::DXT5;
+        return format == Format::DXT1 || format == Format::DXT5 || format == Format::BC4 || format == Format::BC5;
+    }
+
+    void DSTexture::ConvertToRGBA32F(Format format, const uint8_t* src, float* dest, size_t count) {
+        switch (format) {
+            case Format::RGBA16F:
+                DSFloatConverter::HalfToFloat(reinterpret_cast<const uint16_t*>(src), dest, count * 4);
+                return;
+            case Format::R11G11B10F:
+                DSFloatConverter::R11G11B10FToRGBA32F(reinterpret_cast<const uint32_t*>(src), dest, count);
+                return;
+            default:
+                break;
+        }
+
+        const uint32_t channels = GetChannelCount(format);
+        if (channels >= 3) {
+            // RGB8 gets an opaque alpha byte, 255 / 255 is exactly 1
+            const __m128 scale = _mm_set1_ps(255.0f);
+            for (size_t i = 0; i < count; i++, src += channels, dest += 4) {
+                uint32_t pixel = 0xFF000000u;
+                std::memcpy(&pixel, src, channels);
+                const __m128i bytes = _mm_unpacklo_epi8(_mm_cvtsi32_si128(static_cast<int>(pixel)), _mm_setzero_si128());
+                const __m128i values = _mm_unpacklo_epi16(bytes, _mm_setzero_si128());
+                _mm_storeu_ps(dest, _mm_div_ps(_mm_cvtepi32_ps(values), scale));
+            }
+            return;
+        }
+        for (size_t i = 0; i < count; i++, src += channels, dest += 4) {
+            dest[0] = src[0] / 255.0f;
+            dest[1] = (channels == 2) ? src[1] / 255.0f : dest[0];
+            dest[2] = (channels == 2) ? 0.0f : dest[0];
+            dest[3] = 1.0f;
+        }
+    }
+
+    void DSTexture::ConvertFromRGBA32F(Format format, const float* src, uint8_t* dest, size_t count) {
+        switch (format) {
+            case Format::RGBA16F:
+                DSFloatConverter::FloatToHalf(src, reinterpret_cast<uint16_t*>(dest), count * 4);
+                return;
+            case Format::R11G11B10F:
+                DSFloatConverter::RGBA32FToR11G11B10F(src, reinterpret_cast<uint32_t*>(dest), count);
+                return;
+            default:
+                break;
+        }
+
+        const uint32_t channels = GetChannelCount(format);
+        for (size_t i = 0; i < count; i++, src += 4, dest += channels) {
+            for (uint32_t c = 0; c < channels; c++) {
+                // Written so NaN ends up as 0
+                const float value = src[c] > 0.0f ? std::min(src[c], 1.0f) : 0.0f;
+                dest[c] = static_cast<uint8_t>(value * 255.0f + 0.5f);
+            }
+        }
+    }
+
+    bool DSTexture::IsFormatFloat(Format format) {
+        return format == Format::RGBA16F || format == Format::R11G11B10F;
+    }
+
+    DSTexture::Format DSTexture::GetDecompressedFormat(Format format) {
+        switch (format) {
+            case Format::DXT1: return Format::RGB8;
+            case Format::DXT5: return Format::RGBA8;
+            case Format::BC4: return Format::R8;
+            case Format::BC5: return Format::RG8;
+            default: return format;
+        }
     }
 
     uint32_t DSTexture::CalculateMipSize(uint32_t width, uint32_t height, Format format) {
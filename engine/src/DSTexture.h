@@ -4,12 +4,16 @@
 #include <cstdint>
 #include <memory>
 #include <algorithm>
+#include <istream>
+#include "DSMappedFile.h"
+#include "DSMipGenerator.h"
+#include "DSMipChain.h"
 
-// stb_dxt configuration
-#define STB_DXT_IMPLEMENTATION
-#define STB_DXT_STATIC
-#include "../third_party/stb/stb_dxt.h"
 namespace DSEngine {
+    class DSTextureStreamer;
+    class DSTextureLoadHandle;
+    class DSTexturePack;
+
     class DSTexture {
     public:
         // Texture formats
@@ -18,44 +22,138 @@ namespace DSEngine {
             RGB8,    // 24-bit uncompressed
             RGBA8,   // 32-bit uncompressed
             DXT1,    // BC1 compressed (RGB with 1-bit alpha)
-            DXT5     // BC3 compressed (RGBA with full alpha)
+            DXT5,    // BC3 compressed (RGBA with full alpha)
+            R8,      // 8-bit single channel (roughness, AO, height)
+            RG8,     // 16-bit two channel (normal map XY)
+            BC4,     // Single channel compressed, decompresses to R8
+            BC5,     // Two channel compressed, decompresses to RG8
+            RGBA16F, // 64-bit half float HDR
+            R11G11B10F // 32-bit packed unsigned float HDR, no alpha (half the size of RGBA16F)
         };
 
         // Compression quality levels
         enum class CompressionQuality {
             FAST,    // stb_dxt fast compression
-            NORMAL   // stb_dxt high quality compression
+            NORMAL   // stb_dxt high quality compression (solid and repeated blocks are fast either way)
         };
 
         // Construction/destruction
         DSTexture();
         ~DSTexture();
 
+        DSTexture(const DSTexture&) = delete;
+        DSTexture& operator=(const DSTexture&) = delete;
+
         // Creation methods
         static std::unique_ptr<DSTexture> CreateFromFile(const std::string& path, bool flipVertically = true);
         static std::unique_ptr<DSTexture> CreateEmpty(uint32_t width, uint32_t height, Format format);
         static std::unique_ptr<DSTexture> CreateFromMemory(const uint8_t* data, uint32_t width, uint32_t height, Format format);
 
         // Compression methods
-        bool Compress(Format targetFormat, CompressionQuality quality = CompressionQuality::NORMAL);
+        // DXT1/DXT5 encode RGBA8, BC4 encodes R8 and BC5 RG8, other formats are converted first
+        // (BC4 keeps red, BC5 red and green).
+        // maxThreads: 1 compresses on the calling thread, 0 uses the whole engine thread pool,
+        // any other value caps the number of threads (caller included). Output is identical in all modes.
+        bool Compress(Format targetFormat, CompressionQuality quality = CompressionQuality::NORMAL, uint32_t maxThreads = 1);
         bool Decompress();
         bool IsCompressed() const;
 
+        // Format conversion, compressed targets go through Compress with NORMAL quality.
+        // HDR formats keep values above 1 between themselves, 8-bit channels map to [0, 1] and back with clamping.
+        bool ConvertFormat(Format newFormat);
+
+        // DST file payload compression
+        enum class FileCompression {
+            NONE,    // Version 2 layout, raw mips
+            LZ       // Version 3 layout, mips are LZ compressed when it saves space
+        };
+
         // Save/Load operations
-        bool SaveToFile(const std::string& path) const;
+        bool SaveToFile(const std::string& path, FileCompression compression = FileCompression::NONE) const;
         bool LoadFromFile(const std::string& path);
+        // Maps a DST file instead of reading it, GetPixels returns pointers into the mapping.
+        // Mips are copied to the heap only when the texture is modified.
+        bool LoadFromFileMapped(const std::string& path);
+        // Loads a DST file or an image stb_image can decode from memory, the data is copied
+        bool LoadFromMemory(const uint8_t* data, size_t size);
+        // Loads a texture from an open pack, the data is copied
+        bool LoadFromPack(const DSTexturePack& pack, const std::string& name);
+        // Like LoadFromFileMapped, raw mips point into the pack mapping, which stays alive while the texture uses it
+        bool LoadFromPackMapped(const DSTexturePack& pack, const std::string& name);
+        bool IsMapped() const { return m_mappedFile != nullptr; }
+
+        // GPU upload layout
+        // Mips placed for buffer to image copies: every mip offset and row pitch (rows of 4x4 blocks for DXT) is
+        // rounded up to the requested alignment and to a multiple of the texel or block size, as Vulkan requires.
+        struct UploadAlignment {
+            uint32_t offset = 1;    // e.g. optimalBufferCopyOffsetAlignment
+            uint32_t rowPitch = 1;  // e.g. optimalBufferCopyRowPitchAlignment
+        };
+        struct UploadMip {
+            size_t offset = 0;      // From the start of the upload data
+            size_t rowPitch = 0;    // Bytes from one row to the next
+            size_t rowSize = 0;     // Bytes of pixel data in a row
+            uint32_t rowCount = 0;
+        };
+        struct UploadLayout {
+            std::vector<UploadMip> mips;
+            size_t size = 0;        // Staging bytes for the whole chain
+        };
+        UploadLayout GetUploadLayout(const UploadAlignment& alignment) const;
+        // Fills dest (GetUploadLayout(alignment).size bytes) with every mip. A single memcpy when the texture was
+        // mapped from a DST saved with the same alignment, one copy per row otherwise. false if a mip is not resident.
+        bool CopyUploadData(const UploadAlignment& alignment, uint8_t* dest) const;
+        // The mapped payload of a DST saved with the same alignment, usable as staging data as is. nullptr otherwise.
+        const uint8_t* GetMappedUploadData(const UploadAlignment& alignment) const;
+        // Version 4 layout: raw mips written in the upload layout of the alignment, the payload starts on an aligned
+        // file offset. Pair with LoadFromFileMapped or LoadFromPackMapped to upload without repacking.
+        bool SaveToFile(const std::string& path, const UploadAlignment& alignment) const;
+
+        // Asynchronous loading (see DSTextureLoader.h)
+        // The file is read on the loader's I/O thread and decoded on the engine thread pool,
+        // the optional mip generation and compression run there too.
+        struct AsyncLoadOptions {
+            bool generateMipmaps = false;
+            Format compressFormat = Format::UNKNOWN;  // DXT1/DXT5/BC4/BC5 to compress after loading
+            CompressionQuality quality = CompressionQuality::NORMAL;
+        };
+        static DSTextureLoadHandle LoadAsync(const std::string& path);
+        static DSTextureLoadHandle LoadAsync(const std::string& path, const AsyncLoadOptions& options);
+
+        // Streaming operations
+        // Loads only the smallest mips (at least one, up to tailBytes). RequestMip loads more detail in the
+        // background and DSTextureStreamer evicts the top mips of unused textures when over its budget.
+        // Modifying a streamed texture loads every missing mip and ends streaming.
+        bool LoadFromFileStreamed(const std::string& path, size_t tailBytes = 64 * 1024);
+        bool IsStreamed() const { return m_streaming != nullptr; }
+        bool IsMipResident(uint32_t mipLevel) const;
+        uint32_t GetResidentMip() const;
+        void RequestMip(uint32_t mipLevel);
 
         // Mipmap operations
         bool GenerateMipmaps(CompressionQuality quality = CompressionQuality::NORMAL);
+        bool GenerateMipmaps(const DSMipGenerator::Settings& settings, CompressionQuality quality = CompressionQuality::NORMAL);
         bool SetMipLevel(uint32_t level, const void* data, size_t size);
         bool RemoveMipmaps();
 
+        // Region updates
+        // Writes a rectangle of the base level and marks it dirty. Pixels use the decompressed layout of the format
+        // (RGB8 for DXT1, R8 for BC4...), rowPitch 0 means tightly packed. Compressed textures re-encode only the touched 4x4 blocks.
+        using Region = DSMipGenerator::Region;
+        bool UpdateRegion(const Region& region, const void* pixels, size_t rowPitch = 0,
+                          CompressionQuality quality = CompressionQuality::NORMAL);
+        // Refreshes the parts of the lower mips that depend on the dirty regions, with the filter of the last
+        // GenerateMipmaps, then clears them. Compressed mips re-encode only the blocks in those parts.
+        bool FlushDirtyRegions(CompressionQuality quality = CompressionQuality::NORMAL);
+        // Base level rectangles changed since the last flush, read them before flushing to upload only what changed
+        const std::vector<Region>& GetDirtyRegions() const { return m_dirtyRegions; }
+
         // Accessors
         uint32_t GetWidth(uint32_t mipLevel = 0) const;
         uint32_t GetHeight(uint32_t mipLevel = 0) const;
         Format GetFormat() const { return m_format; }
         uint32_t GetMipLevels() const { return static_cast<uint32_t>(m_mipmaps.size()); }
-        const uint8_t* GetPixels(uint32_t mipLevel = 0) const;
+        const uint8_t* GetPixels(uint32_t mipLevel = 0) const; // nullptr if the mip is not resident
         size_t GetPixelDataSize(uint32_t mipLevel = 0) const;
 
         // Format helpers
@@ -63,16 +161,36 @@ namespace DSEngine {
         static size_t GetPixelSize(Format format);
         static size_t GetBlockSize(Format format);
         static bool IsFormatCompressed(Format format);
+        static bool IsFormatFloat(Format format);
+        static Format GetDecompressedFormat(Format format);  // The format itself when not compressed
         static uint32_t CalculateMipSize(uint32_t width, uint32_t height, Format format);
+        // Pixels of an uncompressed format to RGBA32F and back. 8-bit channels map to [0, 1] (clamped on the way back),
+        // a single channel is replicated like gray, missing color channels are 0 and missing alpha is 1.
+        static void ConvertToRGBA32F(Format format, const uint8_t* src, float* dest, size_t count);
+        static void ConvertFromRGBA32F(Format format, const float* src, uint8_t* dest, size_t count);
 
     private:
         struct MipLevel {
-            uint32_t width;
-            uint32_t height;
-            std::vector<uint8_t> data;
+            uint32_t width = 0;
+            uint32_t height = 0;
+            uint8_t* data = nullptr;          // Points into m_storage, nullptr if mapped or not resident
+            const uint8_t* mapped = nullptr;  // Points into m_mappedFile when loaded mapped
+            size_t size = 0;                  // 0 if not resident
+
+            const uint8_t* Bytes() const { return mapped ? mapped : data; }
+            size_t Size() const { return size; }
         };
 
         // DST file format structures
+        static const uint16_t DST_VERSION_RAW = 2;
+        static const uint16_t DST_VERSION_LZ = 3;   // Version 3 adds per mip payload compression
+        static const uint16_t DST_VERSION_UPLOAD = 4;  // Version 4 adds row pitches, raw mips stored in an upload layout
+
+        enum DSTMipCompression : uint32_t {
+            DST_MIP_RAW = 0,
+            DST_MIP_LZ = 1
+        };
+
 #pragma pack(push, 1)
         struct DSTHeader {
             char magic[4] = {'D', 'S', 'T', '\0'};
@@ -90,26 +208,99 @@ namespace DSEngine {
             uint32_t dataSize;
             uint32_t dataOffset;
         };
+
+        struct DSTMipInfoV3 {
+            uint32_t width;
+            uint32_t height;
+            uint32_t dataSize;     // Decompressed size
+            uint32_t dataOffset;
+            uint32_t storedSize;   // Size in the file
+            uint32_t compression;  // DSTMipCompression
+        };
+
+        // Version 4 mip info, also used in memory for every version
+        struct DSTMipInfoV4 {
+            uint32_t width;
+            uint32_t height;
+            uint32_t dataSize;     // Decompressed size, rows tightly packed
+            uint32_t dataOffset;
+            uint32_t storedSize;   // Size in the file
+            uint32_t compression;  // DSTMipCompression
+            uint32_t rowPitch;     // Bytes between rows in the file (block rows for DXT), 0 when tightly packed
+            uint32_t rowCount;
+        };
 #pragma pack(pop)
 
+        // Owned by the main thread, DSTextureStreamer only reads it there
+        struct StreamingState {
+            std::string path;
+            std::vector<DSTMipInfoV4> mipInfos;
+            uint32_t residentMip = 0;  // Most detailed mip in memory
+            uint32_t tailMip = 0;      // Mips from here on are never evicted
+            uint64_t id = 0;           // Registration id in DSTextureStreamer
+            uint64_t lastUse = 0;      // Streamer frame of the last RequestMip
+            size_t residentBytes = 0;  // Bytes accounted in the streamer budget
+            bool loadPending = false;
+        };
+
         // Texture data
         Format m_format;
         std::vector<MipLevel> m_mipmaps;
+        DSMipChain m_storage;  // Every mip not mapped lives in this single allocation
         uint32_t m_flags;
+        std::shared_ptr<DSMappedFile> m_mappedFile;
+        std::unique_ptr<StreamingState> m_streaming;
+        std::vector<Region> m_dirtyRegions;          // Merged so they never overlap
+        DSMipGenerator::Settings m_mipSettings;      // Used to refresh mips under dirty regions
+        const uint8_t* m_uploadData = nullptr;       // Version 4 payload in m_mappedFile, only valid while mapped
+        UploadLayout m_uploadLayout;                 // How that payload is laid out
 
         // Private methods
         bool ValidateMipLevel(uint32_t level) const;
+        static std::vector<size_t> GetMipSizes(const std::vector<MipLevel>& mips, Format format);
+        void SetStorage(DSMipChain&& storage);
+        void DetachMapping();
+        bool EndStreaming();
+        void ResetStreaming();
         bool LoadFromSTB(const std::string& path, bool flipVertically);
-        bool ConvertFormat(Format newFormat);
-        bool ConvertFromRGB8(const MipLevel& source, MipLevel& dest, Format newFormat);
-        bool ConvertFromRGBA8(const MipLevel& source, MipLevel& dest, Format newFormat);
+        bool LoadFromSTBMemory(const uint8_t* fileData, size_t fileSize, bool flipVertically);
+        bool AdoptSTBImage(unsigned char* data, int width, int height, int channels);
+        // Float images (Radiance .hdr) become RGBA16F
+        bool AdoptSTBFloatImage(float* data, int width, int height, int channels);
+        bool LoadDSTFromMemory(const uint8_t* fileData, size_t fileSize, bool mapRawMips);
+        static bool IsDSTData(const uint8_t* data, size_t size);
+        bool ConvertFromRGB8(const MipLevel& source, uint8_t* dest, Format newFormat);
+        bool ConvertFromRGBA8(const MipLevel& source, uint8_t* dest, Format newFormat);
+        bool ConvertFromR8(const MipLevel& source, uint8_t* dest, Format newFormat);
+        bool ConvertFromRG8(const MipLevel& source, uint8_t* dest, Format newFormat);
+        // Conversions from or to the float formats, through rows of RGBA32F
+        bool ConvertThroughFloat(const MipLevel& source, uint8_t* dest, Format newFormat);
+        static bool GetMipLayout(Format format, DSMipGenerator::Layout& layout);
 
-        // DXT compression/decompression
-        bool CompressDXT1(MipLevel& source, MipLevel& dest, CompressionQuality quality);
-        bool CompressDXT5(MipLevel& source, MipLevel& dest, CompressionQuality quality);
+        // DXT and BC4/BC5 decompression, compression goes through DSDXTEncoder
         bool DecompressDXT();
-        void DecompressDXT1Block(const uint8_t* block, uint8_t* output, uint32_t outputStride);
-        void DecompressDXT5Block(const uint8_t* block, uint8_t* output, uint32_t outputStride);
-        uint32_t ConvertR5G6B5ToR8G8B8(uint16_t color);
+        static void DecodeBlockRow(Format format, const uint8_t* blocks, uint32_t width, uint32_t rows,
+                                   uint8_t* dest, size_t destStride);
+
+        // Region helpers, pixels are tightly packed in the decompressed layout
+        static Region ExpandToBlocks(const Region& region, uint32_t width, uint32_t height);
+        void AddDirtyRegion(const Region& region);
+        void ReadRegion(uint32_t level, const Region& region, uint8_t* dest) const;
+        // Compressed levels need a block aligned region (clipped at the right and bottom edges)
+        void WriteRegion(uint32_t level, const Region& region, const uint8_t* pixels, CompressionQuality quality);
+
+        // DST mip table helpers
+        static size_t GetMipInfoSize(uint16_t version);
+        // Fails on an unknown format or a mip whose data size doesn't match its dimensions
+        static bool ParseMipTable(const DSTHeader& header, const uint8_t* table, std::vector<DSTMipInfoV4>& mipInfos);
+        static bool ReadMipTable(std::istream& file, const DSTHeader& header, std::vector<DSTMipInfoV4>& mipInfos);
+        // dest must hold info.dataSize bytes
+        static bool ReadMip(std::istream& file, const DSTMipInfoV4& info, uint8_t* dest);
+        static bool UnpackMip(const DSTMipInfoV4& info, const uint8_t* stored, uint8_t* dest);
+        // Raw tightly packed mips can be read or mapped straight into their level
+        static bool IsMipStoredAsIs(const DSTMipInfoV4& info);
+
+        friend class DSTextureStreamer;
+        friend class DSVirtualTexture;
     };
 }
\ No newline at end of file
@@ -0,0 +1,187 @@
+#include "DSTextureLoader.h"
+#include "DSThreadPool.h"
+#include <fstream>
+
+namespace DSEngine {
+    struct DSTextureLoadHandle::State {
+        std::string path;
+        DSTexture::AsyncLoadOptions options;
+
+        std::mutex mutex;
+        std::condition_variable done;
+        Status status = Status::Pending;
+        std::unique_ptr<DSTexture> texture;
+    };
+
+    // =====================
+    // Handle
+    // =====================
+
+    DSTextureLoadHandle::Status DSTextureLoadHandle::GetStatus() const {
+        if (!m_state) return Status::Invalid;
+
+        std::lock_guard<std::mutex> lock(m_state->mutex);
+        return m_state->status;
+    }
+
+    void DSTextureLoadHandle::Wait() const {
+        if (!m_state) return;
+
+        std::unique_lock<std::mutex> lock(m_state->mutex);
+        m_state->done.wait(lock, [this]() { return m_state->status != Status::Pending; });
+    }
+
+    std::unique_ptr<DSTexture> DSTextureLoadHandle::Take() {
+        if (!m_state) return nullptr;
+
+        std::unique_lock<std::mutex> lock(m_state->mutex);
+        m_state->done.wait(lock, [this]() { return m_state->status != Status::Pending; });
+        return std::move(m_state->texture);
+    }
+
+    // =====================
+    // Loader
+    // =====================
+
+    DSTextureLoader& DSTextureLoader::Get() {
+        static DSTextureLoader loader;
+        return loader;
+    }
+
+    DSTextureLoader::DSTextureLoader() {
+        // Created first so they outlive the loader at exit
+        DSThreadPool::Global();
+        DSBufferPool::Global();
+
+        m_ioThread = std::thread(&DSTextureLoader::IOLoop, this);
+    }
+
+    DSTextureLoader::~DSTextureLoader() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+        }
+        m_ioCondition.notify_all();
+        m_ioThread.join();
+
+        // Loads never read fail, the ones being decoded are waited for
+        std::deque<std::shared_ptr<DSTextureLoadHandle::State>> unread;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            unread.swap(m_readQueue);
+        }
+        for (const auto& state : unread) {
+            Finish(*state, nullptr);
+        }
+        WaitAll();
+    }
+
+    void DSTextureLoader::SetMaxBytesInFlight(size_t bytes) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_maxBytesInFlight = bytes;
+        }
+        m_ioCondition.notify_all();
+    }
+
+    uint32_t DSTextureLoader::GetPendingLoads() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_pendingLoads;
+    }
+
+    void DSTextureLoader::WaitAll() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_idle.wait(lock, [this]() { return m_pendingLoads == 0; });
+    }
+
+    DSTextureLoadHandle DSTextureLoader::Load(const std::string& path, const DSTexture::AsyncLoadOptions& options) {
+        auto state = std::make_shared<DSTextureLoadHandle::State>();
+        state->path = path;
+        state->options = options;
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_readQueue.push_back(state);
+            m_pendingLoads++;
+        }
+        m_ioCondition.notify_all();
+        return DSTextureLoadHandle(state);
+    }
+
+    void DSTextureLoader::IOLoop() {
+        for (;;) {
+            std::shared_ptr<DSTextureLoadHandle::State> state;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                // With nothing in flight the next file is read whatever the limit, even 0
+                m_ioCondition.wait(lock, [this]() {
+                    return m_stopping ||
+                           (!m_readQueue.empty() && (m_bytesInFlight == 0 || m_bytesInFlight < m_maxBytesInFlight));
+                });
+                if (m_stopping) return;
+
+                state = std::move(m_readQueue.front());
+                m_readQueue.pop_front();
+            }
+
+            // The whole file is read in one go, decoding starts once it is in memory
+            auto fileData = std::make_shared<DSBufferPool::Buffer>();
+            std::ifstream file(state->path, std::ios::binary | std::ios::ate);
+            if (file.is_open()) {
+                fileData->Resize(static_cast<size_t>(file.tellg()));
+                file.seekg(0);
+                file.read(reinterpret_cast<char*>(fileData->Data()), fileData->Size());
+            }
+            if (!file.is_open() || !file.good()) {
+                Finish(*state, nullptr);
+                continue;
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_bytesInFlight += fileData->Size();
+            }
+            DSThreadPool::Global().Submit([this, state, fileData]() {
+                Decode(state, *fileData);
+            });
+        }
+    }
+
+    void DSTextureLoader::Decode(const std::shared_ptr<DSTextureLoadHandle::State>& state, DSBufferPool::Buffer& fileData) {
+        auto texture = std::make_unique<DSTexture>();
+        bool success = texture->LoadFromMemory(fileData.Data(), fileData.Size());
+
+        // The file data is no longer needed, let the I/O thread read ahead again
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_bytesInFlight -= fileData.Size();
+        }
+        fileData.Reset();
+        m_ioCondition.notify_all();
+
+        const DSTexture::AsyncLoadOptions& options = state->options;
+        if (success && options.generateMipmaps) {
+            success = texture->GenerateMipmaps(options.quality);
+        }
+        if (success && DSTexture::IsFormatCompressed(options.compressFormat)) {
+            success = texture->Compress(options.compressFormat, options.quality, 0);
+        }
+
+        Finish(*state, success ? std::move(texture) : nullptr);
+    }
+
+    void DSTextureLoader::Finish(DSTextureLoadHandle::State& state, std::unique_ptr<DSTexture> texture) {
+        {
+            std::lock_guard<std::mutex> lock(state.mutex);
+            state.status = texture ? DSTextureLoadHandle::Status::Ready : DSTextureLoadHandle::Status::Failed;
+            state.texture = std::move(texture);
+        }
+        state.done.notify_all();
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_pendingLoads--;
+        }
+        m_idle.notify_all();
+    }
+}
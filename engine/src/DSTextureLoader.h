@@ -0,0 +1,96 @@
+#pragma once
+#include "DSTexture.h"
+#include "DSBufferPool.h"
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace DSEngine {
+    /**
+     * Handle to a load started with DSTexture::LoadAsync. Copies refer to the same load,
+     * the handle can be polled from the main loop or waited on.
+     */
+    class DSTextureLoadHandle {
+    public:
+        enum class Status {
+            Invalid,  // Default constructed handle
+            Pending,
+            Ready,
+            Failed
+        };
+
+        DSTextureLoadHandle() = default;
+
+        Status GetStatus() const;
+        bool IsDone() const { return GetStatus() != Status::Pending; }
+        void Wait() const;
+
+        /**
+         * Waits for the load and takes the texture.
+         *
+         * @return The texture, nullptr if the load failed or the texture was already taken.
+         */
+        std::unique_ptr<DSTexture> Take();
+
+    private:
+        friend class DSTextureLoader;
+        struct State;
+
+        explicit DSTextureLoadHandle(std::shared_ptr<State> state) : m_state(std::move(state)) {}
+
+        std::shared_ptr<State> m_state;
+    };
+
+    /**
+     * Background loader behind DSTexture::LoadAsync. A dedicated I/O thread reads the files in request
+     * order while the engine thread pool decodes (and optionally mips and compresses) the ones already read,
+     * so a batch of loads keeps the disk and the CPU busy at the same time.
+     */
+    class DSTextureLoader {
+    public:
+        static DSTextureLoader& Get();
+        ~DSTextureLoader();
+
+        DSTextureLoader(const DSTextureLoader&) = delete;
+        DSTextureLoader& operator=(const DSTextureLoader&) = delete;
+
+        /**
+         * Limits the file data read but not decoded yet, the I/O thread waits when over it.
+         * A single file larger than the limit is still loaded, so 0 reads one file at a time.
+         *
+         * @param bytes The limit in bytes.
+         */
+        void SetMaxBytesInFlight(size_t bytes);
+
+        uint32_t GetPendingLoads();
+
+        // Blocks until every queued load finished
+        void WaitAll();
+
+    private:
+        friend class DSTexture;
+
+        DSTextureLoader();
+
+        DSTextureLoadHandle Load(const std::string& path, const DSTexture::AsyncLoadOptions& options);
+        void IOLoop();
+        void Decode(const std::shared_ptr<DSTextureLoadHandle::State>& state, DSBufferPool::Buffer& fileData);
+        void Finish(DSTextureLoadHandle::State& state, std::unique_ptr<DSTexture> texture);
+
+        std::thread m_ioThread;
+        std::deque<std::shared_ptr<DSTextureLoadHandle::State>> m_readQueue;
+        std::mutex m_mutex;
+        std::condition_variable m_ioCondition;
+        std::condition_variable m_idle;
+
+        size_t m_maxBytesInFlight = 256ull * 1024 * 1024;
+        size_t m_bytesInFlight = 0;
+        uint32_t m_pendingLoads = 0;
+        bool m_stopping = false;
+    };
+}
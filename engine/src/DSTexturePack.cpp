@@ -0,0 +1,282 @@
+#include "DSTexturePack.h"
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+namespace DSEngine {
+    // =====================
+    // Names
+    // =====================
+
+    std::string DSTexturePack::NormalizeName(const std::string& name) {
+        std::string normalized = name;
+        for (char& c : normalized) {
+            if (c == '\\') {
+                c = '/';
+            } else if (c >= 'A' && c <= 'Z') {
+                c = static_cast<char>(c - 'A' + 'a');
+            }
+        }
+        return normalized;
+    }
+
+    // FNV-1a, stored in the pack so it must never change for a given PACK_VERSION
+    uint64_t DSTexturePack::HashName(const std::string& normalizedName) {
+        uint64_t hash = 0xCBF29CE484222325ull;
+        for (char c : normalizedName) {
+            hash ^= static_cast<uint8_t>(c);
+            hash *= 0x100000001B3ull;
+        }
+        return hash;
+    }
+
+    // =====================
+    // Reading
+    // =====================
+
+    bool DSTexturePack::Open(const std::string& path) {
+        Close();
+
+        auto file = std::make_shared<DSMappedFile>();
+        if (!file->Open(path) || file->GetSize() < sizeof(PackHeader)) {
+            return false;
+        }
+
+        const uint8_t* data = file->GetData();
+        const size_t fileSize = file->GetSize();
+
+        PackHeader header;
+        std::memcpy(&header, data, sizeof(PackHeader));
+        if (std::memcmp(header.magic, "DSTP", 4) != 0 || header.version != PACK_VERSION ||
+            header.slotCount <= header.entryCount || (header.slotCount & (header.slotCount - 1)) != 0) {
+            return false;
+        }
+
+        const size_t entriesOffset = sizeof(PackHeader);
+        const size_t slotsOffset = entriesOffset + static_cast<size_t>(header.entryCount) * sizeof(PackEntry);
+        const size_t namesOffset = slotsOffset + static_cast<size_t>(header.slotCount) * sizeof(uint32_t);
+        if (namesOffset + header.namesSize > fileSize) {
+            return false;
+        }
+
+        // Validate everything once so lookups can trust the table
+        const PackEntry* entries = reinterpret_cast<const PackEntry*>(data + entriesOffset);
+        const uint32_t* slots = reinterpret_cast<const uint32_t*>(data + slotsOffset);
+        for (uint32_t i = 0; i < header.entryCount; ++i) {
+            const PackEntry& entry = entries[i];
+            if (entry.offset > fileSize || entry.size > fileSize - entry.offset ||
+                static_cast<uint64_t>(entry.nameOffset) + entry.nameLength > header.namesSize) {
+                return false;
+            }
+        }
+        // Each entry in at most one slot and at least one empty slot, or FindEntry would probe forever
+        std::vector<bool> slotted(header.entryCount, false);
+        uint32_t emptySlots = 0;
+        for (uint32_t i = 0; i < header.slotCount; ++i) {
+            if (slots[i] == EMPTY_SLOT) {
+                emptySlots++;
+                continue;
+            }
+            if (slots[i] >= header.entryCount || slotted[slots[i]]) {
+                return false;
+            }
+            slotted[slots[i]] = true;
+        }
+        if (emptySlots == 0) {
+            return false;
+        }
+
+        m_file = std::move(file);
+        m_entries = entries;
+        m_slots = slots;
+        m_names = reinterpret_cast<const char*>(data + namesOffset);
+        m_entryCount = header.entryCount;
+        m_slotCount = header.slotCount;
+        return true;
+    }
+
+    void DSTexturePack::Close() {
+        m_file.reset();
+        m_entries = nullptr;
+        m_slots = nullptr;
+        m_names = nullptr;
+        m_entryCount = 0;
+        m_slotCount = 0;
+    }
+
+    const DSTexturePack::PackEntry* DSTexturePack::FindEntry(const std::string& normalizedName) const {
+        if (!m_file) return nullptr;
+
+        // Linear probing, the table always has an empty slot so the loop ends
+        const uint64_t hash = HashName(normalizedName);
+        for (uint32_t slot = static_cast<uint32_t>(hash) & (m_slotCount - 1);; slot = (slot + 1) & (m_slotCount - 1)) {
+            if (m_slots[slot] == EMPTY_SLOT) {
+                return nullptr;
+            }
+
+            const PackEntry& entry = m_entries[m_slots[slot]];
+            if (entry.nameHash == hash && entry.nameLength == normalizedName.size() &&
+                std::memcmp(m_names + entry.nameOffset, normalizedName.data(), entry.nameLength) == 0) {
+                return &entry;
+            }
+        }
+    }
+
+    bool DSTexturePack::Find(const std::string& name, const uint8_t*& data, size_t& size) const {
+        const PackEntry* entry = FindEntry(NormalizeName(name));
+        if (!entry) {
+            return false;
+        }
+
+        data = m_file->GetData() + entry->offset;
+        size = static_cast<size_t>(entry->size);
+        return true;
+    }
+
+    bool DSTexturePack::Contains(const std::string& name) const {
+        return FindEntry(NormalizeName(name)) != nullptr;
+    }
+
+    std::string DSTexturePack::GetEntryName(uint32_t index) const {
+        if (index >= m_entryCount) return std::string();
+
+        const PackEntry& entry = m_entries[index];
+        return std::string(m_names + entry.nameOffset, entry.nameLength);
+    }
+
+    // =====================
+    // Writing
+    // =====================
+
+    bool DSTexturePackWriter::AddFile(const std::string& name, const std::string& path) {
+        PendingEntry entry;
+        entry.name = DSTexturePack::NormalizeName(name);
+        entry.sourcePath = path;
+        return AddEntry(std::move(entry));
+    }
+
+    bool DSTexturePackWriter::AddData(const std::string& name, const uint8_t* data, size_t size) {
+        PendingEntry entry;
+        entry.name = DSTexturePack::NormalizeName(name);
+        entry.data.assign(data, data + size);
+        return AddEntry(std::move(entry));
+    }
+
+    bool DSTexturePackWriter::AddEntry(PendingEntry entry) {
+        if (entry.name.empty() || !m_names.insert(entry.name).second) {
+            return false;
+        }
+        m_entries.push_back(std::move(entry));
+        return true;
+    }
+
+    bool DSTexturePackWriter::Write(const std::string& path) const {
+        using PackHeader = DSTexturePack::PackHeader;
+        using PackEntry = DSTexturePack::PackEntry;
+        const uint64_t alignment = DSTexturePack::PAYLOAD_ALIGNMENT;
+
+        // Sizes of the files added by path
+        std::vector<uint64_t> sizes(m_entries.size());
+        for (size_t i = 0; i < m_entries.size(); ++i) {
+            const PendingEntry& pending = m_entries[i];
+            if (pending.sourcePath.empty()) {
+                sizes[i] = pending.data.size();
+                continue;
+            }
+
+            std::error_code error;
+            sizes[i] = std::filesystem::file_size(pending.sourcePath, error);
+            if (error) {
+                return false;
+            }
+        }
+
+        // Table of contents, at most half full
+        PackHeader header;
+        header.entryCount = static_cast<uint32_t>(m_entries.size());
+        header.slotCount = 1;
+        while (header.slotCount < header.entryCount * 2 + 1) {
+            header.slotCount *= 2;
+        }
+
+        std::vector<PackEntry> entries(m_entries.size());
+        std::vector<uint32_t> slots(header.slotCount, DSTexturePack::EMPTY_SLOT);
+        std::string names;
+        for (uint32_t i = 0; i < header.entryCount; ++i) {
+            const std::string& name = m_entries[i].name;
+            PackEntry& entry = entries[i];
+            entry.nameHash = DSTexturePack::HashName(name);
+            entry.size = sizes[i];
+            entry.nameOffset = static_cast<uint32_t>(names.size());
+            entry.nameLength = static_cast<uint32_t>(name.size());
+            names += name;
+
+            uint32_t slot = static_cast<uint32_t>(entry.nameHash) & (header.slotCount - 1);
+            while (slots[slot] != DSTexturePack::EMPTY_SLOT) {
+                slot = (slot + 1) & (header.slotCount - 1);
+            }
+            slots[slot] = i;
+        }
+        header.namesSize = static_cast<uint32_t>(names.size());
+
+        // Payloads follow the table of contents, each on its own page
+        uint64_t offset = sizeof(PackHeader) + entries.size() * sizeof(PackEntry) + slots.size() * sizeof(uint32_t) + names.size();
+        for (PackEntry& entry : entries) {
+            offset = (offset + alignment - 1) / alignment * alignment;
+            entry.offset = offset;
+            offset += entry.size;
+        }
+
+        const std::string tempPath = path + ".tmp";
+        {
+            std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+            if (!file.is_open()) {
+                return false;
+            }
+
+            file.write(reinterpret_cast<const char*>(&header), sizeof(PackHeader));
+            file.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(PackEntry));
+            file.write(reinterpret_cast<const char*>(slots.data()), slots.size() * sizeof(uint32_t));
+            file.write(names.data(), names.size());
+
+            const std::vector<char> padding(alignment, 0);
+            std::vector<char> fileData;
+            for (size_t i = 0; i < m_entries.size() && file.good(); ++i) {
+                const uint64_t position = static_cast<uint64_t>(file.tellp());
+                file.write(padding.data(), static_cast<std::streamsize>(entries[i].offset - position));
+
+                const PendingEntry& pending = m_entries[i];
+                if (pending.sourcePath.empty()) {
+                    file.write(reinterpret_cast<const char*>(pending.data.data()), pending.data.size());
+                    continue;
+                }
+
+                // A source changing size between the two passes would break the layout
+                std::ifstream source(pending.sourcePath, std::ios::binary);
+                fileData.resize(static_cast<size_t>(entries[i].size));
+                source.read(fileData.data(), fileData.size());
+                if (!source.good() || source.peek() != std::ifstream::traits_type::eof()) {
+                    file.close();
+                    std::remove(tempPath.c_str());
+                    return false;
+                }
+                file.write(fileData.data(), fileData.size());
+            }
+
+            if (!file.good()) {
+                file.close();
+                std::remove(tempPath.c_str());
+                return false;
+            }
+        }
+
+        std::error_code error;
+        std::filesystem::rename(tempPath, path, error);
+        if (error) {
+            std::remove(tempPath.c_str());
+            return false;
+        }
+        return true;
+    }
+}
@@ -0,0 +1,125 @@
+#pragma once
+#include "DSMappedFile.h"
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace DSEngine {
+    /**
+     * Read-only archive of many DST files in one mapped file.
+     * Names are found through a hashed table of contents in O(1), payloads start on page boundaries
+     * so textures can be used straight from the mapping (see DSTexture::LoadFromPackMapped).
+     *
+     * Layout: PackHeader, PackEntry[entryCount], uint32_t slots[slotCount], names, aligned payloads.
+     * Names are stored normalized: lowercase with '/' separators.
+     */
+    class DSTexturePack {
+    public:
+        static constexpr uint32_t PAYLOAD_ALIGNMENT = 4096;
+
+        DSTexturePack() = default;
+
+        DSTexturePack(const DSTexturePack&) = delete;
+        DSTexturePack& operator=(const DSTexturePack&) = delete;
+
+        /**
+         * Maps a pack and validates its table of contents, closing any previous pack.
+         *
+         * @param path The pack file.
+         * @return false if the file can't be mapped or is not a valid pack.
+         */
+        bool Open(const std::string& path);
+        void Close();
+        bool IsOpen() const { return m_file != nullptr; }
+
+        /**
+         * Looks up a payload by name.
+         *
+         * @param name The name it was added with, case and separators don't matter.
+         * @param data Set to the payload inside the mapping.
+         * @param size Set to the payload size.
+         * @return false if the pack has no such entry.
+         */
+        bool Find(const std::string& name, const uint8_t*& data, size_t& size) const;
+        bool Contains(const std::string& name) const;
+
+        uint32_t GetEntryCount() const { return m_entryCount; }
+        std::string GetEntryName(uint32_t index) const;
+
+        static std::string NormalizeName(const std::string& name);
+        static uint64_t HashName(const std::string& normalizedName);
+
+    private:
+        friend class DSTexture;
+        friend class DSTexturePackWriter;
+
+        static constexpr uint16_t PACK_VERSION = 1;
+        static constexpr uint32_t EMPTY_SLOT = 0xFFFFFFFFu;
+
+#pragma pack(push, 1)
+        struct PackHeader {
+            char magic[4] = {'D', 'S', 'T', 'P'};
+            uint16_t version = PACK_VERSION;
+            uint16_t reserved = 0;
+            uint32_t entryCount = 0;
+            uint32_t slotCount = 0;    // Power of two, larger than entryCount
+            uint32_t namesSize = 0;
+            uint32_t alignment = PAYLOAD_ALIGNMENT;
+            uint64_t reserved2 = 0;
+        };
+
+        struct PackEntry {
+            uint64_t nameHash;
+            uint64_t offset;           // From the start of the pack
+            uint64_t size;
+            uint32_t nameOffset;       // Into the names block
+            uint32_t nameLength;
+        };
+#pragma pack(pop)
+
+        const PackEntry* FindEntry(const std::string& normalizedName) const;
+
+        std::shared_ptr<DSMappedFile> m_file;
+        const PackEntry* m_entries = nullptr;
+        const uint32_t* m_slots = nullptr;
+        const char* m_names = nullptr;
+        uint32_t m_entryCount = 0;
+        uint32_t m_slotCount = 0;
+    };
+
+    /**
+     * Builds a DSTexturePack. Files added by path are only read when the pack is written.
+     */
+    class DSTexturePackWriter {
+    public:
+        /**
+         * @return false if an entry with the same normalized name was already added.
+         */
+        bool AddFile(const std::string& name, const std::string& path);
+        bool AddData(const std::string& name, const uint8_t* data, size_t size);
+
+        /**
+         * Writes the pack, to a temporary file first so an open pack at the same path is never half written.
+         *
+         * @return false if a source file can't be read or the pack can't be written.
+         */
+        bool Write(const std::string& path) const;
+
+        uint32_t GetEntryCount() const { return static_cast<uint32_t>(m_entries.size()); }
+
+    private:
+        struct PendingEntry {
+            std::string name;          // Normalized
+            std::string sourcePath;    // Empty when the data was given directly
+            std::vector<uint8_t> data;
+        };
+
+        bool AddEntry(PendingEntry entry);
+
+        std::vector<PendingEntry> m_entries;
+        std::unordered_set<std::string> m_names;
+    };
+}
@@ -0,0 +1,221 @@
+#include "DSTextureSampler.h"
+#include "DSDXTDecoder.h"
+#include <immintrin.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace DSEngine {
+    namespace {
+        // Texel coordinates are kept in int range, NaN ends up at the low limit
+        const float COORDINATE_LIMIT = 1073741824.0f;
+
+        inline float ClampCoordinate(float value) {
+            value = (value > -COORDINATE_LIMIT) ? value : -COORDINATE_LIMIT;
+            return (value < COORDINATE_LIMIT) ? value : COORDINATE_LIMIT;
+        }
+
+        inline __m128 ClampCoordinates(__m128 value) {
+            // max returns its second operand for NaN
+            value = _mm_max_ps(value, _mm_set1_ps(-COORDINATE_LIMIT));
+            return _mm_min_ps(value, _mm_set1_ps(COORDINATE_LIMIT));
+        }
+
+        // Floor for SSE2: truncation rounds negative values up, step them back down
+        inline __m128i FloorToInt(__m128 value) {
+            const __m128i truncated = _mm_cvttps_epi32(value);
+            const __m128 above = _mm_cmpgt_ps(_mm_cvtepi32_ps(truncated), value);
+            return _mm_add_epi32(truncated, _mm_castps_si128(above));
+        }
+
+        inline __m128 Lerp(__m128 a, __m128 b, __m128 t) {
+            return _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(b, a), t));
+        }
+    }
+
+    DSTextureSampler::DSTextureSampler(const DSTexture& texture, uint32_t cacheBlocks, Address address)
+        : m_texture(texture), m_format(texture.GetFormat()), m_address(address) {
+        for (uint32_t i = 0; i < texture.GetMipLevels(); i++) {
+            m_mips.push_back({ texture.GetWidth(i), texture.GetHeight(i) });
+        }
+
+        uint32_t slotBits = 2;
+        while (slotBits < 24 && (1u << slotBits) < cacheBlocks) slotBits++;
+
+        // As many slots across as the base level has blocks, so scanning rows never evicts, but at least 4 block rows
+        uint32_t widthBits = 0;
+        const uint32_t blocksWide = m_mips.empty() ? 1 : (m_mips[0].width + 3) / 4;
+        while ((1u << widthBits) < blocksWide) widthBits++;
+        m_slotBitsY = std::max(2u, slotBits - std::min(widthBits, slotBits));
+        m_slotBitsX = slotBits - m_slotBitsY;
+
+        m_keys.assign(static_cast<size_t>(1) << slotBits, EMPTY_KEY);
+        m_blocks.resize(m_keys.size() * 64);
+    }
+
+    void DSTextureSampler::Fetch(int32_t x, int32_t y, float* rgba, uint32_t mip) {
+        if (m_mips.empty()) {
+            std::fill(rgba, rgba + 4, 0.0f);
+            return;
+        }
+        mip = ClampMip(mip);
+        const MipInfo& info = m_mips[mip];
+        std::memcpy(rgba, GetTexel(Address1D(x, info.width), Address1D(y, info.height), mip), 4 * sizeof(float));
+    }
+
+    void DSTextureSampler::SamplePoint(float u, float v, float* rgba, uint32_t mip) {
+        SamplePoint(&u, &v, 1, rgba, mip);
+    }
+
+    void DSTextureSampler::SampleBilinear(float u, float v, float* rgba, uint32_t mip) {
+        SampleBilinear(&u, &v, 1, rgba, mip);
+    }
+
+    void DSTextureSampler::SamplePoint(const float* u, const float* v, size_t count, float* rgba, uint32_t mip) {
+        if (m_mips.empty()) {
+            std::fill(rgba, rgba + count * 4, 0.0f);
+            return;
+        }
+        mip = ClampMip(mip);
+        const MipInfo& info = m_mips[mip];
+        const __m128 width = _mm_set1_ps(static_cast<float>(info.width));
+        const __m128 height = _mm_set1_ps(static_cast<float>(info.height));
+
+        size_t i = 0;
+        alignas(16) int32_t x[4], y[4];
+        for (; i + 4 <= count; i += 4) {
+            _mm_store_si128(reinterpret_cast<__m128i*>(x), FloorToInt(ClampCoordinates(_mm_mul_ps(_mm_loadu_ps(u + i), width))));
+            _mm_store_si128(reinterpret_cast<__m128i*>(y), FloorToInt(ClampCoordinates(_mm_mul_ps(_mm_loadu_ps(v + i), height))));
+            for (int lane = 0; lane < 4; lane++) {
+                const float* texel = GetTexel(Address1D(x[lane], info.width), Address1D(y[lane], info.height), mip);
+                _mm_storeu_ps(rgba + (i + lane) * 4, _mm_loadu_ps(texel));
+            }
+        }
+        for (; i < count; i++) {
+            const int32_t texelX = static_cast<int32_t>(std::floor(ClampCoordinate(u[i] * info.width)));
+            const int32_t texelY = static_cast<int32_t>(std::floor(ClampCoordinate(v[i] * info.height)));
+            std::memcpy(rgba + i * 4, GetTexel(Address1D(texelX, info.width), Address1D(texelY, info.height), mip),
+                        4 * sizeof(float));
+        }
+    }
+
+    void DSTextureSampler::SampleBilinear(const float* u, const float* v, size_t count, float* rgba, uint32_t mip) {
+        if (m_mips.empty()) {
+            std::fill(rgba, rgba + count * 4, 0.0f);
+            return;
+        }
+        mip = ClampMip(mip);
+        const MipInfo& info = m_mips[mip];
+        const __m128 width = _mm_set1_ps(static_cast<float>(info.width));
+        const __m128 height = _mm_set1_ps(static_cast<float>(info.height));
+        const __m128 half = _mm_set1_ps(0.5f);
+
+        // Texels are loaded into registers one at a time, so a lookup evicting an earlier one is harmless
+        auto filter = [&](int32_t x0, int32_t y0, float tx, float ty, float* out) {
+            const uint32_t ax0 = Address1D(x0, info.width), ax1 = Address1D(x0 + 1, info.width);
+            const uint32_t ay0 = Address1D(y0, info.height), ay1 = Address1D(y0 + 1, info.height);
+            const __m128 t00 = _mm_loadu_ps(GetTexel(ax0, ay0, mip));
+            const __m128 t10 = _mm_loadu_ps(GetTexel(ax1, ay0, mip));
+            const __m128 t01 = _mm_loadu_ps(GetTexel(ax0, ay1, mip));
+            const __m128 t11 = _mm_loadu_ps(GetTexel(ax1, ay1, mip));
+            const __m128 weightX = _mm_set1_ps(tx);
+            _mm_storeu_ps(out, Lerp(Lerp(t00, t10, weightX), Lerp(t01, t11, weightX), _mm_set1_ps(ty)));
+        };
+
+        size_t i = 0;
+        alignas(16) int32_t x[4], y[4];
+        alignas(16) float tx[4], ty[4];
+        for (; i + 4 <= count; i += 4) {
+            const __m128 fx = ClampCoordinates(_mm_sub_ps(_mm_mul_ps(_mm_loadu_ps(u + i), width), half));
+            const __m128 fy = ClampCoordinates(_mm_sub_ps(_mm_mul_ps(_mm_loadu_ps(v + i), height), half));
+            const __m128i x0 = FloorToInt(fx);
+            const __m128i y0 = FloorToInt(fy);
+            _mm_store_si128(reinterpret_cast<__m128i*>(x), x0);
+            _mm_store_si128(reinterpret_cast<__m128i*>(y), y0);
+            _mm_store_ps(tx, _mm_sub_ps(fx, _mm_cvtepi32_ps(x0)));
+            _mm_store_ps(ty, _mm_sub_ps(fy, _mm_cvtepi32_ps(y0)));
+            for (int lane = 0; lane < 4; lane++) {
+                filter(x[lane], y[lane], tx[lane], ty[lane], rgba + (i + lane) * 4);
+            }
+        }
+        for (; i < count; i++) {
+            const float fx = ClampCoordinate(u[i] * info.width - 0.5f);
+            const float fy = ClampCoordinate(v[i] * info.height - 0.5f);
+            const float x0 = std::floor(fx);
+            const float y0 = std::floor(fy);
+            filter(static_cast<int32_t>(x0), static_cast<int32_t>(y0), fx - x0, fy - y0, rgba + i * 4);
+        }
+    }
+
+    void DSTextureSampler::Invalidate() {
+        std::fill(m_keys.begin(), m_keys.end(), EMPTY_KEY);
+    }
+
+    const float* DSTextureSampler::GetTexel(uint32_t x, uint32_t y, uint32_t mip) {
+        const uint32_t blockX = x >> 2;
+        const uint32_t blockY = y >> 2;
+        const uint32_t slot = ((blockY & ((1u << m_slotBitsY) - 1)) << m_slotBitsX) | (blockX & ((1u << m_slotBitsX) - 1));
+        const uint64_t key = (static_cast<uint64_t>(mip) << 56) | (static_cast<uint64_t>(blockY) << 28) | blockX;
+
+        float* block = m_blocks.data() + static_cast<size_t>(slot) * 64;
+        if (m_keys[slot] == key) {
+            m_stats.hits++;
+        } else {
+            DecodeBlock(blockX, blockY, mip, block);
+            m_keys[slot] = key;
+            m_stats.misses++;
+        }
+        return block + ((y & 3) * 4 + (x & 3)) * 4;
+    }
+
+    void DSTextureSampler::DecodeBlock(uint32_t blockX, uint32_t blockY, uint32_t mip, float* dest) {
+        const uint8_t* pixels = m_texture.GetPixels(mip);
+        if (!pixels) {
+            std::fill(dest, dest + 64, 0.0f);
+            return;
+        }
+
+        // Texels past the right or bottom edge are left as they are, addressing never reaches them
+        const MipInfo& info = m_mips[mip];
+        const uint32_t width = std::min(4u, info.width - blockX * 4);
+        const uint32_t rows = std::min(4u, info.height - blockY * 4);
+
+        if (!DSTexture::IsFormatCompressed(m_format)) {
+            const size_t pixelSize = DSTexture::GetPixelSize(m_format);
+            for (uint32_t row = 0; row < rows; row++) {
+                const size_t offset = ((blockY * 4 + row) * static_cast<size_t>(info.width) + blockX * 4) * pixelSize;
+                DSTexture::ConvertToRGBA32F(m_format, pixels + offset, dest + row * 16, width);
+            }
+            return;
+        }
+
+        const DSTexture::Format decompressed = DSTexture::GetDecompressedFormat(m_format);
+        const size_t pixelSize = DSTexture::GetPixelSize(decompressed);
+        const uint32_t blocksWide = (info.width + 3) / 4;
+        const uint8_t* block = pixels + (blockY * static_cast<size_t>(blocksWide) + blockX) * DSTexture::GetBlockSize(m_format);
+
+        uint8_t decoded[4 * 4 * 4];
+        switch (m_format) {
+            case DSTexture::Format::DXT1: DSDXTDecoder::DecodeDXT1Row(block, width, rows, decoded, 4 * pixelSize); break;
+            case DSTexture::Format::DXT5: DSDXTDecoder::DecodeDXT5Row(block, width, rows, decoded, 4 * pixelSize); break;
+            case DSTexture::Format::BC4: DSDXTDecoder::DecodeBC4Row(block, width, rows, decoded, 4 * pixelSize); break;
+            case DSTexture::Format::BC5: DSDXTDecoder::DecodeBC5Row(block, width, rows, decoded, 4 * pixelSize); break;
+            default: break;
+        }
+        // Decoded rows are as packed as the cached ones, convert them in one go
+        DSTexture::ConvertToRGBA32F(decompressed, decoded, dest, rows * 4);
+    }
+
+    uint32_t DSTextureSampler::Address1D(int32_t coordinate, uint32_t size) const {
+        if (m_address == Address::Wrap) {
+            const int32_t wrapped = coordinate % static_cast<int32_t>(size);
+            return static_cast<uint32_t>(wrapped < 0 ? wrapped + static_cast<int32_t>(size) : wrapped);
+        }
+        if (coordinate < 0) return 0;
+        return std::min(static_cast<uint32_t>(coordinate), size - 1);
+    }
+
+    uint32_t DSTextureSampler::ClampMip(uint32_t mip) const {
+        return std::min(mip, static_cast<uint32_t>(m_mips.size()) - 1);
+    }
+}
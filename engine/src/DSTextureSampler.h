@@ -0,0 +1,103 @@
+#pragma once
+#include "DSTexture.h"
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+namespace DSEngine {
+    /**
+     * Read-only CPU sampling of a texture in any format without decompressing it.
+     * Texels are read through a small cache of decoded 4x4 blocks in RGBA32F: compressed blocks are decoded
+     * on their first use, uncompressed and float formats are converted the same way. Cache slots are picked
+     * from the low bits of the block coordinates: the cache covers a window as wide as the texture (capped so it
+     * is at least 4 blocks high) that never evicts itself, so scans and local queries decode each block once.
+     * Results follow DSTexture::ConvertToRGBA32F (8-bit channels in [0, 1], R8 replicated like gray, alpha 1 if absent).
+     *
+     * The texture must outlive the sampler and not be modified while it is sampled (call Invalidate after
+     * modifying it or streaming mips in). Mips that are not resident read as 0.
+     * A sampler is not thread safe, use one per thread.
+     */
+    class DSTextureSampler {
+    public:
+        enum class Address {
+            Clamp,  // Coordinates outside the mip use the edge texels
+            Wrap    // Coordinates repeat
+        };
+
+        struct Stats {
+            uint64_t hits = 0;    // Block lookups served by the cache
+            uint64_t misses = 0;  // Blocks decoded
+        };
+
+        /**
+         * @param texture The texture to read.
+         * @param cacheBlocks Number of decoded blocks kept (64 floats each), rounded up to a power of two, at least 4.
+         * @param address How coordinates outside the mip are handled.
+         */
+        explicit DSTextureSampler(const DSTexture& texture, uint32_t cacheBlocks = 256, Address address = Address::Clamp);
+
+        DSTextureSampler(const DSTextureSampler&) = delete;
+        DSTextureSampler& operator=(const DSTextureSampler&) = delete;
+
+        /**
+         * Reads one texel.
+         *
+         * @param x Texel column, addressed like the sampler.
+         * @param y Texel row.
+         * @param rgba Receives 4 floats.
+         * @param mip Mip level, clamped to the last one.
+         */
+        void Fetch(int32_t x, int32_t y, float* rgba, uint32_t mip = 0);
+
+        // Nearest texel at normalized coordinates, (0, 0) is the first texel of the mip data
+        void SamplePoint(float u, float v, float* rgba, uint32_t mip = 0);
+
+        // Bilinear filter at normalized coordinates, texel centers at (i + 0.5) / size like on the GPU
+        void SampleBilinear(float u, float v, float* rgba, uint32_t mip = 0);
+
+        /**
+         * Batched sampling, coordinates are set up 4 at a time with SSE.
+         *
+         * @param u Normalized coordinates, count of them.
+         * @param v Normalized coordinates, count of them.
+         * @param count Number of samples.
+         * @param rgba Receives 4 floats per sample.
+         * @param mip Mip level, clamped to the last one.
+         */
+        void SamplePoint(const float* u, const float* v, size_t count, float* rgba, uint32_t mip = 0);
+        void SampleBilinear(const float* u, const float* v, size_t count, float* rgba, uint32_t mip = 0);
+
+        // Drops every cached block
+        void Invalidate();
+
+        const Stats& GetStats() const { return m_stats; }
+        void ResetStats() { m_stats = Stats(); }
+
+        // Bytes used by the cache
+        size_t GetCacheSize() const { return m_blocks.size() * sizeof(float); }
+
+    private:
+        static constexpr uint64_t EMPTY_KEY = ~0ull;
+
+        struct MipInfo {
+            uint32_t width;
+            uint32_t height;
+        };
+
+        // RGBA32F of texel (x, y) of a mip, coordinates already addressed
+        const float* GetTexel(uint32_t x, uint32_t y, uint32_t mip);
+        void DecodeBlock(uint32_t blockX, uint32_t blockY, uint32_t mip, float* dest);
+        uint32_t Address1D(int32_t coordinate, uint32_t size) const;
+        uint32_t ClampMip(uint32_t mip) const;
+
+        const DSTexture& m_texture;
+        const DSTexture::Format m_format;
+        const Address m_address;
+        std::vector<MipInfo> m_mips;
+        std::vector<uint64_t> m_keys;   // Mip and block coordinates of each slot
+        std::vector<float> m_blocks;    // 4x4 RGBA32F per slot
+        uint32_t m_slotBitsX = 0;       // Slot = low bits of the block y, then low bits of the block x
+        uint32_t m_slotBitsY = 0;
+        Stats m_stats;
+    };
+}
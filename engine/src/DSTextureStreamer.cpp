@@ -0,0 +1,161 @@
+#include "DSTextureStreamer.h"
+#include "DSTexture.h"
+#include "DSThreadPool.h"
+#include <cstring>
+#include <fstream>
+#include <string>
+
+namespace DSEngine {
+    DSTextureStreamer& DSTextureStreamer::Get() {
+        static DSTextureStreamer streamer;
+        return streamer;
+    }
+
+    void DSTextureStreamer::Register(DSTexture* texture) {
+        DSTexture::StreamingState& state = *texture->m_streaming;
+
+        state.residentBytes = 0;
+        for (uint32_t i = state.residentMip; i < texture->m_mipmaps.size(); ++i) {
+            state.residentBytes += texture->m_mipmaps[i].Size();
+        }
+        state.lastUse = m_frame;
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        state.id = m_nextId++;
+        m_textures[state.id] = texture;
+        m_residentBytes += state.residentBytes;
+    }
+
+    void DSTextureStreamer::Unregister(DSTexture* texture) {
+        DSTexture::StreamingState& state = *texture->m_streaming;
+
+        // A load still in flight is dropped by Update since the id is gone
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_textures.erase(state.id);
+        m_residentBytes -= state.residentBytes;
+        state.residentBytes = 0;
+    }
+
+    void DSTextureStreamer::Request(DSTexture* texture, uint32_t mipLevel) {
+        DSTexture::StreamingState& state = *texture->m_streaming;
+        state.lastUse = m_frame;
+
+        if (mipLevel >= state.residentMip || state.loadPending) {
+            return;
+        }
+        state.loadPending = true;
+
+        // The task only gets copies, it never touches the texture. It allocates the texture's next chain,
+        // with room for the mips already resident.
+        const uint32_t endMip = state.residentMip;
+        std::vector<DSTexture::DSTMipInfoV4> mipInfos(state.mipInfos.begin() + mipLevel,
+                                                    state.mipInfos.begin() + endMip);
+        std::vector<size_t> sizes(texture->m_mipmaps.size(), 0);
+        for (uint32_t i = mipLevel; i < sizes.size(); ++i) {
+            sizes[i] = (i < endMip) ? state.mipInfos[i].dataSize : texture->m_mipmaps[i].Size();
+        }
+        std::string path = state.path;
+        uint64_t id = state.id;
+
+        m_pendingLoads++;
+        DSThreadPool::Global().Submit([this, path, mipInfos, sizes, id, mipLevel, endMip]() {
+            CompletedLoad load;
+            load.id = id;
+            load.firstMip = mipLevel;
+            load.endMip = endMip;
+            load.storage.Allocate(sizes);
+
+            std::ifstream file(path, std::ios::binary);
+            load.success = true;
+            for (uint32_t i = 0; i < mipInfos.size() && load.success; ++i) {
+                load.success = DSTexture::ReadMip(file, mipInfos[i], load.storage.GetLevel(mipLevel + i));
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_completed.push_back(std::move(load));
+                m_pendingLoads--;
+            }
+            m_idle.notify_all();
+        });
+    }
+
+    void DSTextureStreamer::Update() {
+        std::vector<CompletedLoad> completed;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            completed.swap(m_completed);
+        }
+
+        for (CompletedLoad& load : completed) {
+            auto it = m_textures.find(load.id);
+            if (it == m_textures.end()) continue; // Texture destroyed or no longer streamed
+
+            DSTexture* texture = it->second;
+            DSTexture::StreamingState& state = *texture->m_streaming;
+            state.loadPending = false;
+
+            // Textures with a pending load are never evicted, so the new mips always sit right above the resident ones
+            if (!load.success || state.residentMip != load.endMip) continue;
+
+            for (uint32_t i = load.firstMip; i < load.endMip; ++i) {
+                state.residentBytes += load.storage.GetLevelSize(i);
+                m_residentBytes += load.storage.GetLevelSize(i);
+            }
+            for (uint32_t i = load.endMip; i < texture->m_mipmaps.size(); ++i) {
+                std::memcpy(load.storage.GetLevel(i), texture->m_mipmaps[i].Bytes(), texture->m_mipmaps[i].Size());
+            }
+            texture->SetStorage(std::move(load.storage));
+            state.residentMip = load.firstMip;
+        }
+
+        EvictOverBudget();
+        m_frame++;
+    }
+
+    void DSTextureStreamer::Flush() {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_idle.wait(lock, [this]() { return m_pendingLoads.load() == 0; });
+        }
+        Update();
+    }
+
+    void DSTextureStreamer::EvictOverBudget() {
+        while (m_residentBytes > m_budget) {
+            // Least recently used texture that still has evictable mips and was not used this frame
+            DSTexture* victim = nullptr;
+            for (const auto& entry : m_textures) {
+                const DSTexture::StreamingState& state = *entry.second->m_streaming;
+                if (state.residentMip >= state.tailMip || state.loadPending || state.lastUse >= m_frame) continue;
+
+                if (!victim || state.lastUse < victim->m_streaming->lastUse) {
+                    victim = entry.second;
+                }
+            }
+            if (!victim) return;
+
+            DSTexture::StreamingState& state = *victim->m_streaming;
+            uint32_t residentMip = state.residentMip;
+            while (m_residentBytes > m_budget && residentMip < state.tailMip) {
+                const size_t size = victim->m_mipmaps[residentMip].Size();
+                state.residentBytes -= size;
+                m_residentBytes -= size;
+                residentMip++;
+            }
+
+            // The remaining mips move to a smaller chain, the old one goes back to the buffer pool
+            std::vector<size_t> sizes(victim->m_mipmaps.size(), 0);
+            for (uint32_t i = residentMip; i < sizes.size(); ++i) {
+                sizes[i] = victim->m_mipmaps[i].Size();
+            }
+            DSMipChain storage;
+            storage.Allocate(sizes);
+            for (uint32_t i = residentMip; i < sizes.size(); ++i) {
+                std::memcpy(storage.GetLevel(i), victim->m_mipmaps[i].Bytes(), sizes[i]);
+            }
+            victim->SetStorage(std::move(storage));
+            state.residentMip = residentMip;
+        }
+    }
+}
@@ -0,0 +1,75 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <unordered_map>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include "DSMipChain.h"
+
+namespace DSEngine {
+    class DSTexture;
+
+    /**
+     * Global residency manager for streamed textures (see DSTexture::LoadFromFileStreamed).
+     * Mip loads run on the engine thread pool; finished loads are published and textures
+     * evicted by Update, which must run on the same thread that uses the textures.
+     */
+    class DSTextureStreamer {
+    public:
+        static DSTextureStreamer& Get();
+
+        /**
+         * Sets the memory budget for resident mips of streamed textures.
+         * Only mips above each texture tail can be evicted, so the budget can be exceeded by the tails.
+         *
+         * @param bytes The budget in bytes.
+         */
+        void SetBudget(size_t bytes) { m_budget = bytes; }
+        size_t GetBudget() const { return m_budget; }
+
+        size_t GetResidentBytes() const { return m_residentBytes; }
+        uint32_t GetPendingLoads() const { return m_pendingLoads.load(); }
+
+        /**
+         * Publishes finished loads and evicts the top mips of the least recently used textures
+         * while over budget. Call once per frame.
+         */
+        void Update();
+
+        /**
+         * Blocks until every queued load finished, then publishes them. Meant for loading screens.
+         */
+        void Flush();
+
+    private:
+        friend class DSTexture;
+
+        struct CompletedLoad {
+            uint64_t id;
+            uint32_t firstMip;
+            uint32_t endMip;      // Resident mip when the load was requested
+            DSMipChain storage;   // New chain for the texture, mips from endMip on are copied over by Update
+            bool success;
+        };
+
+        DSTextureStreamer() = default;
+
+        void Register(DSTexture* texture);
+        void Unregister(DSTexture* texture);
+        void Request(DSTexture* texture, uint32_t mipLevel);
+        void EvictOverBudget();
+
+        std::unordered_map<uint64_t, DSTexture*> m_textures;
+        std::vector<CompletedLoad> m_completed;
+        std::mutex m_mutex;
+        std::condition_variable m_idle;
+        std::atomic<uint32_t> m_pendingLoads{0};
+
+        size_t m_budget = 512ull * 1024 * 1024;
+        size_t m_residentBytes = 0;
+        uint64_t m_nextId = 1;
+        uint64_t m_frame = 1;
+    };
+}
@@ -0,0 +1,109 @@
+#include "DSThreadPool.h"
+#include <atomic>
+#include <memory>
+#include <algorithm>
+
+namespace DSEngine {
+    DSThreadPool::DSThreadPool(uint32_t threadCount) {
+        if (threadCount == 0) {
+            const uint32_t hardwareThreads = std::thread::hardware_concurrency();
+            threadCount = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+        }
+
+        m_workers.reserve(threadCount);
+        for (uint32_t i = 0; i < threadCount; ++i) {
+            m_workers.emplace_back(&DSThreadPool::WorkerLoop, this);
+        }
+    }
+
+    DSThreadPool::~DSThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+        }
+        m_condition.notify_all();
+
+        for (std::thread& worker : m_workers) {
+            worker.join();
+        }
+    }
+
+    DSThreadPool& DSThreadPool::Global() {
+        static DSThreadPool pool;
+        return pool;
+    }
+
+    void DSThreadPool::Submit(std::function<void()> task) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_tasks.push_back(std::move(task));
+        }
+        m_condition.notify_one();
+    }
+
+    void DSThreadPool::ParallelFor(uint32_t count, const std::function<void(uint32_t)>& func, uint32_t maxThreads) {
+        if (count == 0) return;
+
+        uint32_t threads = GetThreadCount() + 1;
+        if (maxThreads != 0) threads = std::min(threads, maxThreads);
+        threads = std::min(threads, count);
+
+        if (threads <= 1) {
+            for (uint32_t i = 0; i < count; ++i) {
+                func(i);
+            }
+            return;
+        }
+
+        // Shared between the caller and the helpers. Helpers that start late (the pool may
+        // be busy) find no work left and exit, so the caller only waits for the items.
+        struct Batch {
+            std::atomic<uint32_t> next{0};
+            std::atomic<uint32_t> done{0};
+            std::function<void(uint32_t)> func;
+            uint32_t count = 0;
+            std::mutex mutex;
+            std::condition_variable finished;
+        };
+
+        auto batch = std::make_shared<Batch>();
+        batch->func = func;
+        batch->count = count;
+
+        auto work = [batch]() {
+            uint32_t completed = 0;
+            for (uint32_t i = batch->next++; i < batch->count; i = batch->next++) {
+                batch->func(i);
+                completed++;
+            }
+
+            if (completed > 0 && batch->done.fetch_add(completed) + completed == batch->count) {
+                std::lock_guard<std::mutex> lock(batch->mutex);
+                batch->finished.notify_all();
+            }
+        };
+
+        for (uint32_t i = 1; i < threads; ++i) {
+            Submit(work);
+        }
+        work();
+
+        std::unique_lock<std::mutex> lock(batch->mutex);
+        batch->finished.wait(lock, [&batch]() { return batch->done.load() == batch->count; });
+    }
+
+    void DSThreadPool::WorkerLoop() {
+        for (;;) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_condition.wait(lock, [this]() { return m_stopping || !m_tasks.empty(); });
+                if (m_stopping && m_tasks.empty()) return;
+
+                task = std::move(m_tasks.front());
+                m_tasks.pop_front();
+            }
+            task();
+        }
+    }
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <vector>
+
+namespace DSEngine {
+    /**
+     * Fixed-size pool of worker threads used by the engine for CPU heavy jobs
+     * (texture cooking, decoding, culling...).
+     */
+    class DSThreadPool {
+    public:
+        /**
+         * Creates the pool.
+         *
+         * @param threadCount Number of worker threads, 0 uses one per hardware thread minus the caller.
+         */
+        explicit DSThreadPool(uint32_t threadCount = 0);
+        ~DSThreadPool();
+
+        DSThreadPool(const DSThreadPool&) = delete;
+        DSThreadPool& operator=(const DSThreadPool&) = delete;
+
+        /**
+         * Returns the engine wide pool, created on first use.
+         */
+        static DSThreadPool& Global();
+
+        /**
+         * Queues a task to be executed by one of the workers.
+         *
+         * @param task The task to run.
+         */
+        void Submit(std::function<void()> task);
+
+        /**
+         * Runs func(i) for every i in [0, count) and returns when all of them finished.
+         * The calling thread takes part in the work, so nested calls never dead lock.
+         *
+         * @param count Number of work items.
+         * @param func The function executed for each item.
+         * @param maxThreads Maximum number of threads working on the items (caller included), 0 means no limit.
+         */
+        void ParallelFor(uint32_t count, const std::function<void(uint32_t)>& func, uint32_t maxThreads = 0);
+
+        uint32_t GetThreadCount() const { return static_cast<uint32_t>(m_workers.size()); }
+
+    private:
+        void WorkerLoop();
+
+        std::vector<std::thread> m_workers;
+        std::deque<std::function<void()>> m_tasks;
+        std::mutex m_mutex;
+        std::condition_variable m_condition;
+        bool m_stopping = false;
+    };
+}
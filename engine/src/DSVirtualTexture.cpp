@@ -0,0 +1,480 @@
+#include "DSVirtualTexture.h"
+#include "DSBufferPool.h"
+#include "DSDXTEncoder.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+namespace DSEngine {
+    namespace {
+        // Largest padded tile accepted, keeps tile sizes in 32 bits for every format
+        const uint32_t MAX_PADDED_TILE_SIZE = 8192;
+
+        // Encodes a tightly packed tile in the decompressed layout of a compressed format
+        void EncodeTile(DSTexture::Format format, const uint8_t* pixels, uint32_t size, uint8_t* dest,
+                        DSTexture::CompressionQuality quality) {
+            const bool highQuality = quality == DSTexture::CompressionQuality::NORMAL;
+            const uint32_t blockRows = size / 4;
+
+            switch (format) {
+                case DSTexture::Format::DXT1: {
+                    // The encoder reads RGBA, DXT1 ignores the alpha
+                    DSBufferPool::Buffer rgba(static_cast<size_t>(size) * size * 4);
+                    for (size_t i = 0; i < static_cast<size_t>(size) * size; i++) {
+                        std::memcpy(rgba.Data() + i * 4, pixels + i * 3, 3);
+                        rgba.Data()[i * 4 + 3] = 255;
+                    }
+                    DSDXTEncoder::EncodeRows(rgba.Data(), size, size, 0, blockRows, dest, false, highQuality);
+                    break;
+                }
+                case DSTexture::Format::DXT5:
+                    DSDXTEncoder::EncodeRows(pixels, size, size, 0, blockRows, dest, true, highQuality);
+                    break;
+                case DSTexture::Format::BC4:
+                    DSDXTEncoder::EncodeChannelRows(pixels, 1, size, size, 0, blockRows, dest, highQuality);
+                    break;
+                case DSTexture::Format::BC5:
+                    DSDXTEncoder::EncodeChannelRows(pixels, 2, size, size, 0, blockRows, dest, highQuality);
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+
+    // =====================
+    // Cooking
+    // =====================
+
+    std::vector<DSVirtualTexture::VTMipInfo> DSVirtualTexture::GetMipInfos(const DSTexture& texture, uint32_t tileSize) {
+        std::vector<VTMipInfo> mips;
+        uint32_t firstTile = 0;
+        for (uint32_t level = 0; level < texture.GetMipLevels(); level++) {
+            VTMipInfo info;
+            info.width = texture.GetWidth(level);
+            info.height = texture.GetHeight(level);
+            info.tilesX = (info.width + tileSize - 1) / tileSize;
+            info.tilesY = (info.height + tileSize - 1) / tileSize;
+            info.firstTile = firstTile;
+            firstTile += info.tilesX * info.tilesY;
+            mips.push_back(info);
+
+            // Lower mips would only repeat the single tile
+            if (info.tilesX == 1 && info.tilesY == 1) break;
+        }
+        return mips;
+    }
+
+    void DSVirtualTexture::CookTile(const DSTexture& texture, uint32_t level, int64_t originX, int64_t originY,
+                                    uint32_t paddedSize, DSTexture::CompressionQuality quality, uint8_t* dest) {
+        const DSTexture::Format format = texture.GetFormat();
+        const DSTexture::MipLevel& mip = texture.m_mipmaps[level];
+        const bool compressed = DSTexture::IsFormatCompressed(format);
+
+        // Block aligned tiles inside the mip are the blocks already there
+        if (compressed && originX >= 0 && originY >= 0 && originX % 4 == 0 && originY % 4 == 0 &&
+            originX + paddedSize <= mip.width && originY + paddedSize <= mip.height) {
+            const size_t blockSize = DSTexture::GetBlockSize(format);
+            const size_t blocksWide = (mip.width + 3) / 4;
+            const size_t rowSize = (paddedSize / 4) * blockSize;
+            for (uint32_t row = 0; row < paddedSize / 4; row++) {
+                const size_t offset = ((originY / 4 + row) * blocksWide + originX / 4) * blockSize;
+                std::memcpy(dest + row * rowSize, mip.Bytes() + offset, rowSize);
+            }
+            return;
+        }
+
+        // Read the part of the tile inside the mip, then clamp the border to its edges
+        DSTexture::Region inside;
+        inside.x = static_cast<uint32_t>(std::max<int64_t>(originX, 0));
+        inside.y = static_cast<uint32_t>(std::max<int64_t>(originY, 0));
+        inside.width = static_cast<uint32_t>(std::min<int64_t>(originX + paddedSize, mip.width)) - inside.x;
+        inside.height = static_cast<uint32_t>(std::min<int64_t>(originY + paddedSize, mip.height)) - inside.y;
+
+        const size_t pixelSize = DSTexture::GetPixelSize(format);
+        DSBufferPool::Buffer insidePixels(static_cast<size_t>(inside.width) * inside.height * pixelSize);
+        texture.ReadRegion(level, inside, insidePixels.Data());
+
+        DSBufferPool::Buffer tilePixels;
+        uint8_t* pixels = dest;
+        if (compressed) {
+            tilePixels = DSBufferPool::Buffer(static_cast<size_t>(paddedSize) * paddedSize * pixelSize);
+            pixels = tilePixels.Data();
+        }
+
+        for (uint32_t y = 0; y < paddedSize; y++) {
+            const int64_t sourceY = std::min<int64_t>(std::max<int64_t>(originY + y, 0), mip.height - 1) - inside.y;
+            const uint8_t* sourceRow = insidePixels.Data() + sourceY * inside.width * pixelSize;
+            uint8_t* destRow = pixels + static_cast<size_t>(y) * paddedSize * pixelSize;
+
+            // Left border, the inside span, right border
+            const uint32_t left = static_cast<uint32_t>(inside.x - originX);
+            for (uint32_t x = 0; x < left; x++) {
+                std::memcpy(destRow + x * pixelSize, sourceRow, pixelSize);
+            }
+            std::memcpy(destRow + left * pixelSize, sourceRow, inside.width * pixelSize);
+            for (uint32_t x = left + inside.width; x < paddedSize; x++) {
+                std::memcpy(destRow + x * pixelSize, sourceRow + (inside.width - 1) * pixelSize, pixelSize);
+            }
+        }
+
+        if (compressed) {
+            EncodeTile(format, pixels, paddedSize, dest, quality);
+        }
+    }
+
+    bool DSVirtualTexture::Cook(const DSTexture& texture, const std::string& path, const CookSettings& settings) {
+        const DSTexture::Format format = texture.GetFormat();
+        const uint32_t paddedSize = settings.tileSize + 2 * settings.border;
+        if (format == DSTexture::Format::UNKNOWN || texture.GetMipLevels() == 0 || settings.tileSize == 0 ||
+            settings.tileSize > MAX_PADDED_TILE_SIZE || settings.border > MAX_PADDED_TILE_SIZE || paddedSize > MAX_PADDED_TILE_SIZE ||
+            (DSTexture::IsFormatCompressed(format) && paddedSize % 4 != 0)) {
+            return false;
+        }
+
+        const std::vector<VTMipInfo> mips = GetMipInfos(texture, settings.tileSize);
+        for (uint32_t level = 0; level < mips.size(); level++) {
+            if (!texture.GetPixels(level)) {
+                return false;
+            }
+        }
+
+        VTHeader header;
+        header.format = static_cast<uint16_t>(format);
+        header.width = texture.GetWidth();
+        header.height = texture.GetHeight();
+        header.mipLevels = static_cast<uint32_t>(mips.size());
+        header.tileSize = settings.tileSize;
+        header.border = settings.border;
+        header.tileBytes = DSTexture::CalculateMipSize(paddedSize, paddedSize, format);
+        header.tileCount = mips.back().firstTile + mips.back().tilesX * mips.back().tilesY;
+        const uint64_t tableEnd = sizeof(VTHeader) + mips.size() * sizeof(VTMipInfo);
+        header.dataOffset = (tableEnd + DATA_ALIGNMENT - 1) / DATA_ALIGNMENT * DATA_ALIGNMENT;
+
+        const std::string tempPath = path + ".tmp";
+        {
+            std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+            if (!file.is_open()) {
+                return false;
+            }
+
+            file.write(reinterpret_cast<const char*>(&header), sizeof(VTHeader));
+            file.write(reinterpret_cast<const char*>(mips.data()), mips.size() * sizeof(VTMipInfo));
+            const std::vector<char> padding(static_cast<size_t>(header.dataOffset - tableEnd), 0);
+            file.write(padding.data(), padding.size());
+
+            // Tiles are cooked one at a time so the file never has to fit in memory
+            DSBufferPool::Buffer tile(header.tileBytes);
+            for (uint32_t level = 0; level < mips.size() && file.good(); level++) {
+                for (uint32_t tileY = 0; tileY < mips[level].tilesY && file.good(); tileY++) {
+                    for (uint32_t tileX = 0; tileX < mips[level].tilesX; tileX++) {
+                        const int64_t originX = static_cast<int64_t>(tileX) * settings.tileSize - settings.border;
+                        const int64_t originY = static_cast<int64_t>(tileY) * settings.tileSize - settings.border;
+                        CookTile(texture, level, originX, originY, paddedSize, settings.quality, tile.Data());
+                        file.write(reinterpret_cast<const char*>(tile.Data()), header.tileBytes);
+                    }
+                }
+            }
+
+            if (!file.good()) {
+                file.close();
+                std::remove(tempPath.c_str());
+                return false;
+            }
+        }
+
+        std::error_code error;
+        std::filesystem::rename(tempPath, path, error);
+        if (error) {
+            std::remove(tempPath.c_str());
+            return false;
+        }
+        return true;
+    }
+
+    // =====================
+    // Reading
+    // =====================
+
+    bool DSVirtualTexture::Open(const std::string& path) {
+        Close();
+
+        auto file = std::make_shared<DSMappedFile>();
+        if (!file->Open(path) || file->GetSize() < sizeof(VTHeader)) {
+            return false;
+        }
+
+        const uint8_t* data = file->GetData();
+        const size_t fileSize = file->GetSize();
+
+        VTHeader header;
+        std::memcpy(&header, data, sizeof(VTHeader));
+        const DSTexture::Format format = static_cast<DSTexture::Format>(header.format);
+        const uint32_t paddedSize = header.tileSize + 2 * header.border;
+        if (std::memcmp(header.magic, "DSVT", 4) != 0 || header.version != VT_VERSION ||
+            DSTexture::GetPixelSize(format) == 0 || header.tileSize == 0 || header.mipLevels == 0 ||
+            header.tileSize > MAX_PADDED_TILE_SIZE || header.border > MAX_PADDED_TILE_SIZE || paddedSize > MAX_PADDED_TILE_SIZE ||
+            (DSTexture::IsFormatCompressed(format) && paddedSize % 4 != 0) ||
+            header.tileBytes != DSTexture::CalculateMipSize(paddedSize, paddedSize, format)) {
+            return false;
+        }
+
+        const size_t tableEnd = sizeof(VTHeader) + static_cast<size_t>(header.mipLevels) * sizeof(VTMipInfo);
+        if (tableEnd > fileSize || header.dataOffset < tableEnd || header.dataOffset > fileSize ||
+            static_cast<uint64_t>(header.tileCount) * header.tileBytes > fileSize - header.dataOffset) {
+            return false;
+        }
+
+        // Validate the tile grids once so lookups can trust them
+        std::vector<VTMipInfo> mips(header.mipLevels);
+        std::memcpy(mips.data(), data + sizeof(VTHeader), mips.size() * sizeof(VTMipInfo));
+        uint64_t firstTile = 0;
+        for (const VTMipInfo& info : mips) {
+            if (info.width == 0 || info.height == 0 || info.firstTile != firstTile ||
+                info.tilesX != (info.width + header.tileSize - 1) / header.tileSize ||
+                info.tilesY != (info.height + header.tileSize - 1) / header.tileSize) {
+                return false;
+            }
+            firstTile += static_cast<uint64_t>(info.tilesX) * info.tilesY;
+        }
+        if (firstTile != header.tileCount || mips[0].width != header.width || mips[0].height != header.height) {
+            return false;
+        }
+
+        m_file = std::move(file);
+        m_mips = std::move(mips);
+        m_tiles = data + header.dataOffset;
+        m_format = format;
+        m_tileSize = header.tileSize;
+        m_border = header.border;
+        m_tileBytes = header.tileBytes;
+        return true;
+    }
+
+    void DSVirtualTexture::Close() {
+        m_file.reset();
+        m_mips.clear();
+        m_tiles = nullptr;
+        m_format = DSTexture::Format::UNKNOWN;
+        m_tileSize = 0;
+        m_border = 0;
+        m_tileBytes = 0;
+    }
+
+    const uint8_t* DSVirtualTexture::GetTile(uint32_t mip, uint32_t tileX, uint32_t tileY) const {
+        if (mip >= m_mips.size() || tileX >= m_mips[mip].tilesX || tileY >= m_mips[mip].tilesY) {
+            return nullptr;
+        }
+        const VTMipInfo& info = m_mips[mip];
+        const size_t index = info.firstTile + static_cast<size_t>(tileY) * info.tilesX + tileX;
+        return m_tiles + index * m_tileBytes;
+    }
+
+    // =====================
+    // Page cache
+    // =====================
+
+    DSVirtualTextureCache::DSVirtualTextureCache(const DSVirtualTexture& texture, uint32_t slotsX, uint32_t slotsY)
+        : m_texture(texture),
+          m_slotsX(std::min(std::max(slotsX, 1u), MAX_SLOTS_PER_AXIS)),
+          m_slotsY(std::min(std::max(slotsY, 1u), MAX_SLOTS_PER_AXIS)) {
+        const uint32_t paddedSize = texture.GetPaddedTileSize();
+        const uint32_t rowsPerTile = DSTexture::IsFormatCompressed(texture.GetFormat()) ? paddedSize / 4 : paddedSize;
+        if (rowsPerTile > 0) {
+            m_rowPitch = m_slotsX * (texture.GetTileBytes() / rowsPerTile);
+            m_atlas.resize(m_rowPitch * rowsPerTile * m_slotsY);
+        }
+
+        m_slots.resize(static_cast<size_t>(m_slotsX) * m_slotsY);
+        Clear();
+    }
+
+    void DSVirtualTextureCache::Clear() {
+        m_pageTables.clear();
+        for (uint32_t mip = 0; mip < m_texture.GetMipLevels(); mip++) {
+            m_pageTables.emplace_back(static_cast<size_t>(m_texture.GetTilesX(mip)) * m_texture.GetTilesY(mip), INVALID_PAGE);
+        }
+
+        // Every slot free and at the least recently used end
+        m_lruHead = m_lruTail = NO_SLOT;
+        for (uint32_t slot = 0; slot < m_slots.size(); slot++) {
+            m_slots[slot] = Slot();
+            LinkBack(slot);
+        }
+        m_queue.clear();
+        m_updatedSlots.clear();
+    }
+
+    bool DSVirtualTextureCache::Request(uint32_t mip, uint32_t tileX, uint32_t tileY) {
+        if (mip >= m_pageTables.size() || tileX >= m_texture.GetTilesX(mip) || tileY >= m_texture.GetTilesY(mip)) {
+            return false;
+        }
+        m_stats.requests++;
+
+        const uint32_t page = GetPage(mip, tileX, tileY);
+        if (page != INVALID_PAGE && GetPageMip(page) == mip) {
+            m_stats.hits++;
+            Touch(GetPageSlotY(page) * m_slotsX + GetPageSlotX(page));
+            return true;
+        }
+
+        m_queue.push_back({ mip, tileX, tileY });
+        return false;
+    }
+
+    bool DSVirtualTextureCache::RequestUV(float u, float v, uint32_t mip) {
+        if (mip >= m_pageTables.size()) {
+            return false;
+        }
+
+        // Clamp addressing, NaN ends up on the first tile
+        const float x = u * m_texture.GetWidth(mip) / m_texture.GetTileSize();
+        const float y = v * m_texture.GetHeight(mip) / m_texture.GetTileSize();
+        const uint32_t tileX = (x > 0.0f) ? std::min(static_cast<uint32_t>(std::min(x, 1e9f)), m_texture.GetTilesX(mip) - 1) : 0;
+        const uint32_t tileY = (y > 0.0f) ? std::min(static_cast<uint32_t>(std::min(y, 1e9f)), m_texture.GetTilesY(mip) - 1) : 0;
+        return Request(mip, tileX, tileY);
+    }
+
+    uint32_t DSVirtualTextureCache::Update(uint32_t maxLoads) {
+        m_updatedSlots.clear();
+
+        // Coarsest first so fallbacks exist before the detail, duplicates next to each other
+        std::sort(m_queue.begin(), m_queue.end(), [](const TileKey& a, const TileKey& b) {
+            if (a.mip != b.mip) return a.mip > b.mip;
+            if (a.y != b.y) return a.y < b.y;
+            return a.x < b.x;
+        });
+
+        uint32_t loaded = 0;
+        for (size_t i = 0; i < m_queue.size() && loaded < maxLoads; i++) {
+            const TileKey& tile = m_queue[i];
+            if (i > 0 && tile.mip == m_queue[i - 1].mip && tile.x == m_queue[i - 1].x && tile.y == m_queue[i - 1].y) {
+                continue;
+            }
+
+            // Everything in the atlas was used this frame
+            const uint32_t slot = m_lruHead;
+            if (slot == NO_SLOT || (m_slots[slot].used && m_slots[slot].lastUse == m_frame)) {
+                break;
+            }
+
+            if (m_slots[slot].used) {
+                Evict(slot);
+            }
+            Load(tile, slot);
+            loaded++;
+        }
+
+        // Requests that did not fit are made again by the next frame
+        m_queue.clear();
+        m_frame++;
+        return loaded;
+    }
+
+    bool DSVirtualTextureCache::IsResident(uint32_t mip, uint32_t tileX, uint32_t tileY) const {
+        const uint32_t page = GetPage(mip, tileX, tileY);
+        return page != INVALID_PAGE && GetPageMip(page) == mip;
+    }
+
+    uint32_t DSVirtualTextureCache::GetPage(uint32_t mip, uint32_t tileX, uint32_t tileY) const {
+        if (mip >= m_pageTables.size() || tileX >= m_texture.GetTilesX(mip) || tileY >= m_texture.GetTilesY(mip)) {
+            return INVALID_PAGE;
+        }
+        return m_pageTables[mip][static_cast<size_t>(tileY) * m_texture.GetTilesX(mip) + tileX];
+    }
+
+    void DSVirtualTextureCache::Touch(uint32_t slot) {
+        m_slots[slot].lastUse = m_frame;
+        Unlink(slot);
+        LinkBack(slot);
+    }
+
+    void DSVirtualTextureCache::Unlink(uint32_t slot) {
+        Slot& entry = m_slots[slot];
+        if (entry.prev != NO_SLOT) m_slots[entry.prev].next = entry.next;
+        else m_lruHead = entry.next;
+        if (entry.next != NO_SLOT) m_slots[entry.next].prev = entry.prev;
+        else m_lruTail = entry.prev;
+        entry.prev = entry.next = NO_SLOT;
+    }
+
+    void DSVirtualTextureCache::LinkBack(uint32_t slot) {
+        Slot& entry = m_slots[slot];
+        entry.prev = m_lruTail;
+        entry.next = NO_SLOT;
+        if (m_lruTail != NO_SLOT) m_slots[m_lruTail].next = slot;
+        else m_lruHead = slot;
+        m_lruTail = slot;
+    }
+
+    void DSVirtualTextureCache::Load(const TileKey& tile, uint32_t slot) {
+        const uint32_t slotX = slot % m_slotsX;
+        const uint32_t slotY = slot / m_slotsX;
+
+        // Copy the tile row by row (block row by block row) into its place in the atlas
+        const uint8_t* source = m_texture.GetTile(tile.mip, tile.x, tile.y);
+        const uint32_t paddedSize = m_texture.GetPaddedTileSize();
+        const uint32_t rows = DSTexture::IsFormatCompressed(m_texture.GetFormat()) ? paddedSize / 4 : paddedSize;
+        const size_t rowSize = m_texture.GetTileBytes() / rows;
+        uint8_t* dest = m_atlas.data() + static_cast<size_t>(slotY) * rows * m_rowPitch + slotX * rowSize;
+        for (uint32_t row = 0; row < rows; row++) {
+            std::memcpy(dest + row * m_rowPitch, source + row * rowSize, rowSize);
+        }
+
+        Slot& entry = m_slots[slot];
+        entry.tile = tile;
+        entry.used = true;
+        Touch(slot);
+
+        SetPages(tile, MakePage(slot, tile.mip), true, 0);
+        m_updatedSlots.push_back(slot);
+        m_stats.loads++;
+    }
+
+    void DSVirtualTextureCache::Evict(uint32_t slot) {
+        Slot& entry = m_slots[slot];
+        const TileKey tile = entry.tile;
+
+        // Pages that used this tile fall back to what covers the parent tile
+        uint32_t fallback = INVALID_PAGE;
+        if (tile.mip + 1 < m_pageTables.size()) {
+            const uint32_t parentX = std::min(tile.x / 2, m_texture.GetTilesX(tile.mip + 1) - 1);
+            const uint32_t parentY = std::min(tile.y / 2, m_texture.GetTilesY(tile.mip + 1) - 1);
+            fallback = GetPage(tile.mip + 1, parentX, parentY);
+        }
+        SetPages(tile, fallback, false, MakePage(slot, tile.mip));
+
+        entry.used = false;
+        m_stats.evictions++;
+    }
+
+    void DSVirtualTextureCache::SetPages(const TileKey& tile, uint32_t page, bool replaceCoarser, uint32_t match) {
+        for (uint32_t level = 0; level <= tile.mip; level++) {
+            // Tiles of a finer mip under this one, each mip down doubles the range
+            const uint32_t shift = tile.mip - level;
+            const uint32_t tilesX = m_texture.GetTilesX(level);
+            const uint32_t tilesY = m_texture.GetTilesY(level);
+            const uint32_t firstX = static_cast<uint32_t>(std::min<uint64_t>(static_cast<uint64_t>(tile.x) << shift, tilesX));
+            const uint32_t firstY = static_cast<uint32_t>(std::min<uint64_t>(static_cast<uint64_t>(tile.y) << shift, tilesY));
+            const uint32_t lastX = static_cast<uint32_t>(std::min<uint64_t>(static_cast<uint64_t>(tile.x + 1) << shift, tilesX));
+            const uint32_t lastY = static_cast<uint32_t>(std::min<uint64_t>(static_cast<uint64_t>(tile.y + 1) << shift, tilesY));
+
+            std::vector<uint32_t>& table = m_pageTables[level];
+            for (uint32_t y = firstY; y < lastY; y++) {
+                uint32_t* row = table.data() + static_cast<size_t>(y) * tilesX;
+                for (uint32_t x = firstX; x < lastX; x++) {
+                    // INVALID_PAGE has the highest mip bits, so it counts as the coarsest page
+                    const bool replace = replaceCoarser ? GetPageMip(row[x]) > tile.mip : row[x] == match;
+                    if (replace) row[x] = page;
+                }
+            }
+        }
+    }
+
+    uint32_t DSVirtualTextureCache::MakePage(uint32_t slot, uint32_t mip) const {
+        return (mip << 24) | ((slot / m_slotsX) << 12) | (slot % m_slotsX);
+    }
+}
@@ -0,0 +1,234 @@
+#pragma once
+#include "DSTexture.h"
+#include "DSMappedFile.h"
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace DSEngine {
+    /**
+     * Read-only tile file of a texture too large to keep in memory, for virtual texturing.
+     * Every mip is cut into tiles of tileSize texels, each stored with a border of clamped neighbouring texels
+     * so filtering inside the border never reads another tile. Mips stop at the first one that fits in one tile.
+     * Tiles all have the same size in the texture format and are read straight from the mapping
+     * (see DSVirtualTextureCache).
+     *
+     * Layout: VTHeader, VTMipInfo[mipLevels], padding, tiles from dataOffset ordered by mip, row and column.
+     */
+    class DSVirtualTexture {
+    public:
+        struct CookSettings {
+            uint32_t tileSize = 128;  // Texels of a tile without its border
+            uint32_t border = 4;      // Texels added on each side, tileSize + 2 * border must be a multiple of 4 for compressed formats
+            DSTexture::CompressionQuality quality = DSTexture::CompressionQuality::NORMAL;  // For compressed tiles on the texture edges
+        };
+
+        /**
+         * Cuts every resident mip of a texture into tiles and writes the tile file, to a temporary file first.
+         * Tiles keep the texture format. Compressed blocks are copied as they are when the tile lines up with them,
+         * tiles with a clamped border are decoded and encoded again. Generate the mips before cooking.
+         *
+         * @return false if a mip is not resident, the settings don't fit the format or the file can't be written.
+         */
+        static bool Cook(const DSTexture& texture, const std::string& path, const CookSettings& settings);
+
+        DSVirtualTexture() = default;
+
+        DSVirtualTexture(const DSVirtualTexture&) = delete;
+        DSVirtualTexture& operator=(const DSVirtualTexture&) = delete;
+
+        /**
+         * Maps a tile file and validates its header, closing any previous one.
+         *
+         * @return false if the file can't be mapped or is not a valid tile file.
+         */
+        bool Open(const std::string& path);
+        void Close();
+        bool IsOpen() const { return m_file != nullptr; }
+
+        DSTexture::Format GetFormat() const { return m_format; }
+        uint32_t GetMipLevels() const { return static_cast<uint32_t>(m_mips.size()); }
+        uint32_t GetWidth(uint32_t mip = 0) const { return mip < m_mips.size() ? m_mips[mip].width : 0; }
+        uint32_t GetHeight(uint32_t mip = 0) const { return mip < m_mips.size() ? m_mips[mip].height : 0; }
+        uint32_t GetTilesX(uint32_t mip) const { return mip < m_mips.size() ? m_mips[mip].tilesX : 0; }
+        uint32_t GetTilesY(uint32_t mip) const { return mip < m_mips.size() ? m_mips[mip].tilesY : 0; }
+        uint32_t GetTileSize() const { return m_tileSize; }
+        uint32_t GetBorder() const { return m_border; }
+        // Texels across a stored tile, border included
+        uint32_t GetPaddedTileSize() const { return m_tileSize + 2 * m_border; }
+        size_t GetTileBytes() const { return m_tileBytes; }
+
+        // The stored tile inside the mapping (rows of texels, or of 4x4 blocks when compressed), nullptr if out of range
+        const uint8_t* GetTile(uint32_t mip, uint32_t tileX, uint32_t tileY) const;
+
+    private:
+        static constexpr uint16_t VT_VERSION = 1;
+        static constexpr uint32_t DATA_ALIGNMENT = 4096;
+
+#pragma pack(push, 1)
+        struct VTHeader {
+            char magic[4] = {'D', 'S', 'V', 'T'};
+            uint16_t version = VT_VERSION;
+            uint16_t format = 0;
+            uint32_t width = 0;
+            uint32_t height = 0;
+            uint32_t mipLevels = 0;
+            uint32_t tileSize = 0;
+            uint32_t border = 0;
+            uint32_t tileBytes = 0;
+            uint32_t tileCount = 0;
+            uint32_t reserved = 0;
+            uint64_t dataOffset = 0;   // Aligned to DATA_ALIGNMENT
+        };
+
+        struct VTMipInfo {
+            uint32_t width;
+            uint32_t height;
+            uint32_t tilesX;
+            uint32_t tilesY;
+            uint32_t firstTile;        // Index of the first tile of the mip
+        };
+#pragma pack(pop)
+
+        // Mip sizes and tile grids of a cooked texture
+        static std::vector<VTMipInfo> GetMipInfos(const DSTexture& texture, uint32_t tileSize);
+        // Fills dest with the tile at a texel origin of a mip, which may start or end outside of it
+        static void CookTile(const DSTexture& texture, uint32_t level, int64_t originX, int64_t originY,
+                             uint32_t paddedSize, DSTexture::CompressionQuality quality, uint8_t* dest);
+
+        std::shared_ptr<DSMappedFile> m_file;
+        std::vector<VTMipInfo> m_mips;
+        const uint8_t* m_tiles = nullptr;
+        DSTexture::Format m_format = DSTexture::Format::UNKNOWN;
+        uint32_t m_tileSize = 0;
+        uint32_t m_border = 0;
+        size_t m_tileBytes = 0;
+    };
+
+    /**
+     * Page cache for a DSVirtualTexture: a physical atlas of a fixed number of tile slots, filled on request
+     * with least recently used replacement, and the indirection page table the shader reads.
+     * Memory stays the same however large the virtual texture is.
+     *
+     * Every frame, Request the tiles the view needs (from GPU feedback or a CPU estimate), then Update loads the
+     * missing ones, coarsest first. Tiles used in the current frame are never evicted, requests that don't fit
+     * have to be made again in a later frame. Pages without a resident tile point at the nearest resident coarser mip, so keep
+     * the last mip (a single tile) requested to always have something to sample.
+     *
+     * Page table entries: slot x in bits 0-11, slot y in bits 12-23, mip of the tile in the slot in bits 24-31,
+     * INVALID_PAGE when nothing covers the page. Loading or evicting a tile rewrites the entries of every finer
+     * page under it, which is 4^n entries for a tile n mips above the base.
+     * Not thread safe.
+     */
+    class DSVirtualTextureCache {
+    public:
+        static constexpr uint32_t INVALID_PAGE = 0xFFFFFFFFu;
+        static constexpr uint32_t MAX_SLOTS_PER_AXIS = 4096;
+
+        struct Stats {
+            uint64_t requests = 0;   // Request calls
+            uint64_t hits = 0;       // Requests for tiles already resident
+            uint64_t loads = 0;      // Tiles copied into the atlas
+            uint64_t evictions = 0;  // Tiles replaced
+        };
+
+        /**
+         * @param texture Open tile file, must outlive the cache.
+         * @param slotsX Tile slots across the atlas, at most MAX_SLOTS_PER_AXIS.
+         * @param slotsY Tile slots down the atlas.
+         */
+        DSVirtualTextureCache(const DSVirtualTexture& texture, uint32_t slotsX, uint32_t slotsY);
+
+        DSVirtualTextureCache(const DSVirtualTextureCache&) = delete;
+        DSVirtualTextureCache& operator=(const DSVirtualTextureCache&) = delete;
+
+        /**
+         * Marks a tile as used this frame and queues it if it is not resident.
+         *
+         * @return true if the tile is resident.
+         */
+        bool Request(uint32_t mip, uint32_t tileX, uint32_t tileY);
+
+        // Requests the tile under normalized coordinates, (0, 0) is the first texel of the mip
+        bool RequestUV(float u, float v, uint32_t mip);
+
+        /**
+         * Loads queued tiles coarsest first, then starts a new frame.
+         *
+         * @param maxLoads Cap on the tiles copied. Requests left over are dropped, make them again next frame.
+         * @return The number of tiles loaded.
+         */
+        uint32_t Update(uint32_t maxLoads = 0xFFFFFFFFu);
+
+        // Evicts every tile and resets the page table
+        void Clear();
+
+        bool IsResident(uint32_t mip, uint32_t tileX, uint32_t tileY) const;
+
+        // Page table of a mip, GetTilesX(mip) * GetTilesY(mip) entries row by row
+        const std::vector<uint32_t>& GetPageTable(uint32_t mip) const { return m_pageTables[mip]; }
+        uint32_t GetPage(uint32_t mip, uint32_t tileX, uint32_t tileY) const;
+
+        static uint32_t GetPageSlotX(uint32_t page) { return page & 0xFFF; }
+        static uint32_t GetPageSlotY(uint32_t page) { return (page >> 12) & 0xFFF; }
+        static uint32_t GetPageMip(uint32_t page) { return page >> 24; }
+
+        // Atlas in the texture format: slotsX * padded tile size texels across, rows of 4x4 blocks when compressed
+        const uint8_t* GetAtlasData() const { return m_atlas.data(); }
+        size_t GetAtlasSize() const { return m_atlas.size(); }
+        uint32_t GetAtlasWidth() const { return m_slotsX * m_texture.GetPaddedTileSize(); }
+        uint32_t GetAtlasHeight() const { return m_slotsY * m_texture.GetPaddedTileSize(); }
+        size_t GetAtlasRowPitch() const { return m_rowPitch; }
+        uint32_t GetSlotsX() const { return m_slotsX; }
+        uint32_t GetSlotsY() const { return m_slotsY; }
+
+        // Slots written by the last Update (slot y * slotsX + slot x), upload those parts of the atlas
+        const std::vector<uint32_t>& GetUpdatedSlots() const { return m_updatedSlots; }
+
+        const Stats& GetStats() const { return m_stats; }
+        void ResetStats() { m_stats = Stats(); }
+
+    private:
+        static constexpr uint32_t NO_SLOT = 0xFFFFFFFFu;
+
+        struct TileKey {
+            uint32_t mip;
+            uint32_t x;
+            uint32_t y;
+        };
+
+        // Slots form a list from the least to the most recently used
+        struct Slot {
+            TileKey tile;
+            bool used = false;
+            uint64_t lastUse = 0;
+            uint32_t prev = NO_SLOT;
+            uint32_t next = NO_SLOT;
+        };
+
+        void Touch(uint32_t slot);
+        void Unlink(uint32_t slot);
+        void LinkBack(uint32_t slot);
+        void Load(const TileKey& tile, uint32_t slot);
+        void Evict(uint32_t slot);
+        // Points the page of a tile and the finer pages under it that held `match` (or something coarser) at `page`
+        void SetPages(const TileKey& tile, uint32_t page, bool replaceCoarser, uint32_t match);
+        uint32_t MakePage(uint32_t slot, uint32_t mip) const;
+
+        const DSVirtualTexture& m_texture;
+        uint32_t m_slotsX;
+        uint32_t m_slotsY;
+        size_t m_rowPitch = 0;
+        std::vector<uint8_t> m_atlas;
+        std::vector<std::vector<uint32_t>> m_pageTables;
+        std::vector<Slot> m_slots;
+        uint32_t m_lruHead = NO_SLOT;
+        uint32_t m_lruTail = NO_SLOT;
+        std::vector<TileKey> m_queue;
+        std::vector<uint32_t> m_updatedSlots;
+        uint64_t m_frame = 1;
+        Stats m_stats;
+    };
+}
@@ -1,5 +1,322 @@
 #include "matrix4x4.h"
+#include "DSCpu.h"
 namespace DSEngine {
+    namespace {
+        void MultiplySSE(const Matrix4x4& a, const __m128* b, __m128* result) {
+            for (int i = 0; i < 4; ++i) {
+                result[i] = a.Transform(b[i]);
+            }
+        }
+
+        // Two result columns per 256-bit register: each column of a is broadcast to both halves,
+        // the sums keep the order of Transform
+        DS_TARGET("avx") void MultiplyAVX(const __m128* a, const __m128* b, __m128* result) {
+            const __m256 a0 = _mm256_broadcast_ps(&a[0]);
+            const __m256 a1 = _mm256_broadcast_ps(&a[1]);
+            const __m256 a2 = _mm256_broadcast_ps(&a[2]);
+            const __m256 a3 = _mm256_broadcast_ps(&a[3]);
+
+            for (int i = 0; i < 4; i += 2) {
+                const __m256 v = _mm256_loadu_ps(reinterpret_cast<const float*>(&b[i]));
+                __m256 sum = _mm256_mul_ps(a0, _mm256_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0)));
+                sum = _mm256_add_ps(sum, _mm256_mul_ps(a1, _mm256_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1))));
+                sum = _mm256_add_ps(sum, _mm256_mul_ps(a2, _mm256_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2))));
+                sum = _mm256_add_ps(sum, _mm256_mul_ps(a3, _mm256_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3))));
+                _mm256_storeu_ps(reinterpret_cast<float*>(&result[i]), sum);
+            }
+        }
+
+        // Checked once, products are too small to go through a Path like the texture kernels
+        const bool s_hasAVX = DSCpu::HasAVX();
+
+        template <int X, int Y, int Z, int W>
+        FORCE_INLINE __m128 Swizzle(__m128 v) {
+            return _mm_shuffle_ps(v, v, _MM_SHUFFLE(W, Z, Y, X));
+        }
+
+        template <int X, int Y, int Z, int W>
+        FORCE_INLINE __m128 Shuffle(__m128 a, __m128 b) {
+            return _mm_shuffle_ps(a, b, _MM_SHUFFLE(W, Z, Y, X));
+        }
+
+        // 2x2 blocks are held as (m00, m01, m10, m11), rows first
+        // A * B
+        FORCE_INLINE __m128 Mat2Mul(__m128 a, __m128 b) {
+            return _mm_add_ps(_mm_mul_ps(a, Swizzle<0, 3, 0, 3>(b)),
+                              _mm_mul_ps(Swizzle<1, 0, 3, 2>(a), Swizzle<2, 1, 2, 1>(b)));
+        }
+
+        // adj(A) * B
+        FORCE_INLINE __m128 Mat2AdjMul(__m128 a, __m128 b) {
+            return _mm_sub_ps(_mm_mul_ps(Swizzle<3, 3, 0, 0>(a), b),
+                              _mm_mul_ps(Swizzle<1, 1, 2, 2>(a), Swizzle<2, 3, 0, 1>(b)));
+        }
+
+        // A * adj(B)
+        FORCE_INLINE __m128 Mat2MulAdj(__m128 a, __m128 b) {
+            return _mm_sub_ps(_mm_mul_ps(a, Swizzle<3, 0, 3, 0>(b)),
+                              _mm_mul_ps(Swizzle<1, 0, 3, 2>(a), Swizzle<2, 1, 2, 1>(b)));
+        }
+
+        /**
+         * The matrix split in 2x2 blocks | A B |, with the pieces the determinant and the inverse share.
+         *                                | C D |
+         * The inverse of the transpose is the transpose of the inverse, so columns can be taken as rows.
+         */
+        struct Blocks {
+            __m128 a, b, c, d;
+            __m128 detA, detB, detC, detD;
+            __m128 adjAB;   // adj(A) * B
+            __m128 adjDC;   // adj(D) * C
+            __m128 det;     // Determinant of the matrix in every lane
+        };
+
+        FORCE_INLINE Blocks SplitBlocks(const __m128* rows) {
+            Blocks blocks;
+            blocks.a = _mm_movelh_ps(rows[0], rows[1]);
+            blocks.b = _mm_movehl_ps(rows[1], rows[0]);
+            blocks.c = _mm_movelh_ps(rows[2], rows[3]);
+            blocks.d = _mm_movehl_ps(rows[3], rows[2]);
+
+            // (|A|, |B|, |C|, |D|)
+            const __m128 detSub = _mm_sub_ps(
+                _mm_mul_ps(Shuffle<0, 2, 0, 2>(rows[0], rows[2]), Shuffle<1, 3, 1, 3>(rows[1], rows[3])),
+                _mm_mul_ps(Shuffle<1, 3, 1, 3>(rows[0], rows[2]), Shuffle<0, 2, 0, 2>(rows[1], rows[3])));
+            blocks.detA = Swizzle<0, 0, 0, 0>(detSub);
+            blocks.detB = Swizzle<1, 1, 1, 1>(detSub);
+            blocks.detC = Swizzle<2, 2, 2, 2>(detSub);
+            blocks.detD = Swizzle<3, 3, 3, 3>(detSub);
+
+            blocks.adjDC = Mat2AdjMul(blocks.d, blocks.c);
+            blocks.adjAB = Mat2AdjMul(blocks.a, blocks.b);
+
+            // |M| = |A||D| + |B||C| - tr(adj(A) B adj(D) C), the trace summed with SSE2 shuffles
+            __m128 trace = _mm_mul_ps(blocks.adjAB, Swizzle<0, 2, 1, 3>(blocks.adjDC));
+            trace = _mm_add_ps(trace, Swizzle<2, 3, 0, 1>(trace));
+            trace = _mm_add_ps(trace, Swizzle<1, 0, 3, 2>(trace));
+            blocks.det = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(blocks.detA, blocks.detD), _mm_mul_ps(blocks.detB, blocks.detC)), trace);
+            return blocks;
+        }
+
+        // Batched transforms: directions skip the translation, points add it and divide by w when projecting
+        enum class TransformMode {
+            Direction,
+            AffinePoint,
+            ProjectivePoint
+        };
+
+        // Same operation order as Transform, so every path gives the same bits
+        template <TransformMode MODE>
+        FORCE_INLINE void TransformScalar(const Matrix4x4& matrix, float& x, float& y, float& z) {
+            const float (&m)[4][4] = matrix.m;
+            float rx = m[0][0] * x + m[1][0] * y + m[2][0] * z;
+            float ry = m[0][1] * x + m[1][1] * y + m[2][1] * z;
+            float rz = m[0][2] * x + m[1][2] * y + m[2][2] * z;
+            if (MODE != TransformMode::Direction) {
+                rx += m[3][0];
+                ry += m[3][1];
+                rz += m[3][2];
+            }
+            if (MODE == TransformMode::ProjectivePoint) {
+                const float w = m[0][3] * x + m[1][3] * y + m[2][3] * z + m[3][3];
+                rx /= w;
+                ry /= w;
+                rz /= w;
+            }
+            x = rx;
+            y = ry;
+            z = rz;
+        }
+
+        template <TransformMode MODE>
+        FORCE_INLINE void TransformSSE(const __m128 (&e)[4][4], __m128& x, __m128& y, __m128& z) {
+            __m128 rx = _mm_add_ps(_mm_add_ps(_mm_mul_ps(e[0][0], x), _mm_mul_ps(e[1][0], y)), _mm_mul_ps(e[2][0], z));
+            __m128 ry = _mm_add_ps(_mm_add_ps(_mm_mul_ps(e[0][1], x), _mm_mul_ps(e[1][1], y)), _mm_mul_ps(e[2][1], z));
+            __m128 rz = _mm_add_ps(_mm_add_ps(_mm_mul_ps(e[0][2], x), _mm_mul_ps(e[1][2], y)), _mm_mul_ps(e[2][2], z));
+            if (MODE != TransformMode::Direction) {
+                rx = _mm_add_ps(rx, e[3][0]);
+                ry = _mm_add_ps(ry, e[3][1]);
+                rz = _mm_add_ps(rz, e[3][2]);
+            }
+            if (MODE == TransformMode::ProjectivePoint) {
+                __m128 w = _mm_add_ps(_mm_add_ps(_mm_mul_ps(e[0][3], x), _mm_mul_ps(e[1][3], y)), _mm_mul_ps(e[2][3], z));
+                w = _mm_add_ps(w, e[3][3]);
+                rx = _mm_div_ps(rx, w);
+                ry = _mm_div_ps(ry, w);
+                rz = _mm_div_ps(rz, w);
+            }
+            x = rx;
+            y = ry;
+            z = rz;
+        }
+
+        template <TransformMode MODE>
+        void TransformSoASSE(const Matrix4x4& matrix, const float* x, const float* y, const float* z,
+                             float* destX, float* destY, float* destZ, size_t count) {
+            __m128 e[4][4];
+            for (int column = 0; column < 4; column++) {
+                for (int row = 0; row < 4; row++) e[column][row] = _mm_set1_ps(matrix.m[column][row]);
+            }
+
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4) {
+                __m128 vx = _mm_loadu_ps(x + i), vy = _mm_loadu_ps(y + i), vz = _mm_loadu_ps(z + i);
+                TransformSSE<MODE>(e, vx, vy, vz);
+                _mm_storeu_ps(destX + i, vx);
+                _mm_storeu_ps(destY + i, vy);
+                _mm_storeu_ps(destZ + i, vz);
+            }
+            for (; i < count; i++) {
+                float vx = x[i], vy = y[i], vz = z[i];
+                TransformScalar<MODE>(matrix, vx, vy, vz);
+                destX[i] = vx;
+                destY[i] = vy;
+                destZ[i] = vz;
+            }
+        }
+
+        // 4 packed Vector3 are 3 registers: (x0 y0 z0 x1) (y1 z1 x2 y2) (z2 x3 y3 z3). The shuffles stay inside
+        // 128-bit lanes, so the AVX version runs the same ones on two groups of 4.
+        template <TransformMode MODE>
+        void TransformAoSSSE(const Matrix4x4& matrix, const Vector3* src, Vector3* dest, size_t count) {
+            __m128 e[4][4];
+            for (int column = 0; column < 4; column++) {
+                for (int row = 0; row < 4; row++) e[column][row] = _mm_set1_ps(matrix.m[column][row]);
+            }
+
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4) {
+                const float* in = &src[i].x;
+                const __m128 m03 = _mm_loadu_ps(in);
+                const __m128 m14 = _mm_loadu_ps(in + 4);
+                const __m128 m25 = _mm_loadu_ps(in + 8);
+                const __m128 xy = _mm_shuffle_ps(m14, m25, _MM_SHUFFLE(2, 1, 3, 2));
+                const __m128 yz = _mm_shuffle_ps(m03, m14, _MM_SHUFFLE(1, 0, 2, 1));
+                __m128 x = _mm_shuffle_ps(m03, xy, _MM_SHUFFLE(2, 0, 3, 0));
+                __m128 y = _mm_shuffle_ps(yz, xy, _MM_SHUFFLE(3, 1, 2, 0));
+                __m128 z = _mm_shuffle_ps(yz, m25, _MM_SHUFFLE(3, 0, 3, 1));
+
+                TransformSSE<MODE>(e, x, y, z);
+
+                const __m128 rxy = _mm_shuffle_ps(x, y, _MM_SHUFFLE(2, 0, 2, 0));
+                const __m128 ryz = _mm_shuffle_ps(y, z, _MM_SHUFFLE(3, 1, 3, 1));
+                const __m128 rzx = _mm_shuffle_ps(z, x, _MM_SHUFFLE(3, 1, 2, 0));
+                float* out = &dest[i].x;
+                _mm_storeu_ps(out, _mm_shuffle_ps(rxy, rzx, _MM_SHUFFLE(2, 0, 2, 0)));
+                _mm_storeu_ps(out + 4, _mm_shuffle_ps(ryz, rxy, _MM_SHUFFLE(3, 1, 2, 0)));
+                _mm_storeu_ps(out + 8, _mm_shuffle_ps(rzx, ryz, _MM_SHUFFLE(3, 1, 3, 1)));
+            }
+            for (; i < count; i++) {
+                Vector3 v = src[i];
+                TransformScalar<MODE>(matrix, v.x, v.y, v.z);
+                dest[i] = v;
+            }
+        }
+
+        template <TransformMode MODE>
+        DS_TARGET("avx") void TransformAVX(const __m256 (&e)[4][4], __m256& x, __m256& y, __m256& z) {
+            __m256 rx = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(e[0][0], x), _mm256_mul_ps(e[1][0], y)), _mm256_mul_ps(e[2][0], z));
+            __m256 ry = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(e[0][1], x), _mm256_mul_ps(e[1][1], y)), _mm256_mul_ps(e[2][1], z));
+            __m256 rz = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(e[0][2], x), _mm256_mul_ps(e[1][2], y)), _mm256_mul_ps(e[2][2], z));
+            if (MODE != TransformMode::Direction) {
+                rx = _mm256_add_ps(rx, e[3][0]);
+                ry = _mm256_add_ps(ry, e[3][1]);
+                rz = _mm256_add_ps(rz, e[3][2]);
+            }
+            if (MODE == TransformMode::ProjectivePoint) {
+                __m256 w = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(e[0][3], x), _mm256_mul_ps(e[1][3], y)), _mm256_mul_ps(e[2][3], z));
+                w = _mm256_add_ps(w, e[3][3]);
+                rx = _mm256_div_ps(rx, w);
+                ry = _mm256_div_ps(ry, w);
+                rz = _mm256_div_ps(rz, w);
+            }
+            x = rx;
+            y = ry;
+            z = rz;
+        }
+
+        // Whole groups of 8 only, the caller finishes with the SSE version
+        template <TransformMode MODE>
+        DS_TARGET("avx") void TransformSoAAVX(const Matrix4x4& matrix, const float* x, const float* y, const float* z,
+                                              float* destX, float* destY, float* destZ, size_t count) {
+            __m256 e[4][4];
+            for (int column = 0; column < 4; column++) {
+                for (int row = 0; row < 4; row++) e[column][row] = _mm256_set1_ps(matrix.m[column][row]);
+            }
+
+            for (size_t i = 0; i + 8 <= count; i += 8) {
+                __m256 vx = _mm256_loadu_ps(x + i), vy = _mm256_loadu_ps(y + i), vz = _mm256_loadu_ps(z + i);
+                TransformAVX<MODE>(e, vx, vy, vz);
+                _mm256_storeu_ps(destX + i, vx);
+                _mm256_storeu_ps(destY + i, vy);
+                _mm256_storeu_ps(destZ + i, vz);
+            }
+        }
+
+        template <TransformMode MODE>
+        DS_TARGET("avx") void TransformAoSAVX(const Matrix4x4& matrix, const Vector3* src, Vector3* dest, size_t count) {
+            __m256 e[4][4];
+            for (int column = 0; column < 4; column++) {
+                for (int row = 0; row < 4; row++) e[column][row] = _mm256_set1_ps(matrix.m[column][row]);
+            }
+
+            for (size_t i = 0; i + 8 <= count; i += 8) {
+                // Points 0-3 in the low lanes, 4-7 in the high lanes
+                const float* in = &src[i].x;
+                const __m256 m03 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(in)), _mm_loadu_ps(in + 12), 1);
+                const __m256 m14 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(in + 4)), _mm_loadu_ps(in + 16), 1);
+                const __m256 m25 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(in + 8)), _mm_loadu_ps(in + 20), 1);
+                const __m256 xy = _mm256_shuffle_ps(m14, m25, _MM_SHUFFLE(2, 1, 3, 2));
+                const __m256 yz = _mm256_shuffle_ps(m03, m14, _MM_SHUFFLE(1, 0, 2, 1));
+                __m256 x = _mm256_shuffle_ps(m03, xy, _MM_SHUFFLE(2, 0, 3, 0));
+                __m256 y = _mm256_shuffle_ps(yz, xy, _MM_SHUFFLE(3, 1, 2, 0));
+                __m256 z = _mm256_shuffle_ps(yz, m25, _MM_SHUFFLE(3, 0, 3, 1));
+
+                TransformAVX<MODE>(e, x, y, z);
+
+                const __m256 rxy = _mm256_shuffle_ps(x, y, _MM_SHUFFLE(2, 0, 2, 0));
+                const __m256 ryz = _mm256_shuffle_ps(y, z, _MM_SHUFFLE(3, 1, 3, 1));
+                const __m256 rzx = _mm256_shuffle_ps(z, x, _MM_SHUFFLE(3, 1, 2, 0));
+                const __m256 r03 = _mm256_shuffle_ps(rxy, rzx, _MM_SHUFFLE(2, 0, 2, 0));
+                const __m256 r14 = _mm256_shuffle_ps(ryz, rxy, _MM_SHUFFLE(3, 1, 2, 0));
+                const __m256 r25 = _mm256_shuffle_ps(rzx, ryz, _MM_SHUFFLE(3, 1, 3, 1));
+                float* out = &dest[i].x;
+                _mm_storeu_ps(out, _mm256_castps256_ps128(r03));
+                _mm_storeu_ps(out + 4, _mm256_castps256_ps128(r14));
+                _mm_storeu_ps(out + 8, _mm256_castps256_ps128(r25));
+                _mm_storeu_ps(out + 12, _mm256_extractf128_ps(r03, 1));
+                _mm_storeu_ps(out + 16, _mm256_extractf128_ps(r14, 1));
+                _mm_storeu_ps(out + 20, _mm256_extractf128_ps(r25, 1));
+            }
+        }
+
+        template <TransformMode MODE>
+        void TransformSoA(const Matrix4x4& matrix, const float* x, const float* y, const float* z,
+                          float* destX, float* destY, float* destZ, size_t count) {
+            size_t done = 0;
+            if (s_hasAVX) {
+                done = count / 8 * 8;
+                TransformSoAAVX<MODE>(matrix, x, y, z, destX, destY, destZ, done);
+            }
+            TransformSoASSE<MODE>(matrix, x + done, y + done, z + done, destX + done, destY + done, destZ + done, count - done);
+        }
+
+        template <TransformMode MODE>
+        void TransformAoS(const Matrix4x4& matrix, const Vector3* src, Vector3* dest, size_t count) {
+            size_t done = 0;
+            if (s_hasAVX) {
+                done = count / 8 * 8;
+                TransformAoSAVX<MODE>(matrix, src, dest, done);
+            }
+            TransformAoSSSE<MODE>(matrix, src + done, dest + done, count - done);
+        }
+
+        FORCE_INLINE float Dot3(__m128 a, __m128 b) {
+            const __m128 product = _mm_mul_ps(a, b);
+            return _mm_cvtss_f32(_mm_add_ss(_mm_add_ss(product, Swizzle<1, 1, 1, 1>(product)), Swizzle<2, 2, 2, 2>(product)));
+        }
+    }
+
     // Constructors
     Matrix4x4::Matrix4x4() {
         SetIdentity();
@@ -37,31 +354,49 @@ namespace DSEngine {
     // Matrix multiplication
     Matrix4x4 Matrix4x4::operator*(const Matrix4x4& other) const {
         Matrix4x4 result;
-        for (int i = 0; i < 4; ++i) {
-            for (int j = 0; j < 4; ++j) {
-                result.m[i][j] =
-                    m[0][j] * other.m[i][0] +
-                    m[1][j] * other.m[i][1] +
-                    m[2][j] * other.m[i][2] +
-                    m[3][j] * other.m[i][3];
-            }
+        if (s_hasAVX) {
+            MultiplyAVX(simd, other.simd, result.simd);
+        } else {
+            MultiplySSE(*this, other.simd, result.simd);
         }
         return result;
     }
 
     // Vector transformation
-    Vector4 Matrix4x4::operator*(const Vector4& vec) const {
-        return Vector4(
-            columns[0].x * vec.x + columns[1].x * vec.y + columns[2].x * vec.z + columns[3].x * vec.w,
-            columns[0].y * vec.x + columns[1].y * vec.y + columns[2].y * vec.z + columns[3].y * vec.w,
-            columns[0].z * vec.x + columns[1].z * vec.y + columns[2].z * vec.z + columns[3].z * vec.w,
-            columns[0].w * vec.x + columns[1].w * vec.y + columns[2].w * vec.z + columns[3].w * vec.w
-        );
+    Vector3 Matrix4x4::operator*(const Vector3& vec) const {
+        __m128 result = Transform(_mm_setr_ps(vec.x, vec.y, vec.z, 1.0f));
+        result = _mm_div_ps(result, _mm_shuffle_ps(result, result, _MM_SHUFFLE(3, 3, 3, 3)));
+
+        alignas(16) float xyzw[4];
+        _mm_store_ps(xyzw, result);
+        return Vector3(xyzw[0], xyzw[1], xyzw[2]);
     }
 
-    Vector3 Matrix4x4::operator*(const Vector3& vec) const {
-        Vector4 result = *this * Vector4(vec, 1.0f);
-        return result.XYZ() / result.w;
+    // Batched transforms
+    void Matrix4x4::TransformPoints(const Vector3* src, Vector3* dest, size_t count) const {
+        if (IsAffine()) {
+            TransformAoS<TransformMode::AffinePoint>(*this, src, dest, count);
+        } else {
+            TransformAoS<TransformMode::ProjectivePoint>(*this, src, dest, count);
+        }
+    }
+
+    void Matrix4x4::TransformDirections(const Vector3* src, Vector3* dest, size_t count) const {
+        TransformAoS<TransformMode::Direction>(*this, src, dest, count);
+    }
+
+    void Matrix4x4::TransformPoints(const float* x, const float* y, const float* z,
+                                    float* destX, float* destY, float* destZ, size_t count) const {
+        if (IsAffine()) {
+            TransformSoA<TransformMode::AffinePoint>(*this, x, y, z, destX, destY, destZ, count);
+        } else {
+            TransformSoA<TransformMode::ProjectivePoint>(*this, x, y, z, destX, destY, destZ, count);
+        }
+    }
+
+    void Matrix4x4::TransformDirections(const float* x, const float* y, const float* z,
+                                        float* destX, float* destY, float* destZ, size_t count) const {
+        TransformSoA<TransformMode::Direction>(*this, x, y, z, destX, destY, destZ, count);
     }
 
     // Transformation matrices
@@ -101,6 +436,46 @@ namespace DSEngine {
         return result;
     }
 
+    void Matrix4x4::Rotate(const Quaternion* rotations, Matrix4x4* dest, size_t count) {
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 two = _mm_set1_ps(2.0f);
+
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4) {
+            // x, y, z and w of 4 quaternions, then the terms of Rotate for all of them
+            __m128 x = _mm_loadu_ps(rotations[i].data), y = _mm_loadu_ps(rotations[i + 1].data);
+            __m128 z = _mm_loadu_ps(rotations[i + 2].data), w = _mm_loadu_ps(rotations[i + 3].data);
+            _MM_TRANSPOSE4_PS(x, y, z, w);
+
+            const __m128 xx = _mm_mul_ps(x, x), yy = _mm_mul_ps(y, y), zz = _mm_mul_ps(z, z);
+            const __m128 xy = _mm_mul_ps(x, y), xz = _mm_mul_ps(x, z), yz = _mm_mul_ps(y, z);
+            const __m128 wx = _mm_mul_ps(w, x), wy = _mm_mul_ps(w, y), wz = _mm_mul_ps(w, z);
+
+            __m128 columns[3][4] = {
+                { _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, zz))), _mm_mul_ps(two, _mm_add_ps(xy, wz)),
+                  _mm_mul_ps(two, _mm_sub_ps(xz, wy)), _mm_setzero_ps() },
+                { _mm_mul_ps(two, _mm_sub_ps(xy, wz)), _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, zz))),
+                  _mm_mul_ps(two, _mm_add_ps(yz, wx)), _mm_setzero_ps() },
+                { _mm_mul_ps(two, _mm_add_ps(xz, wy)), _mm_mul_ps(two, _mm_sub_ps(yz, wx)),
+                  _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, yy))), _mm_setzero_ps() }
+            };
+            // Back to one column of each matrix per register
+            for (int column = 0; column < 3; column++) {
+                __m128 (&c)[4] = columns[column];
+                _MM_TRANSPOSE4_PS(c[0], c[1], c[2], c[3]);
+                for (int matrix = 0; matrix < 4; matrix++) {
+                    dest[i + matrix].simd[column] = c[matrix];
+                }
+            }
+            for (int matrix = 0; matrix < 4; matrix++) {
+                dest[i + matrix].simd[3] = _mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f);
+            }
+        }
+        for (; i < count; i++) {
+            dest[i] = Rotate(rotations[i]);
+        }
+    }
+
     Matrix4x4 Matrix4x4::Scale(const Vector3& scale) {
         Matrix4x4 result(1.0f);
         result.m[0][0] = scale.x;
@@ -179,24 +554,72 @@ namespace DSEngine {
     // Matrix operations
     Matrix4x4 Matrix4x4::Transposed() const {
         Matrix4x4 result;
-        for (int i = 0; i < 4; ++i) {
-            for (int j = 0; j < 4; ++j) {
-                result.m[i][j] = m[j][i];
-            }
-        }
+        __m128 col0 = simd[0], col1 = simd[1], col2 = simd[2], col3 = simd[3];
+        _MM_TRANSPOSE4_PS(col0, col1, col2, col3);
+        result.simd[0] = col0;
+        result.simd[1] = col1;
+        result.simd[2] = col2;
+        result.simd[3] = col3;
         return result;
     }
 
     float Matrix4x4::Determinant() const {
-        // Implementation of 4x4 determinant calculation
-        // (Omitted for brevity but should be implemented)
-        return 0.0f;
+        return _mm_cvtss_f32(SplitBlocks(simd).det);
     }
 
     Matrix4x4 Matrix4x4::Inversed() const {
-        // Implementation of matrix inversion
-        // (Omitted for brevity but should be implemented)
-        return Matrix4x4::Identity();
+        const Blocks blocks = SplitBlocks(simd);
+        const float det = _mm_cvtss_f32(blocks.det);
+        if (det == 0.0f || !std::isfinite(det)) {
+            return Matrix4x4::Identity();
+        }
+
+        // M^-1 = 1/|M| * | X Y |, built from the adjugates of the blocks
+        //                | Z W |
+        // adj(X) = |D|A - B adj(D)C, adj(W) = |A|D - C adj(A)B
+        __m128 x = _mm_sub_ps(_mm_mul_ps(blocks.detD, blocks.a), Mat2Mul(blocks.b, blocks.adjDC));
+        __m128 w = _mm_sub_ps(_mm_mul_ps(blocks.detA, blocks.d), Mat2Mul(blocks.c, blocks.adjAB));
+        // adj(Y) = |B|C - D adj(adj(A)B), adj(Z) = |C|B - A adj(adj(D)C)
+        __m128 y = _mm_sub_ps(_mm_mul_ps(blocks.detB, blocks.c), Mat2MulAdj(blocks.d, blocks.adjAB));
+        __m128 z = _mm_sub_ps(_mm_mul_ps(blocks.detC, blocks.b), Mat2MulAdj(blocks.a, blocks.adjDC));
+
+        // The sign pattern of the adjugate folded into the reciprocal
+        const __m128 reciprocal = _mm_div_ps(_mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f), blocks.det);
+        x = _mm_mul_ps(x, reciprocal);
+        y = _mm_mul_ps(y, reciprocal);
+        z = _mm_mul_ps(z, reciprocal);
+        w = _mm_mul_ps(w, reciprocal);
+
+        // Undo the adjugates while storing
+        Matrix4x4 result;
+        result.simd[0] = Shuffle<3, 1, 3, 1>(x, y);
+        result.simd[1] = Shuffle<2, 0, 2, 0>(x, y);
+        result.simd[2] = Shuffle<3, 1, 3, 1>(z, w);
+        result.simd[3] = Shuffle<2, 0, 2, 0>(z, w);
+        return result;
+    }
+
+    Matrix4x4 Matrix4x4::InversedAffine() const {
+        // The rows of the 3x3 part, each scaled by the inverse squared length of its column: R^T S^-2 undoes R S
+        __m128 row0 = simd[0], row1 = simd[1], row2 = simd[2], row3 = _mm_setzero_ps();
+        _MM_TRANSPOSE4_PS(row0, row1, row2, row3);
+
+        const __m128 lengthSquared = _mm_add_ps(_mm_add_ps(_mm_mul_ps(row0, row0), _mm_mul_ps(row1, row1)), _mm_mul_ps(row2, row2));
+        const __m128 nonZero = _mm_cmpgt_ps(lengthSquared, _mm_setzero_ps());
+        const __m128 scale = _mm_and_ps(_mm_div_ps(_mm_set1_ps(1.0f), lengthSquared), nonZero);
+
+        Matrix4x4 result;
+        result.simd[0] = _mm_mul_ps(row0, scale);
+        result.simd[1] = _mm_mul_ps(row1, scale);
+        result.simd[2] = _mm_mul_ps(row2, scale);
+
+        // -(M^-1 t), with w set to 1
+        const __m128 translation = simd[3];
+        __m128 inverseTranslation = _mm_mul_ps(result.simd[0], Swizzle<0, 0, 0, 0>(translation));
+        inverseTranslation = _mm_add_ps(inverseTranslation, _mm_mul_ps(result.simd[1], Swizzle<1, 1, 1, 1>(translation)));
+        inverseTranslation = _mm_add_ps(inverseTranslation, _mm_mul_ps(result.simd[2], Swizzle<2, 2, 2, 2>(translation)));
+        result.simd[3] = _mm_sub_ps(_mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f), inverseTranslation);
+        return result;
     }
 
     // Utility
@@ -219,11 +642,58 @@ namespace DSEngine {
         return true;
     }
 
+    bool Matrix4x4::IsAffine() const {
+        return m[0][3] == 0.0f && m[1][3] == 0.0f && m[2][3] == 0.0f && m[3][3] == 1.0f;
+    }
+
     bool Matrix4x4::Decompose(Vector3& translation,
                              Quaternion& rotation,
                              Vector3& scale) const {
-        // Implementation of matrix decomposition
-        // (Omitted for brevity but should be implemented)
-        return false;
+        translation = Vector3(m[3][0], m[3][1], m[3][2]);
+
+        // Projections have no TRS form
+        if (m[0][3] != 0.0f || m[1][3] != 0.0f || m[2][3] != 0.0f || m[3][3] != 1.0f) {
+            return false;
+        }
+
+        scale = Vector3(Mathf::Sqrt(Dot3(simd[0], simd[0])),
+                        Mathf::Sqrt(Dot3(simd[1], simd[1])),
+                        Mathf::Sqrt(Dot3(simd[2], simd[2])));
+        if (scale.x == 0.0f || scale.y == 0.0f || scale.z == 0.0f) {
+            rotation = Quaternion::identity;
+            return false;
+        }
+
+        // A mirrored basis is a rotation with a negative scale, kept on x
+        const __m128 cross = _mm_sub_ps(
+            _mm_mul_ps(Swizzle<1, 2, 0, 3>(simd[1]), Swizzle<2, 0, 1, 3>(simd[2])),
+            _mm_mul_ps(Swizzle<2, 0, 1, 3>(simd[1]), Swizzle<1, 2, 0, 3>(simd[2])));
+        if (Dot3(simd[0], cross) < 0.0f) {
+            scale.x = -scale.x;
+        }
+
+        // Rotation matrix columns
+        alignas(16) float r[3][4];
+        _mm_store_ps(r[0], _mm_div_ps(simd[0], _mm_set1_ps(scale.x)));
+        _mm_store_ps(r[1], _mm_div_ps(simd[1], _mm_set1_ps(scale.y)));
+        _mm_store_ps(r[2], _mm_div_ps(simd[2], _mm_set1_ps(scale.z)));
+
+        // Inverse of Rotate, from the largest of w, x, y and z so the division stays accurate
+        const float trace = r[0][0] + r[1][1] + r[2][2];
+        if (trace > 0.0f) {
+            const float s = Mathf::Sqrt(trace + 1.0f) * 2.0f;
+            rotation = Quaternion((r[1][2] - r[2][1]) / s, (r[2][0] - r[0][2]) / s, (r[0][1] - r[1][0]) / s, 0.25f * s);
+        } else if (r[0][0] > r[1][1] && r[0][0] > r[2][2]) {
+            const float s = Mathf::Sqrt(1.0f + r[0][0] - r[1][1] - r[2][2]) * 2.0f;
+            rotation = Quaternion(0.25f * s, (r[1][0] + r[0][1]) / s, (r[2][0] + r[0][2]) / s, (r[1][2] - r[2][1]) / s);
+        } else if (r[1][1] > r[2][2]) {
+            const float s = Mathf::Sqrt(1.0f + r[1][1] - r[0][0] - r[2][2]) * 2.0f;
+            rotation = Quaternion((r[1][0] + r[0][1]) / s, 0.25f * s, (r[2][1] + r[1][2]) / s, (r[2][0] - r[0][2]) / s);
+        } else {
+            const float s = Mathf::Sqrt(1.0f + r[2][2] - r[0][0] - r[1][1]) * 2.0f;
+            rotation = Quaternion((r[2][0] + r[0][2]) / s, (r[2][1] + r[1][2]) / s, 0.25f * s, (r[0][1] - r[1][0]) / s);
+        }
+        rotation = rotation.Normalized();
+        return true;
     }
 }
\ No newline at end of file
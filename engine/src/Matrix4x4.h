@@ -2,15 +2,20 @@
 #include "Vector3.h"
 #include "Vector4.h"
 #include "Quaternion.h"
+#include "DSMath.h"
 #include <array>
+#include <cstddef>
 #include <cmath>
 namespace DSEngine {
-    struct Matrix4x4 {
+    // Products and transforms use SSE (AVX for matrix products when the CPU has it),
+    // with the same operation order as the scalar code so results do not depend on the path.
+    struct ALIGNED_(16) Matrix4x4 {
         // Column-major storage (compatible with OpenGL/Vulkan)
         union {
             float m[4][4];          // [column][row]
             float data[16];         // Linear array
             Vector4 columns[4];     // Column vectors
+            __m128 simd[4];         // Column vectors as SSE registers
         };
 
         // Constructors
@@ -28,12 +33,37 @@ namespace DSEngine {
 
         // Matrix operations
         Matrix4x4 operator*(const Matrix4x4& other) const;
-        Vector4 operator*(const Vector4& vec) const;
+        FORCE_INLINE Vector4 operator*(const Vector4& vec) const {
+            Vector4 result;
+            _mm_storeu_ps(&result.x, Transform(_mm_loadu_ps(&vec.x)));
+            return result;
+        }
         Vector3 operator*(const Vector3& vec) const;
 
+        // Batched transforms, 8 vectors at a time with AVX, 4 with SSE. dest may be the source.
+        // Points match operator*(Vector3) bit for bit and are only divided by w when the matrix is not affine.
+        // Directions use the upper 3x3 only.
+        void TransformPoints(const Vector3* src, Vector3* dest, size_t count) const;
+        void TransformDirections(const Vector3* src, Vector3* dest, size_t count) const;
+        // Same on separate x, y and z streams
+        void TransformPoints(const float* x, const float* y, const float* z,
+                             float* destX, float* destY, float* destZ, size_t count) const;
+        void TransformDirections(const float* x, const float* y, const float* z,
+                                 float* destX, float* destY, float* destZ, size_t count) const;
+
+        // Matrix * vector on an SSE register, summed column by column like the scalar code
+        FORCE_INLINE __m128 Transform(__m128 vec) const {
+            __m128 result = _mm_mul_ps(simd[0], _mm_shuffle_ps(vec, vec, _MM_SHUFFLE(0, 0, 0, 0)));
+            result = _mm_add_ps(result, _mm_mul_ps(simd[1], _mm_shuffle_ps(vec, vec, _MM_SHUFFLE(1, 1, 1, 1))));
+            result = _mm_add_ps(result, _mm_mul_ps(simd[2], _mm_shuffle_ps(vec, vec, _MM_SHUFFLE(2, 2, 2, 2))));
+            return _mm_add_ps(result, _mm_mul_ps(simd[3], _mm_shuffle_ps(vec, vec, _MM_SHUFFLE(3, 3, 3, 3))));
+        }
+
         // Transformation matrices
         static Matrix4x4 Translate(const Vector3& translation);
         static Matrix4x4 Rotate(const Quaternion& rotation);
+        // Rotation matrices of an array of quaternions, 4 at a time, same results as Rotate
+        static void Rotate(const Quaternion* rotations, Matrix4x4* dest, size_t count);
         static Matrix4x4 Scale(const Vector3& scale);
         static Matrix4x4 TRS(const Vector3& translation,
                             const Quaternion& rotation,
@@ -53,12 +83,20 @@ namespace DSEngine {
 
         // Matrix operations
         Matrix4x4 Transposed() const;
+        // General inverse, identity when the matrix is singular
         Matrix4x4 Inversed() const;
+        // Inverse of a translation * rotation * scale matrix (non-uniform scale allowed, no shear or projection),
+        // about twice as fast as Inversed. Axes with a zero scale stay zero.
+        Matrix4x4 InversedAffine() const;
         float Determinant() const;
 
         // Utility
         void SetIdentity();
         bool IsIdentity() const;
+        // Last row is (0, 0, 0, 1): no projection, w stays 1
+        bool IsAffine() const;
+        // Splits a TRS matrix, the inverse of TRS. A mirrored basis gives a negative x scale.
+        // false for projections and zero scales, shear ends up in the rotation.
         bool Decompose(Vector3& translation,
                       Quaternion& rotation,
                       Vector3& scale) const;
@@ -0,0 +1,303 @@
+#include "Quaternion.h"
+#include "DSCpu.h"
+
+namespace DSEngine {
+    namespace {
+        const bool s_hasAVX = DSCpu::HasAVX();
+
+        // Slerp weights from D. Eberly, "A Fast and Accurate Algorithm for Computing SLERP":
+        // sin(t * angle) / sin(angle) = t * (1 + b1 * (1 + b2 * (... (1 + bn)))) with bi = (u[i] * t^2 - v[i]) * (cos(angle) - 1),
+        // u[i] = 1 / (i * (2i + 1)) and v[i] = i / (2i + 1). The series is cut after 12 terms, the last one scaled by
+        // SLERP_MU to balance the truncation error: below 7.2e-7 over the whole range, before float rounding.
+        const float SLERP_MU = 1.89371585f;
+        const int SLERP_TERMS = 12;
+        const float SLERP_U[SLERP_TERMS] = {
+            1.0f / (1 * 3), 1.0f / (2 * 5), 1.0f / (3 * 7), 1.0f / (4 * 9), 1.0f / (5 * 11), 1.0f / (6 * 13),
+            1.0f / (7 * 15), 1.0f / (8 * 17), 1.0f / (9 * 19), 1.0f / (10 * 21), 1.0f / (11 * 23), SLERP_MU / (12 * 25)
+        };
+        const float SLERP_V[SLERP_TERMS] = {
+            1.0f / 3, 2.0f / 5, 3.0f / 7, 4.0f / 9, 5.0f / 11, 6.0f / 13,
+            7.0f / 15, 8.0f / 17, 9.0f / 19, 10.0f / 21, 11.0f / 23, SLERP_MU * 12 / 25
+        };
+
+        // Per call constants of the weights of a and b
+        struct SlerpCoefficients {
+            float t;
+            float d;   // 1 - t
+            float coefficientsT[SLERP_TERMS];
+            float coefficientsD[SLERP_TERMS];
+
+            explicit SlerpCoefficients(float factor) : t(factor), d(1.0f - factor) {
+                for (int i = 0; i < SLERP_TERMS; i++) {
+                    coefficientsT[i] = SLERP_U[i] * (t * t) - SLERP_V[i];
+                    coefficientsD[i] = SLERP_U[i] * (d * d) - SLERP_V[i];
+                }
+            }
+        };
+
+        // The single versions run the tails of the batches, every lane uses this operation order
+        FORCE_INLINE float Dot4(const Quaternion& a, const Quaternion& b) {
+            return ((a.x * b.x + a.y * b.y) + a.z * b.z) + a.w * b.w;
+        }
+
+        FORCE_INLINE Quaternion Blend(const Quaternion& a, const Quaternion& b, float weightA, float weightB) {
+            return Quaternion(a.x * weightA + b.x * weightB, a.y * weightA + b.y * weightB,
+                              a.z * weightA + b.z * weightB, a.w * weightA + b.w * weightB);
+        }
+
+        FORCE_INLINE Quaternion NlerpScalar(const Quaternion& a, const Quaternion& b, float t) {
+            const float weightB = Dot4(a, b) < 0.0f ? -t : t;
+            const Quaternion result = Blend(a, b, 1.0f - t, weightB);
+            const float lengthSquared = Dot4(result, result);
+            if (!(lengthSquared > 0.0f)) return Quaternion();
+            const float length = std::sqrt(lengthSquared);
+            return Quaternion(result.x / length, result.y / length, result.z / length, result.w / length);
+        }
+
+        FORCE_INLINE Quaternion SlerpScalar(const Quaternion& a, const Quaternion& b, const SlerpCoefficients& coefficients) {
+            const float cosine = Dot4(a, b);
+            const bool flip = cosine < 0.0f;
+            const float cosineMinusOne = (flip ? -cosine : cosine) - 1.0f;
+
+            float sumT = 1.0f, sumD = 1.0f;
+            for (int i = SLERP_TERMS - 1; i >= 0; i--) {
+                sumT = 1.0f + coefficients.coefficientsT[i] * cosineMinusOne * sumT;
+                sumD = 1.0f + coefficients.coefficientsD[i] * cosineMinusOne * sumD;
+            }
+            const float weightB = coefficients.t * sumT;
+            return Blend(a, b, coefficients.d * sumD, flip ? -weightB : weightB);
+        }
+
+        // =====================
+        // SSE, 4 quaternions transposed to x, y, z and w registers
+        // =====================
+
+        struct Quaternions4 {
+            __m128 x, y, z, w;
+        };
+
+        FORCE_INLINE Quaternions4 Load4(const Quaternion* q) {
+            Quaternions4 result = { _mm_loadu_ps(q[0].data), _mm_loadu_ps(q[1].data),
+                                    _mm_loadu_ps(q[2].data), _mm_loadu_ps(q[3].data) };
+            _MM_TRANSPOSE4_PS(result.x, result.y, result.z, result.w);
+            return result;
+        }
+
+        FORCE_INLINE void Store4(Quaternions4 value, Quaternion* q) {
+            _MM_TRANSPOSE4_PS(value.x, value.y, value.z, value.w);
+            _mm_storeu_ps(q[0].data, value.x);
+            _mm_storeu_ps(q[1].data, value.y);
+            _mm_storeu_ps(q[2].data, value.z);
+            _mm_storeu_ps(q[3].data, value.w);
+        }
+
+        FORCE_INLINE __m128 Dot4(const Quaternions4& a, const Quaternions4& b) {
+            __m128 result = _mm_add_ps(_mm_mul_ps(a.x, b.x), _mm_mul_ps(a.y, b.y));
+            result = _mm_add_ps(result, _mm_mul_ps(a.z, b.z));
+            return _mm_add_ps(result, _mm_mul_ps(a.w, b.w));
+        }
+
+        FORCE_INLINE Quaternions4 Blend(const Quaternions4& a, const Quaternions4& b, __m128 weightA, __m128 weightB) {
+            return {
+                _mm_add_ps(_mm_mul_ps(a.x, weightA), _mm_mul_ps(b.x, weightB)),
+                _mm_add_ps(_mm_mul_ps(a.y, weightA), _mm_mul_ps(b.y, weightB)),
+                _mm_add_ps(_mm_mul_ps(a.z, weightA), _mm_mul_ps(b.z, weightB)),
+                _mm_add_ps(_mm_mul_ps(a.w, weightA), _mm_mul_ps(b.w, weightB))
+            };
+        }
+
+        // The sign of the dot product, to flip b onto the shortest arc
+        FORCE_INLINE __m128 FlipSign(__m128 dot) {
+            return _mm_and_ps(_mm_cmplt_ps(dot, _mm_setzero_ps()), _mm_set1_ps(-0.0f));
+        }
+
+        size_t NlerpSSE(const Quaternion* a, const Quaternion* b, float t, Quaternion* dest, size_t count) {
+            const __m128 weightA = _mm_set1_ps(1.0f - t);
+            const __m128 factor = _mm_set1_ps(t);
+            const __m128 zero = _mm_setzero_ps();
+            const __m128 one = _mm_set1_ps(1.0f);
+
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4) {
+                const Quaternions4 qa = Load4(a + i), qb = Load4(b + i);
+                const __m128 weightB = _mm_xor_ps(factor, FlipSign(Dot4(qa, qb)));
+                Quaternions4 result = Blend(qa, qb, weightA, weightB);
+
+                // Zero lengths give the identity like Normalized
+                const __m128 lengthSquared = Dot4(result, result);
+                const __m128 valid = _mm_cmpgt_ps(lengthSquared, zero);
+                const __m128 length = _mm_sqrt_ps(lengthSquared);
+                result.x = _mm_and_ps(valid, _mm_div_ps(result.x, length));
+                result.y = _mm_and_ps(valid, _mm_div_ps(result.y, length));
+                result.z = _mm_and_ps(valid, _mm_div_ps(result.z, length));
+                result.w = _mm_or_ps(_mm_and_ps(valid, _mm_div_ps(result.w, length)), _mm_andnot_ps(valid, one));
+                Store4(result, dest + i);
+            }
+            return i;
+        }
+
+        size_t SlerpSSE(const Quaternion* a, const Quaternion* b, const SlerpCoefficients& coefficients,
+                        Quaternion* dest, size_t count) {
+            __m128 coefficientsT[SLERP_TERMS], coefficientsD[SLERP_TERMS];
+            for (int i = 0; i < SLERP_TERMS; i++) {
+                coefficientsT[i] = _mm_set1_ps(coefficients.coefficientsT[i]);
+                coefficientsD[i] = _mm_set1_ps(coefficients.coefficientsD[i]);
+            }
+            const __m128 t = _mm_set1_ps(coefficients.t);
+            const __m128 d = _mm_set1_ps(coefficients.d);
+            const __m128 one = _mm_set1_ps(1.0f);
+
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4) {
+                const Quaternions4 qa = Load4(a + i), qb = Load4(b + i);
+                const __m128 cosine = Dot4(qa, qb);
+                const __m128 flip = FlipSign(cosine);
+                const __m128 cosineMinusOne = _mm_sub_ps(_mm_xor_ps(cosine, flip), one);
+
+                __m128 sumT = one, sumD = one;
+                for (int term = SLERP_TERMS - 1; term >= 0; term--) {
+                    sumT = _mm_add_ps(one, _mm_mul_ps(_mm_mul_ps(coefficientsT[term], cosineMinusOne), sumT));
+                    sumD = _mm_add_ps(one, _mm_mul_ps(_mm_mul_ps(coefficientsD[term], cosineMinusOne), sumD));
+                }
+                const __m128 weightB = _mm_xor_ps(_mm_mul_ps(t, sumT), flip);
+                Store4(Blend(qa, qb, _mm_mul_ps(d, sumD), weightB), dest + i);
+            }
+            return i;
+        }
+
+        // =====================
+        // AVX, quaternions i..i+3 in the low lanes and i+4..i+7 in the high lanes
+        // =====================
+
+        struct Quaternions8 {
+            __m256 x, y, z, w;
+        };
+
+        // In-lane 4x4 transpose, its own inverse
+        DS_TARGET("avx") FORCE_INLINE void Transpose8(__m256& r0, __m256& r1, __m256& r2, __m256& r3) {
+            const __m256 t0 = _mm256_unpacklo_ps(r0, r1), t1 = _mm256_unpacklo_ps(r2, r3);
+            const __m256 t2 = _mm256_unpackhi_ps(r0, r1), t3 = _mm256_unpackhi_ps(r2, r3);
+            r0 = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(1, 0, 1, 0));
+            r1 = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(3, 2, 3, 2));
+            r2 = _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(1, 0, 1, 0));
+            r3 = _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(3, 2, 3, 2));
+        }
+
+        DS_TARGET("avx") FORCE_INLINE Quaternions8 Load8(const Quaternion* q) {
+            Quaternions8 result;
+            result.x = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(q[0].data)), _mm_loadu_ps(q[4].data), 1);
+            result.y = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(q[1].data)), _mm_loadu_ps(q[5].data), 1);
+            result.z = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(q[2].data)), _mm_loadu_ps(q[6].data), 1);
+            result.w = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(q[3].data)), _mm_loadu_ps(q[7].data), 1);
+            Transpose8(result.x, result.y, result.z, result.w);
+            return result;
+        }
+
+        DS_TARGET("avx") FORCE_INLINE void Store8(Quaternions8 value, Quaternion* q) {
+            Transpose8(value.x, value.y, value.z, value.w);
+            const __m256 rows[4] = { value.x, value.y, value.z, value.w };
+            for (int row = 0; row < 4; row++) {
+                _mm_storeu_ps(q[row].data, _mm256_castps256_ps128(rows[row]));
+                _mm_storeu_ps(q[row + 4].data, _mm256_extractf128_ps(rows[row], 1));
+            }
+        }
+
+        DS_TARGET("avx") FORCE_INLINE __m256 Dot8(const Quaternions8& a, const Quaternions8& b) {
+            __m256 result = _mm256_add_ps(_mm256_mul_ps(a.x, b.x), _mm256_mul_ps(a.y, b.y));
+            result = _mm256_add_ps(result, _mm256_mul_ps(a.z, b.z));
+            return _mm256_add_ps(result, _mm256_mul_ps(a.w, b.w));
+        }
+
+        DS_TARGET("avx") FORCE_INLINE Quaternions8 Blend8(const Quaternions8& a, const Quaternions8& b, __m256 weightA, __m256 weightB) {
+            Quaternions8 result;
+            result.x = _mm256_add_ps(_mm256_mul_ps(a.x, weightA), _mm256_mul_ps(b.x, weightB));
+            result.y = _mm256_add_ps(_mm256_mul_ps(a.y, weightA), _mm256_mul_ps(b.y, weightB));
+            result.z = _mm256_add_ps(_mm256_mul_ps(a.z, weightA), _mm256_mul_ps(b.z, weightB));
+            result.w = _mm256_add_ps(_mm256_mul_ps(a.w, weightA), _mm256_mul_ps(b.w, weightB));
+            return result;
+        }
+
+        DS_TARGET("avx") FORCE_INLINE __m256 FlipSign8(__m256 dot) {
+            return _mm256_and_ps(_mm256_cmp_ps(dot, _mm256_setzero_ps(), _CMP_LT_OQ), _mm256_set1_ps(-0.0f));
+        }
+
+        // Whole groups of 8 only, the caller finishes with the SSE version
+        DS_TARGET("avx") size_t NlerpAVX(const Quaternion* a, const Quaternion* b, float t, Quaternion* dest, size_t count) {
+            const __m256 weightA = _mm256_set1_ps(1.0f - t);
+            const __m256 factor = _mm256_set1_ps(t);
+            const __m256 zero = _mm256_setzero_ps();
+            const __m256 one = _mm256_set1_ps(1.0f);
+
+            size_t i = 0;
+            for (; i + 8 <= count; i += 8) {
+                const Quaternions8 qa = Load8(a + i), qb = Load8(b + i);
+                const __m256 weightB = _mm256_xor_ps(factor, FlipSign8(Dot8(qa, qb)));
+                Quaternions8 result = Blend8(qa, qb, weightA, weightB);
+
+                const __m256 lengthSquared = Dot8(result, result);
+                const __m256 valid = _mm256_cmp_ps(lengthSquared, zero, _CMP_GT_OQ);
+                const __m256 length = _mm256_sqrt_ps(lengthSquared);
+                result.x = _mm256_and_ps(valid, _mm256_div_ps(result.x, length));
+                result.y = _mm256_and_ps(valid, _mm256_div_ps(result.y, length));
+                result.z = _mm256_and_ps(valid, _mm256_div_ps(result.z, length));
+                result.w = _mm256_blendv_ps(one, _mm256_div_ps(result.w, length), valid);
+                Store8(result, dest + i);
+            }
+            return i;
+        }
+
+        DS_TARGET("avx") size_t SlerpAVX(const Quaternion* a, const Quaternion* b, const SlerpCoefficients& coefficients,
+                                         Quaternion* dest, size_t count) {
+            __m256 coefficientsT[SLERP_TERMS], coefficientsD[SLERP_TERMS];
+            for (int i = 0; i < SLERP_TERMS; i++) {
+                coefficientsT[i] = _mm256_set1_ps(coefficients.coefficientsT[i]);
+                coefficientsD[i] = _mm256_set1_ps(coefficients.coefficientsD[i]);
+            }
+            const __m256 t = _mm256_set1_ps(coefficients.t);
+            const __m256 d = _mm256_set1_ps(coefficients.d);
+            const __m256 one = _mm256_set1_ps(1.0f);
+
+            size_t i = 0;
+            for (; i + 8 <= count; i += 8) {
+                const Quaternions8 qa = Load8(a + i), qb = Load8(b + i);
+                const __m256 cosine = Dot8(qa, qb);
+                const __m256 flip = FlipSign8(cosine);
+                const __m256 cosineMinusOne = _mm256_sub_ps(_mm256_xor_ps(cosine, flip), one);
+
+                __m256 sumT = one, sumD = one;
+                for (int term = SLERP_TERMS - 1; term >= 0; term--) {
+                    sumT = _mm256_add_ps(one, _mm256_mul_ps(_mm256_mul_ps(coefficientsT[term], cosineMinusOne), sumT));
+                    sumD = _mm256_add_ps(one, _mm256_mul_ps(_mm256_mul_ps(coefficientsD[term], cosineMinusOne), sumD));
+                }
+                const __m256 weightB = _mm256_xor_ps(_mm256_mul_ps(t, sumT), flip);
+                Store8(Blend8(qa, qb, _mm256_mul_ps(d, sumD), weightB), dest + i);
+            }
+            return i;
+        }
+    }
+
+    Quaternion Quaternion::Nlerp(const Quaternion& a, const Quaternion& b, float t) {
+        return NlerpScalar(a, b, t);
+    }
+
+    Quaternion Quaternion::Slerp(const Quaternion& a, const Quaternion& b, float t) {
+        return SlerpScalar(a, b, SlerpCoefficients(t));
+    }
+
+    void Quaternion::Nlerp(const Quaternion* a, const Quaternion* b, float t, Quaternion* dest, size_t count) {
+        size_t done = s_hasAVX ? NlerpAVX(a, b, t, dest, count) : 0;
+        done += NlerpSSE(a + done, b + done, t, dest + done, count - done);
+        for (; done < count; done++) {
+            dest[done] = NlerpScalar(a[done], b[done], t);
+        }
+    }
+
+    void Quaternion::Slerp(const Quaternion* a, const Quaternion* b, float t, Quaternion* dest, size_t count) {
+        const SlerpCoefficients coefficients(t);
+        size_t done = s_hasAVX ? SlerpAVX(a, b, coefficients, dest, count) : 0;
+        done += SlerpSSE(a + done, b + done, coefficients, dest + done, count - done);
+        for (; done < count; done++) {
+            dest[done] = SlerpScalar(a[done], b[done], coefficients);
+        }
+    }
+}
@@ -1,9 +1,13 @@
 #pragma once
 #include "vector3.h"
 #include "DSMath.h"
+#include <cmath>
+#include <cstddef>
 
 
 namespace DSEngine {
+    // Products, rotations and normalization use SSE. The batched interpolations in Quaternion.cpp work on
+    // 8 quaternions at a time with AVX, 4 with SSE, and give the same results as the single ones.
     struct ALIGNED_(16) Quaternion {
         union {
             struct { float x, y, z, w; };
@@ -14,50 +18,96 @@ namespace DSEngine {
         // Constructors
         FORCE_INLINE Quaternion() : x(0), y(0), z(0), w(1) {}
         FORCE_INLINE Quaternion(float _x, float _y, float _z, float _w) : x(_x), y(_y), z(_z), w(_w) {}
+        explicit FORCE_INLINE Quaternion(__m128 xyzw) : simd(xyzw) {}
 
         // Operations
+        // Hamilton product: w * q + x * (qw, -qz, qy, -qx) + y * (qz, qw, -qx, -qy) + z * (-qy, qx, qw, -qz)
         FORCE_INLINE Quaternion operator*(const Quaternion& q) const {
-            return Quaternion(
-                w*q.x + x*q.w + y*q.z - z*q.y,
-                w*q.y - x*q.z + y*q.w + z*q.x,
-                w*q.z + x*q.y - y*q.x + z*q.w,
-                w*q.w - x*q.x - y*q.y - z*q.z
-            );
+            const __m128 a = simd, b = q.simd;
+            __m128 result = _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 3, 3, 3)), b);
+            result = _mm_add_ps(result, _mm_xor_ps(_mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(0, 0, 0, 0)),
+                                                              _mm_shuffle_ps(b, b, _MM_SHUFFLE(0, 1, 2, 3))),
+                                                   _mm_setr_ps(0.0f, -0.0f, 0.0f, -0.0f)));
+            result = _mm_add_ps(result, _mm_xor_ps(_mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(1, 1, 1, 1)),
+                                                              _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 0, 3, 2))),
+                                                   _mm_setr_ps(0.0f, 0.0f, -0.0f, -0.0f)));
+            result = _mm_add_ps(result, _mm_xor_ps(_mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 2, 2, 2)),
+                                                              _mm_shuffle_ps(b, b, _MM_SHUFFLE(2, 3, 0, 1))),
+                                                   _mm_setr_ps(-0.0f, 0.0f, 0.0f, -0.0f)));
+            return Quaternion(result);
         }
 
+        // Rotates v as v + w * t + u x t with t = 2 * (u x v), u the vector part
         FORCE_INLINE Vector3 operator*(const Vector3& v) const {
-            Vector3 u(x, y, z);
-            float s = w;
-            return u * 2.0f * Vector3::Dot(u, v)
-                + v * (s*s - Vector3::Dot(u, u))
-                + Vector3::Cross(u, v) * 2.0f * s;
+            const __m128 vec = _mm_setr_ps(v.x, v.y, v.z, 0.0f);
+            __m128 t = Cross3(simd, vec);
+            t = _mm_add_ps(t, t);
+            __m128 result = _mm_add_ps(vec, _mm_mul_ps(_mm_shuffle_ps(simd, simd, _MM_SHUFFLE(3, 3, 3, 3)), t));
+            result = _mm_add_ps(result, Cross3(simd, t));
+
+            alignas(16) float xyzw[4];
+            _mm_store_ps(xyzw, result);
+            return Vector3(xyzw[0], xyzw[1], xyzw[2]);
         }
 
-        // Normalization
+        // Normalization, identity for a zero quaternion (or one too small to invert its length)
         FORCE_INLINE Quaternion Normalized() const {
-            float len = Mathf::Sqrt(x*x + y*y + z*z + w*w);
-            return len > 0 ? Quaternion(x/len, y/len, z/len, w/len) : Quaternion();
+            __m128 lengthSquared = _mm_mul_ps(simd, simd);
+            lengthSquared = _mm_add_ps(lengthSquared, _mm_shuffle_ps(lengthSquared, lengthSquared, _MM_SHUFFLE(2, 3, 0, 1)));
+            lengthSquared = _mm_add_ps(lengthSquared, _mm_shuffle_ps(lengthSquared, lengthSquared, _MM_SHUFFLE(1, 0, 3, 2)));
+            if (!(_mm_cvtss_f32(lengthSquared) >= MATH_FLOAT_MIN)) return Quaternion();
+            return Quaternion(_mm_mul_ps(simd, Mathf::InvSqrt(lengthSquared)));
         }
 
-        // Conversion from Euler angles
+        // Conversion from Euler angles, the 3 sines and cosines in one Mathf::SinCos. Angles outside its range
+        // (NaN lanes) go through libm instead
         static FORCE_INLINE Quaternion FromEuler(float pitch, float yaw, float roll) {
-            float cy = cos(yaw * 0.5f);
-            float sy = sin(yaw * 0.5f);
-            float cp = cos(pitch * 0.5f);
-            float sp = sin(pitch * 0.5f);
-            float cr = cos(roll * 0.5f);
-            float sr = sin(roll * 0.5f);
-
-            return Quaternion(
-                cy * sp * cr + sy * cp * sr,
-                sy * cp * cr - cy * sp * sr,
-                cy * cp * sr - sy * sp * cr,
-                cy * cp * cr + sy * sp * sr
-            );
+            const __m128 halfAngles = _mm_mul_ps(_mm_setr_ps(yaw, pitch, roll, 0.0f), _mm_set1_ps(0.5f));
+            __m128 s, c;
+            Mathf::SinCos(halfAngles, s, c);
+            if (_mm_movemask_ps(_mm_cmpunord_ps(s, s)) != 0) {
+                ALIGNED_(16) float angles[4];
+                _mm_store_ps(angles, halfAngles);
+                s = _mm_setr_ps(sinf(angles[0]), sinf(angles[1]), sinf(angles[2]), 0.0f);
+                c = _mm_setr_ps(cosf(angles[0]), cosf(angles[1]), cosf(angles[2]), 1.0f);
+            }
+            return FromHalfAngles(c, s);
         }
 
+        // Interpolation along the shortest arc, t in [0, 1]
+        // Normalized linear interpolation, cheaper than Slerp but not at a constant angular speed
+        static Quaternion Nlerp(const Quaternion& a, const Quaternion& b, float t);
+        // Spherical interpolation, polynomial approximation (no trigonometry), error below 2e-6 for unit inputs
+        static Quaternion Slerp(const Quaternion& a, const Quaternion& b, float t);
+        // Same on arrays, dest may be a or b
+        static void Nlerp(const Quaternion* a, const Quaternion* b, float t, Quaternion* dest, size_t count);
+        static void Slerp(const Quaternion* a, const Quaternion* b, float t, Quaternion* dest, size_t count);
+
         // Constants
         static const Quaternion identity;
+
+    private:
+        // Cross product of the xyz parts, w is 0 when one of the w is 0
+        static FORCE_INLINE __m128 Cross3(__m128 a, __m128 b) {
+            const __m128 aYZX = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 0, 2, 1));
+            const __m128 bYZX = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 2, 1));
+            const __m128 result = _mm_sub_ps(_mm_mul_ps(a, bYZX), _mm_mul_ps(aYZX, b));
+            return _mm_shuffle_ps(result, result, _MM_SHUFFLE(3, 0, 2, 1));
+        }
+
+        // c and s hold the cosines and sines of half the yaw, pitch and roll
+        static FORCE_INLINE Quaternion FromHalfAngles(__m128 c, __m128 s) {
+            const __m128 yawPitch = _mm_unpacklo_ps(c, s);                                     // cy sy cp sp
+            const __m128 roll = _mm_unpacklo_ps(_mm_movehl_ps(c, c), _mm_movehl_ps(s, s));    // cr sr
+            // (cy sp cr, sy cp cr, cy cp sr, cy cp cr) +- (sy cp sr, cy sp sr, sy sp cr, sy sp sr)
+            const __m128 first = _mm_mul_ps(_mm_mul_ps(_mm_shuffle_ps(yawPitch, yawPitch, _MM_SHUFFLE(0, 0, 1, 0)),
+                                                       _mm_shuffle_ps(yawPitch, yawPitch, _MM_SHUFFLE(2, 2, 2, 3))),
+                                            _mm_shuffle_ps(roll, roll, _MM_SHUFFLE(0, 1, 0, 0)));
+            const __m128 second = _mm_mul_ps(_mm_mul_ps(_mm_shuffle_ps(yawPitch, yawPitch, _MM_SHUFFLE(1, 1, 0, 1)),
+                                                        _mm_shuffle_ps(yawPitch, yawPitch, _MM_SHUFFLE(3, 3, 3, 2))),
+                                             _mm_shuffle_ps(roll, roll, _MM_SHUFFLE(1, 0, 1, 1)));
+            return Quaternion(_mm_add_ps(first, _mm_xor_ps(second, _mm_setr_ps(0.0f, -0.0f, -0.0f, 0.0f))));
+        }
     };
 
     inline const Quaternion Quaternion::identity(0, 0, 0, 1);
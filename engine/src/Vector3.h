@@ -1,6 +1,7 @@
 #pragma once
 #include <cmath> // For math functions
 #include <iostream> // For output
+#include "DSMath.h"
 namespace DSEngine {
     struct Vector3 {
         // Data members
@@ -61,20 +62,22 @@ namespace DSEngine {
             return x*x + y*y + z*z;
         }
 
+        // Zero vector for lengths too small to invert (below about 1e-19)
         Vector3 Normalized() const {
-            float len = Length();
-            if (len > 0) {
-                return *this / len;
+            float lengthSquared = LengthSquared();
+            if (lengthSquared >= MATH_FLOAT_MIN) {
+                return *this * Mathf::InvSqrt(lengthSquared);
             }
             return Vector3();
         }
 
         void Normalize() {
-            float len = Length();
-            if (len > 0) {
-                x /= len;
-                y /= len;
-                z /= len;
+            float lengthSquared = LengthSquared();
+            if (lengthSquared >= MATH_FLOAT_MIN) {
+                float invLength = Mathf::InvSqrt(lengthSquared);
+                x *= invLength;
+                y *= invLength;
+                z *= invLength;
             }
         }
 
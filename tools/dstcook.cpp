@@ -0,0 +1,383 @@
+#include "../engine/src/DSTexture.h"
+#include "../engine/src/DSThreadPool.h"
+#include "../engine/src/DSDXTEncoder.h"
+#include "../engine/src/DSVirtualTexture.h"
+#include <atomic>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using DSEngine::DSTexture;
+using DSEngine::DSMipGenerator;
+using DSEngine::DSThreadPool;
+using DSEngine::DSDXTEncoder;
+using DSEngine::DSVirtualTexture;
+
+namespace fs = std::filesystem;
+
+namespace {
+    // Bump when the cooked output changes for identical inputs and settings, forces a full re-cook
+    const uint32_t COOKER_VERSION = 1;
+    const char* CACHE_FILE_NAME = ".dstcook_cache";
+
+    enum class TargetFormat {
+        Auto,   // DXT1 for RGB sources, DXT5 for RGBA sources, R11G11B10F for HDR sources
+        DXT1,
+        DXT5,
+        Raw,    // Keep the source RGB8/RGBA8/RGBA16F pixels
+        BC4,    // Red channel only (roughness, AO, height)
+        BC5,    // Red and green (normal map XY)
+        RGBA16F,
+        R11G11B10F
+    };
+
+    struct CookSettings {
+        TargetFormat format = TargetFormat::Auto;
+        DSTexture::CompressionQuality quality = DSTexture::CompressionQuality::NORMAL;
+        DSTexture::FileCompression fileCompression = DSTexture::FileCompression::NONE;
+        DSMipGenerator::Settings mips;
+        bool generateMips = true;
+        bool uploadLayout = false;  // Save raw mips in the GPU upload layout (DST version 4)
+        DSTexture::UploadAlignment uploadAlignment;
+        bool virtualTiles = false;  // Write a DSVT tile file for virtual texturing instead of a DST
+        DSVirtualTexture::CookSettings tiles;
+    };
+
+    struct CacheEntry {
+        uint64_t contentHash;
+        uint64_t settingsHash;
+    };
+
+    enum class CookResult {
+        UpToDate,
+        Cooked,
+        Failed
+    };
+
+    struct Job {
+        fs::path input;
+        fs::path output;
+        std::string key;  // Input path relative to the source directory
+        CacheEntry hashes = {};
+        CookResult result = CookResult::Failed;
+    };
+
+    // 64-bit multiply/xor-shift hash, 8 bytes per step
+    uint64_t HashBytes(const uint8_t* data, size_t size, uint64_t seed = 0x9E3779B97F4A7C15ull) {
+        const uint64_t prime = 0xC2B2AE3D27D4EB4Full;
+        uint64_t hash = seed ^ (size * prime);
+
+        size_t i = 0;
+        for (; i + 8 <= size; i += 8) {
+            uint64_t word;
+            std::memcpy(&word, data + i, sizeof(word));
+            hash = (hash ^ word) * prime;
+            hash ^= hash >> 29;
+        }
+        for (; i < size; i++) {
+            hash = (hash ^ data[i]) * prime;
+            hash ^= hash >> 29;
+        }
+
+        hash ^= hash >> 32;
+        hash *= prime;
+        hash ^= hash >> 29;
+        return hash;
+    }
+
+    uint64_t HashSettings(const CookSettings& settings) {
+        const uint32_t values[] = {
+            COOKER_VERSION,
+            static_cast<uint32_t>(settings.format),
+            static_cast<uint32_t>(settings.quality),
+            static_cast<uint32_t>(settings.fileCompression),
+            static_cast<uint32_t>(settings.generateMips),
+            static_cast<uint32_t>(settings.mips.filter),
+            static_cast<uint32_t>(settings.mips.sRGB),
+            static_cast<uint32_t>(settings.mips.premultiplyAlpha),
+            static_cast<uint32_t>(settings.uploadLayout),
+            settings.uploadAlignment.offset,
+            settings.uploadAlignment.rowPitch,
+            static_cast<uint32_t>(settings.virtualTiles),
+            settings.tiles.tileSize,
+            settings.tiles.border
+        };
+        return HashBytes(reinterpret_cast<const uint8_t*>(values), sizeof(values));
+    }
+
+    bool HashFile(const fs::path& path, uint64_t& hash) {
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file.is_open()) return false;
+
+        std::vector<uint8_t> data(static_cast<size_t>(file.tellg()));
+        file.seekg(0);
+        if (!file.read(reinterpret_cast<char*>(data.data()), data.size())) return false;
+
+        hash = HashBytes(data.data(), data.size());
+        return true;
+    }
+
+    bool IsSourceImage(const fs::path& path) {
+        std::string extension = path.extension().string();
+        for (char& c : extension) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        return extension == ".png" || extension == ".tga" || extension == ".jpg" || extension == ".jpeg" ||
+               extension == ".hdr";
+    }
+
+    // Cache file: one "<content hash> <settings hash> <relative path>" line per cooked input
+    std::unordered_map<std::string, CacheEntry> LoadCache(const fs::path& path) {
+        std::unordered_map<std::string, CacheEntry> cache;
+        std::ifstream file(path);
+        std::string line;
+
+        while (std::getline(file, line)) {
+            unsigned long long contentHash, settingsHash;
+            int keyStart = 0;
+            if (std::sscanf(line.c_str(), "%llx %llx %n", &contentHash, &settingsHash, &keyStart) == 2 && keyStart > 0) {
+                cache[line.substr(keyStart)] = { contentHash, settingsHash };
+            }
+        }
+        return cache;
+    }
+
+    bool SaveCache(const fs::path& path, const std::vector<Job>& jobs) {
+        std::ofstream file(path, std::ios::trunc);
+        if (!file.is_open()) return false;
+
+        // Inputs that failed or disappeared are dropped
+        char hashes[40];
+        for (const Job& job : jobs) {
+            if (job.result == CookResult::Failed) continue;
+            std::snprintf(hashes, sizeof(hashes), "%016llx %016llx ",
+                          static_cast<unsigned long long>(job.hashes.contentHash),
+                          static_cast<unsigned long long>(job.hashes.settingsHash));
+            file << hashes << job.key << '\n';
+        }
+        return file.good();
+    }
+
+    bool CookTexture(const Job& job, const CookSettings& settings, uint32_t threads) {
+        DSTexture texture;
+        if (!texture.LoadFromFile(job.input.string())) return false;
+
+        DSTexture::Format format = texture.GetFormat();
+        switch (settings.format) {
+            case TargetFormat::Auto:
+                if (DSTexture::IsFormatFloat(format)) {
+                    // Radiance images have no alpha, the packed format takes half the memory
+                    format = DSTexture::Format::R11G11B10F;
+                } else {
+                    format = (format == DSTexture::Format::RGBA8) ? DSTexture::Format::DXT5 : DSTexture::Format::DXT1;
+                }
+                break;
+            case TargetFormat::DXT1: format = DSTexture::Format::DXT1; break;
+            case TargetFormat::DXT5: format = DSTexture::Format::DXT5; break;
+            case TargetFormat::BC4: format = DSTexture::Format::BC4; break;
+            case TargetFormat::BC5: format = DSTexture::Format::BC5; break;
+            case TargetFormat::RGBA16F: format = DSTexture::Format::RGBA16F; break;
+            case TargetFormat::R11G11B10F: format = DSTexture::Format::R11G11B10F; break;
+            case TargetFormat::Raw: break;
+        }
+
+        // Mips are filtered before compression, both steps share the engine thread pool with the other jobs
+        DSMipGenerator::Settings mipSettings = settings.mips;
+        mipSettings.maxThreads = threads;
+        if (settings.generateMips && !texture.GenerateMipmaps(mipSettings)) return false;
+        if (format != texture.GetFormat()) {
+            const bool converted = DSTexture::IsFormatCompressed(format) ? texture.Compress(format, settings.quality, threads)
+                                                                         : texture.ConvertFormat(format);
+            if (!converted) return false;
+        }
+
+        std::error_code error;
+        fs::create_directories(job.output.parent_path(), error);
+        if (settings.virtualTiles) {
+            DSVirtualTexture::CookSettings tiles = settings.tiles;
+            tiles.quality = settings.quality;
+            return DSVirtualTexture::Cook(texture, job.output.string(), tiles);
+        }
+        if (settings.uploadLayout) {
+            return texture.SaveToFile(job.output.string(), settings.uploadAlignment);
+        }
+        return texture.SaveToFile(job.output.string(), settings.fileCompression);
+    }
+
+    void PrintUsage() {
+        std::printf("Usage: dstcook <source dir> <output dir> [options]\n"
+                    "  --format auto|dxt1|dxt5|bc4|bc5|rgba16f|r11g11b10f|raw\n"
+                    "                                 Target format (default auto: DXT5 with alpha, DXT1 without,\n"
+                    "                                 R11G11B10F for .hdr), BC4 keeps the red channel, BC5 red and green\n"
+                    "  --quality fast|normal          DXT compression quality (default normal)\n"
+                    "  --filter box|kaiser            Mip filter (default box)\n"
+                    "  --srgb                         Filter color in linear space\n"
+                    "  --premultiply                  Weight color by alpha when filtering\n"
+                    "  --no-mips                      Only cook the base level\n"
+                    "  --lz                           LZ compress mip payloads (DST version 3)\n"
+                    "  --upload-align OFFSET[,PITCH]  Store mips ready for GPU upload with offsets and row pitches\n"
+                    "                                 aligned to these byte counts (DST version 4, no --lz)\n"
+                    "  --virtual TILE[,BORDER]        Write .dsvt tile files for virtual texturing, TILE texels per tile\n"
+                    "                                 plus BORDER on each side (default 4)\n"
+                    "  --threads N                    Worker thread count (default all cores)\n"
+                    "  --force                        Ignore the cache and cook everything\n");
+    }
+
+    bool ParseArguments(int argc, char** argv, CookSettings& settings, uint32_t& threads, bool& force) {
+        for (int i = 3; i < argc; i++) {
+            const std::string arg = argv[i];
+            const char* value = (i + 1 < argc) ? argv[i + 1] : "";
+
+            if (arg == "--format") {
+                const std::string name = value;
+                if (name == "auto") settings.format = TargetFormat::Auto;
+                else if (name == "dxt1") settings.format = TargetFormat::DXT1;
+                else if (name == "dxt5") settings.format = TargetFormat::DXT5;
+                else if (name == "bc4") settings.format = TargetFormat::BC4;
+                else if (name == "bc5") settings.format = TargetFormat::BC5;
+                else if (name == "rgba16f") settings.format = TargetFormat::RGBA16F;
+                else if (name == "r11g11b10f") settings.format = TargetFormat::R11G11B10F;
+                else if (name == "raw") settings.format = TargetFormat::Raw;
+                else return false;
+                i++;
+            } else if (arg == "--quality") {
+                const std::string name = value;
+                if (name == "fast") settings.quality = DSTexture::CompressionQuality::FAST;
+                else if (name == "normal") settings.quality = DSTexture::CompressionQuality::NORMAL;
+                else return false;
+                i++;
+            } else if (arg == "--filter") {
+                const std::string name = value;
+                if (name == "box") settings.mips.filter = DSMipGenerator::Filter::Box;
+                else if (name == "kaiser") settings.mips.filter = DSMipGenerator::Filter::Kaiser;
+                else return false;
+                i++;
+            } else if (arg == "--upload-align") {
+                char* end = nullptr;
+                settings.uploadAlignment.offset = static_cast<uint32_t>(std::strtoul(value, &end, 10));
+                settings.uploadAlignment.rowPitch = 1;
+                if (*end == ',') {
+                    settings.uploadAlignment.rowPitch = static_cast<uint32_t>(std::strtoul(end + 1, &end, 10));
+                }
+                if (*end != '\0' || settings.uploadAlignment.offset == 0 || settings.uploadAlignment.rowPitch == 0) return false;
+                settings.uploadLayout = true;
+                i++;
+            } else if (arg == "--virtual") {
+                char* end = nullptr;
+                settings.tiles.tileSize = static_cast<uint32_t>(std::strtoul(value, &end, 10));
+                if (*end == ',') {
+                    settings.tiles.border = static_cast<uint32_t>(std::strtoul(end + 1, &end, 10));
+                }
+                if (*end != '\0' || settings.tiles.tileSize == 0) return false;
+                settings.virtualTiles = true;
+                i++;
+            } else if (arg == "--threads") {
+                threads = static_cast<uint32_t>(std::strtoul(value, nullptr, 10));
+                if (threads == 0) return false;
+                i++;
+            } else if (arg == "--srgb") {
+                settings.mips.sRGB = true;
+            } else if (arg == "--premultiply") {
+                settings.mips.premultiplyAlpha = true;
+            } else if (arg == "--no-mips") {
+                settings.generateMips = false;
+            } else if (arg == "--lz") {
+                settings.fileCompression = DSTexture::FileCompression::LZ;
+            } else if (arg == "--force") {
+                force = true;
+            } else {
+                return false;
+            }
+        }
+
+        // Upload layout payloads are always raw, tile files have their own layout
+        return !(settings.uploadLayout && settings.fileCompression == DSTexture::FileCompression::LZ) &&
+               !(settings.virtualTiles && (settings.uploadLayout || settings.fileCompression == DSTexture::FileCompression::LZ));
+    }
+}
+
+int main(int argc, char** argv) {
+    CookSettings settings;
+    uint32_t threads = 0;
+    bool force = false;
+
+    if (argc < 3 || !ParseArguments(argc, argv, settings, threads, force)) {
+        PrintUsage();
+        return 1;
+    }
+
+    const fs::path sourceDir = argv[1];
+    const fs::path outputDir = argv[2];
+    std::error_code error;
+    if (!fs::is_directory(sourceDir, error)) {
+        std::fprintf(stderr, "dstcook: '%s' is not a directory\n", sourceDir.string().c_str());
+        return 1;
+    }
+    fs::create_directories(outputDir, error);
+
+    // Gather the inputs
+    std::vector<Job> jobs;
+    for (fs::recursive_directory_iterator it(sourceDir, error), end; it != end; it.increment(error)) {
+        if (!it->is_regular_file(error) || !IsSourceImage(it->path())) continue;
+
+        Job job;
+        job.input = it->path();
+        const fs::path relative = it->path().lexically_relative(sourceDir);
+        job.key = relative.generic_string();
+        job.output = (outputDir / relative).replace_extension(settings.virtualTiles ? ".dsvt" : ".dst");
+        jobs.push_back(std::move(job));
+    }
+
+    const fs::path cachePath = outputDir / CACHE_FILE_NAME;
+    const std::unordered_map<std::string, CacheEntry> cache = force ? std::unordered_map<std::string, CacheEntry>() : LoadCache(cachePath);
+    const uint64_t settingsHash = HashSettings(settings);
+
+    // Jobs run on the engine pool, mip generation and compression inside them nest on the same pool
+    std::mutex printMutex;
+    std::atomic<uint32_t> cooked(0), upToDate(0), failed(0);
+    DSThreadPool::Global().ParallelFor(static_cast<uint32_t>(jobs.size()), [&](uint32_t index) {
+        Job& job = jobs[index];
+        job.hashes.settingsHash = settingsHash;
+
+        if (!HashFile(job.input, job.hashes.contentHash)) {
+            job.result = CookResult::Failed;
+        } else {
+            auto cached = cache.find(job.key);
+            std::error_code existsError;
+            if (cached != cache.end() && cached->second.contentHash == job.hashes.contentHash &&
+                cached->second.settingsHash == settingsHash && fs::exists(job.output, existsError)) {
+                job.result = CookResult::UpToDate;
+            } else {
+                job.result = CookTexture(job, settings, threads) ? CookResult::Cooked : CookResult::Failed;
+            }
+        }
+
+        switch (job.result) {
+            case CookResult::UpToDate: upToDate++; return;
+            case CookResult::Cooked: cooked++; break;
+            case CookResult::Failed: failed++; break;
+        }
+
+        std::lock_guard<std::mutex> lock(printMutex);
+        std::printf("%s %s\n", job.result == CookResult::Cooked ? "cooked" : "FAILED", job.key.c_str());
+    }, threads);
+
+    if (!SaveCache(cachePath, jobs)) {
+        std::fprintf(stderr, "dstcook: could not write '%s'\n", cachePath.string().c_str());
+    }
+
+    std::printf("%u cooked, %u up to date, %u failed\n", cooked.load(), upToDate.load(), failed.load());
+
+    // How much of the block compression skipped the full encoder
+    const DSDXTEncoder::Stats encoderStats = DSDXTEncoder::GetStats();
+    if (encoderStats.blocks > 0) {
+        const double blocks = static_cast<double>(encoderStats.blocks);
+        std::printf("%llu compressed blocks: %.1f%% solid, %.1f%% repeated\n", static_cast<unsigned long long>(encoderStats.blocks),
+                    encoderStats.solidBlocks * 100.0 / blocks, encoderStats.cacheHits * 100.0 / blocks);
+    }
+    return failed.load() == 0 ? 0 : 1;
+}
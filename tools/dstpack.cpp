@@ -0,0 +1,66 @@
+#include "../engine/src/DSTexturePack.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+using DSEngine::DSTexturePack;
+using DSEngine::DSTexturePackWriter;
+
+namespace fs = std::filesystem;
+
+namespace {
+    bool IsDSTFile(const fs::path& path) {
+        std::string extension = path.extension().string();
+        std::transform(extension.begin(), extension.end(), extension.begin(),
+                       [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        return extension == ".dst";
+    }
+
+    void PrintUsage() {
+        std::printf("Usage: dstpack <cooked dir> <pack file>\n"
+                    "  Packs every .dst file under the directory, entries are named by their relative path\n"
+                    "  (e.g. 'ui/button.dst') and looked up with DSTexture::LoadFromPack.\n");
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc != 3) {
+        PrintUsage();
+        return 1;
+    }
+
+    const fs::path sourceDir = argv[1];
+    const fs::path packPath = argv[2];
+    std::error_code error;
+    if (!fs::is_directory(sourceDir, error)) {
+        std::fprintf(stderr, "dstpack: '%s' is not a directory\n", sourceDir.string().c_str());
+        return 1;
+    }
+
+    // Sorted so the same inputs always give the same pack
+    std::vector<std::pair<std::string, fs::path>> files;
+    for (fs::recursive_directory_iterator it(sourceDir, error), end; it != end; it.increment(error)) {
+        if (!it->is_regular_file(error) || !IsDSTFile(it->path())) continue;
+        files.emplace_back(it->path().lexically_relative(sourceDir).generic_string(), it->path());
+    }
+    std::sort(files.begin(), files.end());
+
+    DSTexturePackWriter writer;
+    for (const auto& file : files) {
+        if (!writer.AddFile(file.first, file.second.string())) {
+            std::fprintf(stderr, "dstpack: '%s' clashes with another entry\n", file.first.c_str());
+            return 1;
+        }
+    }
+
+    if (!writer.Write(packPath.string())) {
+        std::fprintf(stderr, "dstpack: could not write '%s'\n", packPath.string().c_str());
+        return 1;
+    }
+
+    std::printf("%u textures packed into %s\n", writer.GetEntryCount(), packPath.string().c_str());
+    return 0;
+}